@@ -0,0 +1,443 @@
+// animate_css.cpp
+#include "animate_css.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+namespace smart_lt::animate_css {
+
+namespace {
+
+constexpr std::string_view kPrefix = "animate__";
+
+// Timing curves animate.css reuses.
+#define SLT_EASE_OUT_CUBIC "animation-timing-function:cubic-bezier(0.215,0.61,0.355,1);"
+#define SLT_EASE_IN_CUBIC "animation-timing-function:cubic-bezier(0.755,0.05,0.855,0.06);"
+#define SLT_ZOOM_IN_CURVE "animation-timing-function:cubic-bezier(0.55,0.055,0.675,0.19);"
+#define SLT_ZOOM_OUT_CURVE "animation-timing-function:cubic-bezier(0.175,0.885,0.32,1);"
+#define SLT_DURATION(factor) "animation-duration:calc(var(--animate-duration)*" factor ");"
+
+// Sorted by name (find_animation() does a binary search).
+const animation kAnimations[] = {
+	{"backInDown",
+	 "0%{transform:translateY(-1200px) scale(0.7);opacity:0.7}"
+	 "80%{transform:translateY(0px) scale(0.7);opacity:0.7}"
+	 "100%{transform:scale(1);opacity:1}",
+	 ""},
+	{"backInLeft",
+	 "0%{transform:translateX(-2000px) scale(0.7);opacity:0.7}"
+	 "80%{transform:translateX(0px) scale(0.7);opacity:0.7}"
+	 "100%{transform:scale(1);opacity:1}",
+	 ""},
+	{"backInRight",
+	 "0%{transform:translateX(2000px) scale(0.7);opacity:0.7}"
+	 "80%{transform:translateX(0px) scale(0.7);opacity:0.7}"
+	 "100%{transform:scale(1);opacity:1}",
+	 ""},
+	{"backInUp",
+	 "0%{transform:translateY(1200px) scale(0.7);opacity:0.7}"
+	 "80%{transform:translateY(0px) scale(0.7);opacity:0.7}"
+	 "100%{transform:scale(1);opacity:1}",
+	 ""},
+	{"backOutDown",
+	 "0%{transform:scale(1);opacity:1}"
+	 "20%{transform:translateY(0px) scale(0.7);opacity:0.7}"
+	 "100%{transform:translateY(700px) scale(0.7);opacity:0.7}",
+	 ""},
+	{"backOutLeft",
+	 "0%{transform:scale(1);opacity:1}"
+	 "20%{transform:translateX(0px) scale(0.7);opacity:0.7}"
+	 "100%{transform:translateX(-2000px) scale(0.7);opacity:0.7}",
+	 ""},
+	{"backOutRight",
+	 "0%{transform:scale(1);opacity:1}"
+	 "20%{transform:translateX(0px) scale(0.7);opacity:0.7}"
+	 "100%{transform:translateX(2000px) scale(0.7);opacity:0.7}",
+	 ""},
+	{"backOutUp",
+	 "0%{transform:scale(1);opacity:1}"
+	 "20%{transform:translateY(0px) scale(0.7);opacity:0.7}"
+	 "100%{transform:translateY(-700px) scale(0.7);opacity:0.7}",
+	 ""},
+	{"bounce",
+	 "from,20%,53%,to{" SLT_EASE_OUT_CUBIC "transform:translate3d(0,0,0)}"
+	 "40%,43%{" SLT_EASE_IN_CUBIC "transform:translate3d(0,-30px,0) scaleY(1.1)}"
+	 "70%{" SLT_EASE_IN_CUBIC "transform:translate3d(0,-15px,0) scaleY(1.05)}"
+	 "80%{transition-timing-function:cubic-bezier(0.215,0.61,0.355,1);transform:translate3d(0,0,0) scaleY(0.95)}"
+	 "90%{transform:translate3d(0,-4px,0) scaleY(1.02)}",
+	 "transform-origin:center bottom;"},
+	{"bounceIn",
+	 "from,20%,40%,60%,80%,to{" SLT_EASE_OUT_CUBIC "}"
+	 "0%{opacity:0;transform:scale3d(0.3,0.3,0.3)}"
+	 "20%{transform:scale3d(1.1,1.1,1.1)}"
+	 "40%{transform:scale3d(0.9,0.9,0.9)}"
+	 "60%{opacity:1;transform:scale3d(1.03,1.03,1.03)}"
+	 "80%{transform:scale3d(0.97,0.97,0.97)}"
+	 "to{opacity:1;transform:scale3d(1,1,1)}",
+	 SLT_DURATION("0.75")},
+	{"bounceInDown",
+	 "from,60%,75%,90%,to{" SLT_EASE_OUT_CUBIC "}"
+	 "0%{opacity:0;transform:translate3d(0,-3000px,0) scaleY(3)}"
+	 "60%{opacity:1;transform:translate3d(0,25px,0) scaleY(0.9)}"
+	 "75%{transform:translate3d(0,-10px,0) scaleY(0.95)}"
+	 "90%{transform:translate3d(0,5px,0) scaleY(0.985)}"
+	 "to{transform:translate3d(0,0,0)}",
+	 ""},
+	{"bounceInLeft",
+	 "from,60%,75%,90%,to{" SLT_EASE_OUT_CUBIC "}"
+	 "0%{opacity:0;transform:translate3d(-3000px,0,0) scaleX(3)}"
+	 "60%{opacity:1;transform:translate3d(25px,0,0) scaleX(1)}"
+	 "75%{transform:translate3d(-10px,0,0) scaleX(0.98)}"
+	 "90%{transform:translate3d(5px,0,0) scaleX(0.995)}"
+	 "to{transform:translate3d(0,0,0)}",
+	 ""},
+	{"bounceInRight",
+	 "from,60%,75%,90%,to{" SLT_EASE_OUT_CUBIC "}"
+	 "from{opacity:0;transform:translate3d(3000px,0,0) scaleX(3)}"
+	 "60%{opacity:1;transform:translate3d(-25px,0,0) scaleX(1)}"
+	 "75%{transform:translate3d(10px,0,0) scaleX(0.98)}"
+	 "90%{transform:translate3d(-5px,0,0) scaleX(0.995)}"
+	 "to{transform:translate3d(0,0,0)}",
+	 ""},
+	{"bounceInUp",
+	 "from,60%,75%,90%,to{" SLT_EASE_OUT_CUBIC "}"
+	 "from{opacity:0;transform:translate3d(0,3000px,0) scaleY(5)}"
+	 "60%{opacity:1;transform:translate3d(0,-20px,0) scaleY(0.9)}"
+	 "75%{transform:translate3d(0,10px,0) scaleY(0.95)}"
+	 "90%{transform:translate3d(0,-5px,0) scaleY(0.985)}"
+	 "to{transform:translate3d(0,0,0)}",
+	 ""},
+	{"bounceOut",
+	 "20%{transform:scale3d(0.9,0.9,0.9)}"
+	 "50%,55%{opacity:1;transform:scale3d(1.1,1.1,1.1)}"
+	 "to{opacity:0;transform:scale3d(0.3,0.3,0.3)}",
+	 SLT_DURATION("0.75")},
+	{"bounceOutDown",
+	 "20%{transform:translate3d(0,10px,0) scaleY(0.985)}"
+	 "40%,45%{opacity:1;transform:translate3d(0,-20px,0) scaleY(0.9)}"
+	 "to{opacity:0;transform:translate3d(0,2000px,0) scaleY(3)}",
+	 ""},
+	{"bounceOutLeft",
+	 "20%{opacity:1;transform:translate3d(20px,0,0) scaleX(0.9)}"
+	 "to{opacity:0;transform:translate3d(-2000px,0,0) scaleX(2)}",
+	 ""},
+	{"bounceOutRight",
+	 "20%{opacity:1;transform:translate3d(-20px,0,0) scaleX(0.9)}"
+	 "to{opacity:0;transform:translate3d(2000px,0,0) scaleX(2)}",
+	 ""},
+	{"bounceOutUp",
+	 "20%{transform:translate3d(0,-10px,0) scaleY(0.985)}"
+	 "40%,45%{opacity:1;transform:translate3d(0,20px,0) scaleY(0.9)}"
+	 "to{opacity:0;transform:translate3d(0,-2000px,0) scaleY(3)}",
+	 ""},
+	{"fadeIn", "from{opacity:0}to{opacity:1}", ""},
+	{"fadeInBottomLeft",
+	 "from{opacity:0;transform:translate3d(-100%,100%,0)}to{opacity:1;transform:translate3d(0,0,0)}", ""},
+	{"fadeInBottomRight",
+	 "from{opacity:0;transform:translate3d(100%,100%,0)}to{opacity:1;transform:translate3d(0,0,0)}", ""},
+	{"fadeInDown", "from{opacity:0;transform:translate3d(0,-100%,0)}to{opacity:1;transform:translate3d(0,0,0)}",
+	 ""},
+	{"fadeInDownBig",
+	 "from{opacity:0;transform:translate3d(0,-2000px,0)}to{opacity:1;transform:translate3d(0,0,0)}", ""},
+	{"fadeInLeft", "from{opacity:0;transform:translate3d(-100%,0,0)}to{opacity:1;transform:translate3d(0,0,0)}",
+	 ""},
+	{"fadeInLeftBig",
+	 "from{opacity:0;transform:translate3d(-2000px,0,0)}to{opacity:1;transform:translate3d(0,0,0)}", ""},
+	{"fadeInRight", "from{opacity:0;transform:translate3d(100%,0,0)}to{opacity:1;transform:translate3d(0,0,0)}",
+	 ""},
+	{"fadeInRightBig",
+	 "from{opacity:0;transform:translate3d(2000px,0,0)}to{opacity:1;transform:translate3d(0,0,0)}", ""},
+	{"fadeInTopLeft",
+	 "from{opacity:0;transform:translate3d(-100%,-100%,0)}to{opacity:1;transform:translate3d(0,0,0)}", ""},
+	{"fadeInTopRight",
+	 "from{opacity:0;transform:translate3d(100%,-100%,0)}to{opacity:1;transform:translate3d(0,0,0)}", ""},
+	{"fadeInUp", "from{opacity:0;transform:translate3d(0,100%,0)}to{opacity:1;transform:translate3d(0,0,0)}", ""},
+	{"fadeInUpBig", "from{opacity:0;transform:translate3d(0,2000px,0)}to{opacity:1;transform:translate3d(0,0,0)}",
+	 ""},
+	{"fadeOut", "from{opacity:1}to{opacity:0}", ""},
+	{"fadeOutBottomLeft",
+	 "from{opacity:1;transform:translate3d(0,0,0)}to{opacity:0;transform:translate3d(-100%,100%,0)}", ""},
+	{"fadeOutBottomRight",
+	 "from{opacity:1;transform:translate3d(0,0,0)}to{opacity:0;transform:translate3d(100%,100%,0)}", ""},
+	{"fadeOutDown", "from{opacity:1}to{opacity:0;transform:translate3d(0,100%,0)}", ""},
+	{"fadeOutDownBig", "from{opacity:1}to{opacity:0;transform:translate3d(0,2000px,0)}", ""},
+	{"fadeOutLeft", "from{opacity:1}to{opacity:0;transform:translate3d(-100%,0,0)}", ""},
+	{"fadeOutLeftBig", "from{opacity:1}to{opacity:0;transform:translate3d(-2000px,0,0)}", ""},
+	{"fadeOutRight", "from{opacity:1}to{opacity:0;transform:translate3d(100%,0,0)}", ""},
+	{"fadeOutRightBig", "from{opacity:1}to{opacity:0;transform:translate3d(2000px,0,0)}", ""},
+	{"fadeOutTopLeft",
+	 "from{opacity:1;transform:translate3d(0,0,0)}to{opacity:0;transform:translate3d(-100%,-100%,0)}", ""},
+	{"fadeOutTopRight",
+	 "from{opacity:1;transform:translate3d(0,0,0)}to{opacity:0;transform:translate3d(100%,-100%,0)}", ""},
+	{"fadeOutUp", "from{opacity:1}to{opacity:0;transform:translate3d(0,-100%,0)}", ""},
+	{"fadeOutUpBig", "from{opacity:1}to{opacity:0;transform:translate3d(0,-2000px,0)}", ""},
+	{"flash", "from,50%,to{opacity:1}25%,75%{opacity:0}", ""},
+	{"flipInX",
+	 "from{transform:perspective(400px) rotate3d(1,0,0,90deg);animation-timing-function:ease-in;opacity:0}"
+	 "40%{transform:perspective(400px) rotate3d(1,0,0,-20deg);animation-timing-function:ease-in}"
+	 "60%{transform:perspective(400px) rotate3d(1,0,0,10deg);opacity:1}"
+	 "80%{transform:perspective(400px) rotate3d(1,0,0,-5deg)}"
+	 "to{transform:perspective(400px)}",
+	 "backface-visibility:visible!important;"},
+	{"flipInY",
+	 "from{transform:perspective(400px) rotate3d(0,1,0,90deg);animation-timing-function:ease-in;opacity:0}"
+	 "40%{transform:perspective(400px) rotate3d(0,1,0,-20deg);animation-timing-function:ease-in}"
+	 "60%{transform:perspective(400px) rotate3d(0,1,0,10deg);opacity:1}"
+	 "80%{transform:perspective(400px) rotate3d(0,1,0,-5deg)}"
+	 "to{transform:perspective(400px)}",
+	 "backface-visibility:visible!important;"},
+	{"flipOutX",
+	 "from{transform:perspective(400px)}"
+	 "30%{transform:perspective(400px) rotate3d(1,0,0,-20deg);opacity:1}"
+	 "to{transform:perspective(400px) rotate3d(1,0,0,90deg);opacity:0}",
+	 SLT_DURATION("0.75") "backface-visibility:visible!important;"},
+	{"flipOutY",
+	 "from{transform:perspective(400px)}"
+	 "30%{transform:perspective(400px) rotate3d(0,1,0,-15deg);opacity:1}"
+	 "to{transform:perspective(400px) rotate3d(0,1,0,90deg);opacity:0}",
+	 SLT_DURATION("0.75") "backface-visibility:visible!important;"},
+	{"headShake",
+	 "0%{transform:translateX(0)}"
+	 "6.5%{transform:translateX(-6px) rotateY(-9deg)}"
+	 "18.5%{transform:translateX(5px) rotateY(7deg)}"
+	 "31.5%{transform:translateX(-3px) rotateY(-5deg)}"
+	 "43.5%{transform:translateX(2px) rotateY(3deg)}"
+	 "50%{transform:translateX(0)}",
+	 "animation-timing-function:ease-in-out;"},
+	{"heartBeat",
+	 "0%{transform:scale(1)}14%{transform:scale(1.3)}28%{transform:scale(1)}42%{transform:scale(1.3)}"
+	 "70%{transform:scale(1)}",
+	 SLT_DURATION("1.3") "animation-timing-function:ease-in-out;"},
+	{"hinge",
+	 "0%{animation-timing-function:ease-in-out}"
+	 "20%,60%{transform:rotate3d(0,0,1,80deg);animation-timing-function:ease-in-out}"
+	 "40%,80%{transform:rotate3d(0,0,1,60deg);animation-timing-function:ease-in-out;opacity:1}"
+	 "to{transform:translate3d(0,700px,0);opacity:0}",
+	 SLT_DURATION("2") "transform-origin:top left;"},
+	{"jackInTheBox",
+	 "from{opacity:0;transform:scale(0.1) rotate(30deg);transform-origin:center bottom}"
+	 "50%{transform:rotate(-10deg)}70%{transform:rotate(3deg)}to{opacity:1;transform:scale(1)}",
+	 ""},
+	{"jello",
+	 "from,11.1%,to{transform:translate3d(0,0,0)}"
+	 "22.2%{transform:skewX(-12.5deg) skewY(-12.5deg)}"
+	 "33.3%{transform:skewX(6.25deg) skewY(6.25deg)}"
+	 "44.4%{transform:skewX(-3.125deg) skewY(-3.125deg)}"
+	 "55.5%{transform:skewX(1.5625deg) skewY(1.5625deg)}"
+	 "66.6%{transform:skewX(-0.78125deg) skewY(-0.78125deg)}"
+	 "77.7%{transform:skewX(0.390625deg) skewY(0.390625deg)}"
+	 "88.8%{transform:skewX(-0.1953125deg) skewY(-0.1953125deg)}",
+	 "transform-origin:center;"},
+	{"lightSpeedInLeft",
+	 "from{transform:translate3d(-100%,0,0) skewX(30deg);opacity:0}"
+	 "60%{transform:skewX(-20deg);opacity:1}80%{transform:skewX(5deg)}to{transform:translate3d(0,0,0)}",
+	 "animation-timing-function:ease-out;"},
+	{"lightSpeedInRight",
+	 "from{transform:translate3d(100%,0,0) skewX(-30deg);opacity:0}"
+	 "60%{transform:skewX(20deg);opacity:1}80%{transform:skewX(-5deg)}to{transform:translate3d(0,0,0)}",
+	 "animation-timing-function:ease-out;"},
+	{"lightSpeedOutLeft", "from{opacity:1}to{transform:translate3d(-100%,0,0) skewX(-30deg);opacity:0}",
+	 "animation-timing-function:ease-in;"},
+	{"lightSpeedOutRight", "from{opacity:1}to{transform:translate3d(100%,0,0) skewX(30deg);opacity:0}",
+	 "animation-timing-function:ease-in;"},
+	{"pulse", "from{transform:scale3d(1,1,1)}50%{transform:scale3d(1.05,1.05,1.05)}to{transform:scale3d(1,1,1)}",
+	 "animation-timing-function:ease-in-out;"},
+	{"rollIn",
+	 "from{opacity:0;transform:translate3d(-100%,0,0) rotate3d(0,0,1,-120deg)}"
+	 "to{opacity:1;transform:translate3d(0,0,0)}",
+	 ""},
+	{"rollOut", "from{opacity:1}to{opacity:0;transform:translate3d(100%,0,0) rotate3d(0,0,1,120deg)}", ""},
+	{"rotateIn", "from{transform:rotate3d(0,0,1,-200deg);opacity:0}to{transform:translate3d(0,0,0);opacity:1}",
+	 "transform-origin:center;"},
+	{"rotateInDownLeft",
+	 "from{transform:rotate3d(0,0,1,-45deg);opacity:0}to{transform:translate3d(0,0,0);opacity:1}",
+	 "transform-origin:left bottom;"},
+	{"rotateInDownRight",
+	 "from{transform:rotate3d(0,0,1,45deg);opacity:0}to{transform:translate3d(0,0,0);opacity:1}",
+	 "transform-origin:right bottom;"},
+	{"rotateInUpLeft", "from{transform:rotate3d(0,0,1,45deg);opacity:0}to{transform:translate3d(0,0,0);opacity:1}",
+	 "transform-origin:left bottom;"},
+	{"rotateInUpRight",
+	 "from{transform:rotate3d(0,0,1,-90deg);opacity:0}to{transform:translate3d(0,0,0);opacity:1}",
+	 "transform-origin:right bottom;"},
+	{"rotateOut", "from{opacity:1}to{transform:rotate3d(0,0,1,200deg);opacity:0}", "transform-origin:center;"},
+	{"rotateOutDownLeft", "from{opacity:1}to{transform:rotate3d(0,0,1,45deg);opacity:0}",
+	 "transform-origin:left bottom;"},
+	{"rotateOutDownRight", "from{opacity:1}to{transform:rotate3d(0,0,1,-45deg);opacity:0}",
+	 "transform-origin:right bottom;"},
+	{"rotateOutUpLeft", "from{opacity:1}to{transform:rotate3d(0,0,1,-45deg);opacity:0}",
+	 "transform-origin:left bottom;"},
+	{"rotateOutUpRight", "from{opacity:1}to{transform:rotate3d(0,0,1,90deg);opacity:0}",
+	 "transform-origin:right bottom;"},
+	{"rubberBand",
+	 "from{transform:scale3d(1,1,1)}30%{transform:scale3d(1.25,0.75,1)}40%{transform:scale3d(0.75,1.25,1)}"
+	 "50%{transform:scale3d(1.15,0.85,1)}65%{transform:scale3d(0.95,1.05,1)}75%{transform:scale3d(1.05,0.95,1)}"
+	 "to{transform:scale3d(1,1,1)}",
+	 ""},
+	{"shakeX",
+	 "from,to{transform:translate3d(0,0,0)}"
+	 "10%,30%,50%,70%,90%{transform:translate3d(-10px,0,0)}"
+	 "20%,40%,60%,80%{transform:translate3d(10px,0,0)}",
+	 ""},
+	{"shakeY",
+	 "from,to{transform:translate3d(0,0,0)}"
+	 "10%,30%,50%,70%,90%{transform:translate3d(0,-10px,0)}"
+	 "20%,40%,60%,80%{transform:translate3d(0,10px,0)}",
+	 ""},
+	{"slideInDown", "from{transform:translate3d(0,-100%,0);visibility:visible}to{transform:translate3d(0,0,0)}",
+	 ""},
+	{"slideInLeft", "from{transform:translate3d(-100%,0,0);visibility:visible}to{transform:translate3d(0,0,0)}",
+	 ""},
+	{"slideInRight", "from{transform:translate3d(100%,0,0);visibility:visible}to{transform:translate3d(0,0,0)}",
+	 ""},
+	{"slideInUp", "from{transform:translate3d(0,100%,0);visibility:visible}to{transform:translate3d(0,0,0)}", ""},
+	{"slideOutDown", "from{transform:translate3d(0,0,0)}to{visibility:hidden;transform:translate3d(0,100%,0)}",
+	 ""},
+	{"slideOutLeft", "from{transform:translate3d(0,0,0)}to{visibility:hidden;transform:translate3d(-100%,0,0)}",
+	 ""},
+	{"slideOutRight", "from{transform:translate3d(0,0,0)}to{visibility:hidden;transform:translate3d(100%,0,0)}",
+	 ""},
+	{"slideOutUp", "from{transform:translate3d(0,0,0)}to{visibility:hidden;transform:translate3d(0,-100%,0)}", ""},
+	{"swing",
+	 "20%{transform:rotate3d(0,0,1,15deg)}40%{transform:rotate3d(0,0,1,-10deg)}60%{transform:rotate3d(0,0,1,5deg)}"
+	 "80%{transform:rotate3d(0,0,1,-5deg)}to{transform:rotate3d(0,0,1,0deg)}",
+	 "transform-origin:top center;"},
+	{"tada",
+	 "from{transform:scale3d(1,1,1)}"
+	 "10%,20%{transform:scale3d(0.9,0.9,0.9) rotate3d(0,0,1,-3deg)}"
+	 "30%,50%,70%,90%{transform:scale3d(1.1,1.1,1.1) rotate3d(0,0,1,3deg)}"
+	 "40%,60%,80%{transform:scale3d(1.1,1.1,1.1) rotate3d(0,0,1,-3deg)}"
+	 "to{transform:scale3d(1,1,1)}",
+	 ""},
+	{"wobble",
+	 "from{transform:translate3d(0,0,0)}"
+	 "15%{transform:translate3d(-25%,0,0) rotate3d(0,0,1,-5deg)}"
+	 "30%{transform:translate3d(20%,0,0) rotate3d(0,0,1,3deg)}"
+	 "45%{transform:translate3d(-15%,0,0) rotate3d(0,0,1,-3deg)}"
+	 "60%{transform:translate3d(10%,0,0) rotate3d(0,0,1,2deg)}"
+	 "75%{transform:translate3d(-5%,0,0) rotate3d(0,0,1,-1deg)}"
+	 "to{transform:translate3d(0,0,0)}",
+	 ""},
+	{"zoomIn", "from{opacity:0;transform:scale3d(0.3,0.3,0.3)}50%{opacity:1}", ""},
+	{"zoomInDown",
+	 "from{opacity:0;transform:scale3d(0.1,0.1,0.1) translate3d(0,-1000px,0);" SLT_ZOOM_IN_CURVE "}"
+	 "60%{opacity:1;transform:scale3d(0.475,0.475,0.475) translate3d(0,60px,0);" SLT_ZOOM_OUT_CURVE "}",
+	 ""},
+	{"zoomInLeft",
+	 "from{opacity:0;transform:scale3d(0.1,0.1,0.1) translate3d(-1000px,0,0);" SLT_ZOOM_IN_CURVE "}"
+	 "60%{opacity:1;transform:scale3d(0.475,0.475,0.475) translate3d(10px,0,0);" SLT_ZOOM_OUT_CURVE "}",
+	 ""},
+	{"zoomInRight",
+	 "from{opacity:0;transform:scale3d(0.1,0.1,0.1) translate3d(1000px,0,0);" SLT_ZOOM_IN_CURVE "}"
+	 "60%{opacity:1;transform:scale3d(0.475,0.475,0.475) translate3d(-10px,0,0);" SLT_ZOOM_OUT_CURVE "}",
+	 ""},
+	{"zoomInUp",
+	 "from{opacity:0;transform:scale3d(0.1,0.1,0.1) translate3d(0,1000px,0);" SLT_ZOOM_IN_CURVE "}"
+	 "60%{opacity:1;transform:scale3d(0.475,0.475,0.475) translate3d(0,-60px,0);" SLT_ZOOM_OUT_CURVE "}",
+	 ""},
+	{"zoomOut", "from{opacity:1}50%{opacity:0;transform:scale3d(0.3,0.3,0.3)}to{opacity:0}", ""},
+	{"zoomOutDown",
+	 "40%{opacity:1;transform:scale3d(0.475,0.475,0.475) translate3d(0,-60px,0);" SLT_ZOOM_IN_CURVE "}"
+	 "to{opacity:0;transform:scale3d(0.1,0.1,0.1) translate3d(0,2000px,0);" SLT_ZOOM_OUT_CURVE "}",
+	 "transform-origin:center bottom;"},
+	{"zoomOutLeft",
+	 "40%{opacity:1;transform:scale3d(0.475,0.475,0.475) translate3d(42px,0,0)}"
+	 "to{opacity:0;transform:scale(0.1) translate3d(-2000px,0,0)}",
+	 "transform-origin:left center;"},
+	{"zoomOutRight",
+	 "40%{opacity:1;transform:scale3d(0.475,0.475,0.475) translate3d(-42px,0,0)}"
+	 "to{opacity:0;transform:scale(0.1) translate3d(2000px,0,0)}",
+	 "transform-origin:right center;"},
+	{"zoomOutUp",
+	 "40%{opacity:1;transform:scale3d(0.475,0.475,0.475) translate3d(0,60px,0);" SLT_ZOOM_IN_CURVE "}"
+	 "to{opacity:0;transform:scale3d(0.1,0.1,0.1) translate3d(0,-2000px,0);" SLT_ZOOM_OUT_CURVE "}",
+	 "transform-origin:center bottom;"},
+};
+
+#undef SLT_EASE_OUT_CUBIC
+#undef SLT_EASE_IN_CUBIC
+#undef SLT_ZOOM_IN_CURVE
+#undef SLT_ZOOM_OUT_CURVE
+#undef SLT_DURATION
+
+struct modifier {
+	std::string_view cls;
+	std::string_view rule;
+};
+
+const modifier kModifiers[] = {
+	{"animate__infinite", ".animate__animated.animate__infinite{animation-iteration-count:infinite}"},
+	{"animate__repeat-1",
+	 ".animate__animated.animate__repeat-1{animation-iteration-count:var(--animate-repeat)}"},
+	{"animate__repeat-2",
+	 ".animate__animated.animate__repeat-2{animation-iteration-count:calc(var(--animate-repeat)*2)}"},
+	{"animate__repeat-3",
+	 ".animate__animated.animate__repeat-3{animation-iteration-count:calc(var(--animate-repeat)*3)}"},
+	{"animate__delay-1s", ".animate__animated.animate__delay-1s{animation-delay:var(--animate-delay)}"},
+	{"animate__delay-2s", ".animate__animated.animate__delay-2s{animation-delay:calc(var(--animate-delay)*2)}"},
+	{"animate__delay-3s", ".animate__animated.animate__delay-3s{animation-delay:calc(var(--animate-delay)*3)}"},
+	{"animate__delay-4s", ".animate__animated.animate__delay-4s{animation-delay:calc(var(--animate-delay)*4)}"},
+	{"animate__delay-5s", ".animate__animated.animate__delay-5s{animation-delay:calc(var(--animate-delay)*5)}"},
+	{"animate__faster",
+	 ".animate__animated.animate__faster{animation-duration:calc(var(--animate-duration)/2)}"},
+	{"animate__fast", ".animate__animated.animate__fast{animation-duration:calc(var(--animate-duration)*0.8)}"},
+	{"animate__slow", ".animate__animated.animate__slow{animation-duration:calc(var(--animate-duration)*2)}"},
+	{"animate__slower",
+	 ".animate__animated.animate__slower{animation-duration:calc(var(--animate-duration)*3)}"},
+};
+
+bool is_class_char(char c)
+{
+	return std::isalnum((unsigned char)c) || c == '_' || c == '-';
+}
+
+} // namespace
+
+const animation *find_animation(std::string_view cls)
+{
+	if (cls.substr(0, kPrefix.size()) != kPrefix)
+		return nullptr;
+
+	const std::string_view name = cls.substr(kPrefix.size());
+	const auto it = std::lower_bound(std::begin(kAnimations), std::end(kAnimations), name,
+					 [](const animation &a, std::string_view n) { return a.name < n; });
+	return (it != std::end(kAnimations) && it->name == name) ? it : nullptr;
+}
+
+std::string_view find_modifier(std::string_view cls)
+{
+	for (const auto &m : kModifiers) {
+		if (m.cls == cls)
+			return m.rule;
+	}
+	return {};
+}
+
+std::string_view base_rules()
+{
+	return ":root{--animate-duration:1s;--animate-delay:1s;--animate-repeat:1}\n"
+	       ".animate__animated{animation-duration:var(--animate-duration);animation-fill-mode:both}\n"
+	       "@media print,(prefers-reduced-motion:reduce){"
+	       ".animate__animated{animation-duration:1ms!important;transition-duration:1ms!important;"
+	       "animation-iteration-count:1!important}"
+	       ".animate__animated[class*='Out']{opacity:0}}\n";
+}
+
+void collect_classes(std::string_view text, std::vector<std::string> &out)
+{
+	for (size_t p = text.find(kPrefix); p != std::string_view::npos; p = text.find(kPrefix, p + 1)) {
+		if (p > 0 && is_class_char(text[p - 1]))
+			continue;
+
+		size_t e = p + kPrefix.size();
+		while (e < text.size() && is_class_char(text[e]))
+			++e;
+
+		const std::string_view cls = text.substr(p, e - p);
+		if (cls.size() > kPrefix.size() && cls != "animate__animated" &&
+		    std::find(out.begin(), out.end(), cls) == out.end())
+			out.emplace_back(cls);
+	}
+}
+
+} // namespace smart_lt::animate_css
@@ -0,0 +1,245 @@
+// avatar_assets.cpp
+#define LOG_TAG "[" PLUGIN_NAME "][avatar]"
+#include "avatar_assets.hpp"
+
+#include "core.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QThreadPool>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace smart_lt::avatar {
+
+enum class variant_state : uint8_t {
+	Pending,  // queued or being encoded; the original is rendered meanwhile
+	Ready,    // `file` exists
+	Original, // nothing to gain (or nothing decodable): render the original
+};
+
+struct variant_entry {
+	variant_state state = variant_state::Pending;
+	std::string file;
+};
+
+static std::mutex g_mx;
+static std::unordered_map<std::string, variant_entry> g_variants; // variant_key() -> entry
+static std::unique_ptr<QThreadPool> g_pool;
+static bool g_stopped = false;
+
+static const char *variant_format()
+{
+	static const bool webp = QImageWriter::supportedImageFormats().contains("webp");
+	return webp ? "webp" : "png";
+}
+
+// Named after the CSS size it serves, so a later session finds it without decoding anything.
+static std::string variant_name(const std::string &original, int w, int h)
+{
+	return original + "." + std::to_string(w) + "x" + std::to_string(h) + "@" + std::to_string(kPixelRatio) +
+	       "x." + variant_format();
+}
+
+static std::string variant_key(const std::string &dir, const std::string &original)
+{
+	return dir + '\n' + original;
+}
+
+static QString dir_path(const std::string &dir, const std::string &file)
+{
+	return QDir(QString::fromStdString(dir)).filePath(QString::fromStdString(file));
+}
+
+// Hands the variants of `original` on disk, except `keep`, to discard_output_file(): the bundle
+// manifest deletes each once no kept page loads it.
+static void discard_variant_files(const std::string &dir, const std::string &original, const std::string &keep)
+{
+	static const QRegularExpression kSuffix(QStringLiteral("^\\d+x\\d+@\\d+x\\.(webp|png)$"));
+
+	const QString prefix = QString::fromStdString(original) + ".";
+	const QDir d(QString::fromStdString(dir));
+	for (const QString &name : d.entryList({prefix + "*"}, QDir::Files)) {
+		const std::string file = name.toStdString();
+		if (file != keep && kSuffix.match(name.mid(prefix.size())).hasMatch())
+			discard_output_file(dir, file);
+	}
+}
+
+// False when discard_picture() dropped the entry while the job ran. The entries for other sizes of
+// the same original are dropped: their files are on their way out, so a later lookup at one of those
+// sizes must check the disk again instead of trusting a stale Ready.
+static bool finish(const std::string &key, variant_state state, const std::string &file)
+{
+	std::lock_guard<std::mutex> lk(g_mx);
+	auto it = g_variants.find(key);
+	if (it == g_variants.end())
+		return false;
+	it->second.state = state;
+	it->second.file = file;
+
+	const std::string prefix = key.substr(0, key.rfind('\n') + 1);
+	for (auto o = g_variants.begin(); o != g_variants.end();) {
+		if (o->first != key && o->first.compare(0, prefix.size(), prefix) == 0)
+			o = g_variants.erase(o);
+		else
+			++o;
+	}
+	return true;
+}
+
+// Pool job: decodes `original` once, at the scaled size where the codec supports it (JPEG does).
+static void encode_variant(const std::string &dir, const std::string &original, int w, int h, const std::string &key)
+{
+	const QString srcPath = dir_path(dir, original);
+	QImageReader reader(srcPath);
+	reader.setAutoTransform(true);
+
+	if (!reader.canRead() || (reader.supportsAnimation() && reader.imageCount() > 1)) {
+		finish(key, variant_state::Original, std::string());
+		return;
+	}
+
+	const QSize box(w * kPixelRatio, h * kPixelRatio);
+	const QSize src = reader.size();
+	if (src.isValid()) {
+		// scaledSize applies before the EXIF transformation, so a rotated photo fits a transposed box.
+		const QSize srcBox = reader.transformation().testFlag(QImageIOHandler::TransformationRotate90)
+					     ? box.transposed()
+					     : box;
+		const QSize cover = src.scaled(srcBox, Qt::KeepAspectRatioByExpanding);
+		if (cover.width() >= src.width()) {
+			finish(key, variant_state::Original, std::string());
+			return;
+		}
+		reader.setScaledSize(cover);
+	}
+
+	QImage img = reader.read();
+	if (img.isNull()) {
+		LOGW("Cannot decode profile picture '%s': %s", original.c_str(),
+		     reader.errorString().toUtf8().constData());
+		finish(key, variant_state::Original, std::string());
+		return;
+	}
+
+	// Codecs that report no size up front (or ignore scaledSize) decoded at full size.
+	const QSize cover = img.size().scaled(box, Qt::KeepAspectRatioByExpanding);
+	if (cover.width() < img.width()) {
+		img = img.scaled(cover, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+	} else if (!src.isValid()) {
+		finish(key, variant_state::Original, std::string());
+		return;
+	}
+
+	const std::string file = variant_name(original, w, h);
+	QSaveFile out(dir_path(dir, file));
+	QImageWriter writer(&out, variant_format());
+	writer.setQuality(85);
+	if (!out.open(QIODevice::WriteOnly) || !writer.write(img) || !out.commit()) {
+		LOGW("Failed writing avatar variant %s: %s", file.c_str(), writer.errorString().toUtf8().constData());
+		finish(key, variant_state::Original, std::string());
+		return;
+	}
+
+	if (!finish(key, variant_state::Ready, file)) {
+		QFile::remove(dir_path(dir, file)); // the picture was removed meanwhile
+		return;
+	}
+	discard_variant_files(dir, original, file);
+	LOGI("Avatar %s: %dx%d -> %dx%d (%s)", original.c_str(), src.width(), src.height(), img.width(), img.height(),
+	     file.c_str());
+	rebuild_and_swap();
+}
+
+std::string rendered_file(const std::string &dir, const std::string &original, int w, int h)
+{
+	if (original.empty() || dir.empty() || w <= 0 || h <= 0)
+		return original;
+	if (original.find_first_of("/\\:") != std::string::npos)
+		return original; // not a file of `dir`; never write next to it
+
+	// Keyed by the size too: a resize starts over (the job replaces the old variant on disk).
+	const std::string key = variant_key(dir, original) + '\n' + std::to_string(w) + "x" + std::to_string(h);
+
+	std::lock_guard<std::mutex> lk(g_mx);
+	auto it = g_variants.find(key);
+	if (it != g_variants.end())
+		return it->second.state == variant_state::Ready ? it->second.file : original;
+	if (g_stopped)
+		return original;
+
+	// A variant from an earlier session is reused while it is newer than the original.
+	const std::string file = variant_name(original, w, h);
+	const QFileInfo have(dir_path(dir, file));
+	if (have.exists() && have.lastModified() >= QFileInfo(dir_path(dir, original)).lastModified()) {
+		g_variants[key] = {variant_state::Ready, file};
+		return file;
+	}
+
+	g_variants[key] = variant_entry();
+	if (!g_pool) {
+		g_pool = std::make_unique<QThreadPool>();
+		g_pool->setMaxThreadCount(2);
+	}
+	g_pool->start([dir, original, w, h, key]() { encode_variant(dir, original, w, h, key); });
+	return original;
+}
+
+void discard_picture(const std::string &dir, const std::string &original)
+{
+	if (dir.empty() || original.empty())
+		return;
+
+	{
+		const std::string prefix = variant_key(dir, original) + '\n';
+		std::lock_guard<std::mutex> lk(g_mx);
+		for (auto it = g_variants.begin(); it != g_variants.end();) {
+			if (it->first.compare(0, prefix.size(), prefix) == 0)
+				it = g_variants.erase(it);
+			else
+				++it;
+		}
+	}
+	discard_output_file(dir, original);
+	discard_variant_files(dir, original, std::string());
+}
+
+bool variant_in_use(const std::string &dir, const std::string &file)
+{
+	const std::string prefix = dir + '\n';
+	std::lock_guard<std::mutex> lk(g_mx);
+	for (const auto &kv : g_variants) {
+		if (kv.second.state == variant_state::Ready && kv.second.file == file &&
+		    kv.first.compare(0, prefix.size(), prefix) == 0)
+			return true;
+	}
+	return false;
+}
+
+void shutdown()
+{
+	std::unique_ptr<QThreadPool> pool;
+	{
+		std::lock_guard<std::mutex> lk(g_mx);
+		g_stopped = true;
+		pool = std::move(g_pool);
+	}
+	if (pool) {
+		pool->clear();
+		pool->waitForDone();
+	}
+
+	std::lock_guard<std::mutex> lk(g_mx);
+	g_variants.clear();
+}
+
+} // namespace smart_lt::avatar
@@ -0,0 +1,78 @@
+// command_queue.cpp
+#define LOG_TAG "[" PLUGIN_NAME "][cmd]"
+#include "command_queue.hpp"
+
+#include "core.hpp"
+
+#include <QCoreApplication>
+#include <QMetaObject>
+#include <QThread>
+
+#include <deque>
+#include <mutex>
+
+namespace smart_lt::cmd {
+
+static std::mutex g_mx;
+static std::deque<std::function<void()>> g_queue;
+static bool g_drain_posted = false;
+static bool g_closed = false;
+
+bool on_owner_thread()
+{
+	QCoreApplication *app = QCoreApplication::instance();
+	return !app || QThread::currentThread() == app->thread();
+}
+
+// Runs on the owner thread. Commands are popped one at a time so a command may itself post more.
+static void drain()
+{
+	while (true) {
+		std::function<void()> fn;
+		{
+			std::lock_guard<std::mutex> lk(g_mx);
+			if (g_queue.empty()) {
+				g_drain_posted = false;
+				return;
+			}
+			fn = std::move(g_queue.front());
+			g_queue.pop_front();
+		}
+		fn();
+	}
+}
+
+bool post(std::function<void()> fn)
+{
+	QCoreApplication *app = QCoreApplication::instance();
+
+	std::lock_guard<std::mutex> lk(g_mx);
+	if (g_closed || !app)
+		return false;
+
+	g_queue.push_back(std::move(fn));
+	if (!g_drain_posted) {
+		g_drain_posted = true;
+		QMetaObject::invokeMethod(app, []() { drain(); }, Qt::QueuedConnection);
+	}
+	return true;
+}
+
+void shutdown()
+{
+	std::deque<std::function<void()>> dropped;
+	{
+		std::lock_guard<std::mutex> lk(g_mx);
+		g_closed = true;
+		dropped.swap(g_queue);
+	}
+	if (!dropped.empty())
+		LOGW("Dropping %d queued command(s) at shutdown", (int)dropped.size());
+}
+
+void log_timeout(const char *what)
+{
+	LOGW("Command '%s' did not start on the main thread in time; cancelled", what ? what : "?");
+}
+
+} // namespace smart_lt::cmd
@@ -1,12 +1,22 @@
 
 #define LOG_TAG "[" PLUGIN_NAME "][core]"
 #include "core.hpp"
+#include "command_queue.hpp"
+#include "event_bus.hpp"
+#include "css_scope.hpp"
+#include "animate_css.hpp"
+#include "avatar_assets.hpp"
+#include "minify.hpp"
+#include "template.hpp"
 
 #include <algorithm>
 #include <sstream>
 #include <random>
 #include <cctype>
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
+#include <thread>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -14,11 +24,14 @@
 
 #include <QDir>
 #include <QFile>
+#include <QSaveFile>
 #include <QFileInfo>
+#include <QCryptographicHash>
 #include <QDateTime>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QKeySequence>
 
 #include <obs.h>
 #include <obs-module.h>
@@ -27,70 +40,84 @@
 
 namespace smart_lt {
 
+static std::mutex g_output_dir_mx; // the rebuild worker reads the output dir too
 static std::string g_output_dir;
 static std::string g_target_browser_source;
 static int g_target_browser_width = sltBrowserWidth;
 static int g_target_browser_height = sltBrowserHeight;
+static std::atomic<bool> g_minify_output{false}; // read by the rebuild worker
+static std::atomic<bool> g_single_file_output{false};
 static std::vector<lower_third_cfg> g_items;
 static std::vector<group_cfg> g_groups;
 static std::vector<std::string> g_visible;
+static id_list_ref g_visible_snapshot; // shared with events; reset whenever g_visible changes
+// Set by anything that may have changed g_items / g_groups since the last published snapshot.
+static bool g_items_dirty = true;
+static bool g_groups_dirty = true;
 static std::string g_last_html_path;
+static std::string g_push_url;
+static std::string g_ack_url;
 
-struct listener {
-	uint64_t token = 0;
-	core_event_cb cb = nullptr;
-	void *user = nullptr;
-};
-
-static std::mutex g_evt_mx;
-static std::vector<listener> g_listeners;
-static uint64_t g_next_token = 1;
-
-static void emit_event(const core_event &ev)
+static std::string join_path(const std::string &a, const std::string &b)
 {
-	std::vector<listener> copy;
-	{
-		std::lock_guard<std::mutex> lk(g_evt_mx);
-		copy = g_listeners;
-	}
-	for (const auto &l : copy) {
-		if (l.cb)
-			l.cb(ev, l.user);
-	}
+	QDir d(QString::fromStdString(a));
+	return d.filePath(QString::fromStdString(b)).toStdString();
 }
 
-uint64_t add_event_listener(core_event_cb cb, void *user)
+static std::string content_digest(const std::string &data)
 {
-	if (!cb)
-		return 0;
-
-	std::lock_guard<std::mutex> lk(g_evt_mx);
-	const uint64_t t = g_next_token++;
-	g_listeners.push_back(listener{t, cb, user});
-	return t;
+	const QByteArray r = QCryptographicHash::hash(QByteArray::fromRawData(data.data(), (int)data.size()),
+						      QCryptographicHash::Sha256);
+	return std::string(r.constData(), (size_t)r.size());
 }
 
-void remove_event_listener(uint64_t token)
+// Short hex form of a content_digest(), used for content-named files and page ids.
+static std::string digest_hex(const std::string &digest)
 {
-	if (token == 0)
-		return;
-
-	std::lock_guard<std::mutex> lk(g_evt_mx);
-	g_listeners.erase(std::remove_if(g_listeners.begin(), g_listeners.end(),
-					 [&](const listener &l) { return l.token == token; }),
-			  g_listeners.end());
+	return QByteArray::fromStdString(digest).toHex().left(16).toStdString();
 }
 
-static std::string join_path(const std::string &a, const std::string &b)
+// What we last wrote to each path. A write is skipped only when the digest matches and the file
+// on disk still has the size and mtime we left it with (i.e. nobody touched it since).
+struct written_file {
+	std::string digest;
+	qint64 size = -1;
+	qint64 mtime = 0;
+};
+
+static std::mutex g_written_mx; // writes come from the main thread and the rebuild worker
+static std::unordered_map<std::string, written_file> g_written_files;
+
+static bool written_unchanged(const std::string &path, const QString &qpath, const std::string &digest)
 {
-	QDir d(QString::fromStdString(a));
-	return d.filePath(QString::fromStdString(b)).toStdString();
+	written_file w;
+	{
+		std::lock_guard<std::mutex> lk(g_written_mx);
+		auto it = g_written_files.find(path);
+		if (it == g_written_files.end() || it->second.digest != digest)
+			return false;
+		w = it->second;
+	}
+	const QFileInfo fi(qpath);
+	return fi.exists() && fi.size() == w.size && fi.lastModified().toMSecsSinceEpoch() == w.mtime;
 }
 
-static bool write_text_file(const std::string &path, const std::string &data)
+// Atomic write: the data goes to a temp file in the same directory which is renamed over `path`
+// on commit, so the browser source never observes a truncated file. Unchanged content is not
+// rewritten. `digestOut` (optional) receives content_digest(data).
+static bool write_text_file(const std::string &path, const std::string &data, std::string *digestOut = nullptr)
 {
-	QFile f(QString::fromStdString(path));
-	if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+	std::string digest = content_digest(data);
+	if (digestOut)
+		*digestOut = digest;
+
+	const QString qpath = QString::fromStdString(path);
+
+	if (written_unchanged(path, qpath, digest))
+		return true;
+
+	QSaveFile f(qpath);
+	if (!f.open(QIODevice::WriteOnly)) {
 		LOGW("Failed opening '%s' for write (err=%d '%s')", path.c_str(), (int)f.error(),
 		     f.errorString().toUtf8().constData());
 		return false;
@@ -98,14 +125,33 @@ static bool write_text_file(const std::string &path, const std::string &data)
 	const qint64 written = f.write(data.data(), (qint64)data.size());
 	if (written != (qint64)data.size()) {
 		LOGW("Short write for '%s' (%lld/%lld)", path.c_str(), (long long)written, (long long)data.size());
-		f.close();
+		f.cancelWriting();
 		return false;
 	}
-	f.flush();
-	f.close();
+	if (!f.commit()) {
+		LOGW("Failed committing '%s' (err=%d '%s')", path.c_str(), (int)f.error(),
+		     f.errorString().toUtf8().constData());
+		std::lock_guard<std::mutex> lk(g_written_mx);
+		g_written_files.erase(path);
+		return false;
+	}
+
+	const QFileInfo fi(qpath);
+	std::lock_guard<std::mutex> lk(g_written_mx);
+	written_file &w = g_written_files[path];
+	w.digest = std::move(digest);
+	w.size = fi.size();
+	w.mtime = fi.lastModified().toMSecsSinceEpoch();
 	return true;
 }
 
+// Drops the write cache entry of a file that is about to be deleted.
+static void forget_written_file(const std::string &path)
+{
+	std::lock_guard<std::mutex> lk(g_written_mx);
+	g_written_files.erase(path);
+}
+
 static std::string read_text_file(const std::string &path)
 {
 	QFile f(QString::fromStdString(path));
@@ -153,15 +199,28 @@ static bool is_ident_char(char c)
 	return std::isalnum((unsigned char)c) || c == '_' || c == '-';
 }
 
-static std::string normalize_ws_no_space(const std::string &s)
+// SHA-256 over the non-whitespace runs of a block joined by single spaces, so reformatting never
+// changes the key (while "a b" and "ab" still differ) and no normalized copy is built.
+static std::string keyframes_digest(const std::string &block)
 {
-	std::string out;
-	out.reserve(s.size());
-	for (char c : s) {
-		if (!std::isspace((unsigned char)c))
-			out.push_back(c);
+	QCryptographicHash h(QCryptographicHash::Sha256);
+	bool first = true;
+	size_t i = 0;
+	while (i < block.size()) {
+		while (i < block.size() && std::isspace((unsigned char)block[i]))
+			i++;
+		const size_t start = i;
+		while (i < block.size() && !std::isspace((unsigned char)block[i]))
+			i++;
+		if (i > start) {
+			if (!first)
+				h.addData(QByteArray::fromRawData(" ", 1));
+			h.addData(QByteArray::fromRawData(block.data() + start, (int)(i - start)));
+			first = false;
+		}
 	}
-	return out;
+	const QByteArray r = h.result();
+	return std::string(r.constData(), (size_t)r.size());
 }
 
 static std::string replace_whole_ident(std::string s, const std::string &from, const std::string &to)
@@ -191,95 +250,10 @@ struct extracted_keyframes {
 	std::string at_rule;
 	std::string name;
 	std::string block;
-	std::string norm;
+	size_t name_pos = 0; // offset of `name` in `block`
+	std::string digest;  // keyframes_digest(block)
 };
 
-static void extract_keyframes_blocks(std::string &css, std::vector<extracted_keyframes> &out)
-{
-	auto find_next = [&](size_t start) -> std::pair<size_t, std::string> {
-		const size_t p1 = css.find("@keyframes", start);
-		const size_t p2 = css.find("@-webkit-keyframes", start);
-		if (p1 == std::string::npos && p2 == std::string::npos)
-			return {std::string::npos, {}};
-		if (p2 == std::string::npos || (p1 != std::string::npos && p1 < p2))
-			return {p1, "@keyframes"};
-		return {p2, "@-webkit-keyframes"};
-	};
-
-	size_t cur = 0;
-	while (true) {
-		auto [pos, atr] = find_next(cur);
-		if (pos == std::string::npos)
-			break;
-
-		size_t nameStart = pos + atr.size();
-		while (nameStart < css.size() && std::isspace((unsigned char)css[nameStart]))
-			nameStart++;
-
-		size_t nameEnd = nameStart;
-		while (nameEnd < css.size() && is_ident_char(css[nameEnd]))
-			nameEnd++;
-
-		std::string name;
-		if (nameEnd > nameStart)
-			name = css.substr(nameStart, nameEnd - nameStart);
-
-		size_t braceOpen = css.find('{', nameEnd);
-		if (braceOpen == std::string::npos) {
-			cur = nameEnd;
-			continue;
-		}
-
-		int depth = 0;
-		size_t i = braceOpen;
-		for (; i < css.size(); i++) {
-			if (css[i] == '{')
-				depth++;
-			else if (css[i] == '}') {
-				depth--;
-				if (depth == 0) {
-					const size_t endPos = i + 1;
-					const std::string block = css.substr(pos, endPos - pos);
-
-					extracted_keyframes kf;
-					kf.at_rule = atr;
-					kf.name = name;
-					kf.block = block;
-					kf.norm = normalize_ws_no_space(block);
-
-					out.push_back(std::move(kf));
-
-					css.replace(pos, endPos - pos, "\n");
-					cur = pos;
-					break;
-				}
-			}
-		}
-
-		if (depth != 0) {
-
-			break;
-		}
-	}
-}
-
-static void delete_old_lt_html_keep(const std::string &keepAbsPath)
-{
-	if (!has_output_dir())
-		return;
-
-	QDir d(QString::fromStdString(output_dir()));
-	const QFileInfo keepFi(QString::fromStdString(keepAbsPath));
-	const QString keepName = keepFi.fileName();
-
-	const QStringList list = d.entryList(QStringList() << "lt-*.html", QDir::Files, QDir::Time);
-	for (const QString &fn : list) {
-		if (!keepName.isEmpty() && fn == keepName)
-			continue;
-		d.remove(fn);
-	}
-}
-
 static bool file_exists(const std::string &path)
 {
 	return QFileInfo(QString::fromStdString(path)).exists();
@@ -325,6 +299,7 @@ static void load_global_config()
 
 	const QString out = root.value("output_dir").toString().trimmed();
 	if (!out.isEmpty()) {
+		std::lock_guard<std::mutex> lk(g_output_dir_mx);
 		g_output_dir = out.toStdString();
 		LOGI("Loaded output_dir: '%s'", g_output_dir.c_str());
 	}
@@ -341,6 +316,9 @@ static void load_global_config()
 		g_target_browser_width = w;
 	if (h > 0)
 		g_target_browser_height = h;
+
+	g_minify_output = root.value("minify_output").toBool(false);
+	g_single_file_output = root.value("single_file_output").toBool(false);
 }
 
 bool save_global_config()
@@ -353,10 +331,12 @@ bool save_global_config()
 	QDir().mkpath(fi.absolutePath());
 
 	QJsonObject root;
-	root["output_dir"] = QString::fromStdString(g_output_dir);
+	root["output_dir"] = QString::fromStdString(output_dir());
 	root["target_browser_source"] = QString::fromStdString(g_target_browser_source);
 	root["target_browser_width"] = g_target_browser_width;
 	root["target_browser_height"] = g_target_browser_height;
+	root["minify_output"] = g_minify_output.load();
+	root["single_file_output"] = g_single_file_output.load();
 
 	const QJsonDocument doc(root);
 	return write_text_file(pathS, doc.toJson(QJsonDocument::Compact).toStdString());
@@ -374,45 +354,19 @@ static std::string find_latest_lt_html()
 	return d.filePath(list.first()).toStdString();
 }
 
-static std::string bundle_styles_name(const std::string &)
-{
-	return "lt.css";
-}
-static std::string bundle_scripts_name(const std::string &)
-{
-	return "lt.js";
-}
-static std::string bundle_html_name(const std::string &ts)
-{
-	return "lt-" + ts + ".html";
-}
-
-static std::string bundle_styles_path(const std::string &ts)
-{
-	return has_output_dir() ? join_path(output_dir(), bundle_styles_name(ts)) : std::string();
-}
-
-static std::string bundle_scripts_path(const std::string &ts)
+// Generated files are named after their content and never rewritten, so a browser source still loading
+// an older page keeps getting exactly the stylesheet and script that page was built with.
+static std::string bundle_styles_name(const std::string &digest)
 {
-	return has_output_dir() ? join_path(output_dir(), bundle_scripts_name(ts)) : std::string();
+	return "lt." + digest_hex(digest) + ".css";
 }
-
-static std::string bundle_html_path(const std::string &ts)
+static std::string bundle_scripts_name(const std::string &digest)
 {
-	return has_output_dir() ? join_path(output_dir(), bundle_html_name(ts)) : std::string();
+	return "lt." + digest_hex(digest) + ".js";
 }
-
-static void cleanup_old_bundles(int keep)
+static std::string bundle_html_name(const std::string &digest)
 {
-	if (!has_output_dir() || keep < 1)
-		return;
-
-	QDir d(QString::fromStdString(output_dir()));
-	const QStringList htmls = d.entryList(QStringList() << "lt-*.html", QDir::Files, QDir::Time);
-	for (int i = keep; i < htmls.size(); ++i) {
-		const QString fn = htmls.at(i);
-		d.remove(fn);
-	}
+	return "lt-" + digest_hex(digest) + ".html";
 }
 
 static lower_third_cfg default_cfg()
@@ -569,6 +523,67 @@ static lower_third_cfg default_cfg()
 	return c;
 }
 
+// Limits every path that stores an item (load, single update, batch) holds it to.
+struct int_range {
+	int lo;
+	int hi;
+};
+static constexpr int_range kFontSizeRange{6, 200};
+static constexpr int_range kAvatarSizeRange{10, 400};
+static constexpr int_range kPercentRange{0, 100};
+static constexpr int_range kRepeatSecRange{0, 86400};
+
+static int clamp_to(int v, int_range r)
+{
+	return std::clamp(v, r.lo, r.hi);
+}
+
+// Clamps `c` into the ranges above and fills what must not stay empty. Group members never repeat on
+// their own: the group schedules them.
+static void normalize_item(lower_third_cfg &c, bool grouped)
+{
+	c.title_size = clamp_to(c.title_size, kFontSizeRange);
+	c.subtitle_size = clamp_to(c.subtitle_size, kFontSizeRange);
+	c.avatar_width = clamp_to(c.avatar_width, kAvatarSizeRange);
+	c.avatar_height = clamp_to(c.avatar_height, kAvatarSizeRange);
+
+	if (c.opacity < kPercentRange.lo || c.opacity > kPercentRange.hi)
+		c.opacity = 85;
+	if (c.radius < kPercentRange.lo || c.radius > kPercentRange.hi)
+		c.radius = 5;
+
+	c.repeat_every_sec = grouped ? 0 : clamp_to(c.repeat_every_sec, kRepeatSecRange);
+	c.repeat_visible_sec = grouped ? 0 : clamp_to(c.repeat_visible_sec, kRepeatSecRange);
+
+	if (c.html_template.empty() || c.css_template.empty()) {
+		auto d = default_cfg();
+		if (c.html_template.empty())
+			c.html_template = d.html_template;
+		if (c.css_template.empty())
+			c.css_template = d.css_template;
+		if (c.js_template.empty())
+			c.js_template = d.js_template;
+	}
+
+	if (c.lt_position.empty())
+		c.lt_position = "lt-pos-bottom-left";
+	if (c.anim_in.empty())
+		c.anim_in = "animate__fadeInUp";
+	if (c.anim_out.empty())
+		c.anim_out = "animate__fadeOutDown";
+	if (c.primary_color.empty())
+		c.primary_color = "#111827";
+	if (c.secondary_color.empty())
+		c.secondary_color = "#1F2937";
+	if (c.title_color.empty())
+		c.title_color = "#F9FAFB";
+	if (c.subtitle_color.empty())
+		c.subtitle_color = "#D1D5DB";
+
+	if (c.label.empty())
+		c.label = c.title.empty() ? c.id : c.title;
+}
+
 static std::string resolve_in_class(const lower_third_cfg &c)
 {
 	if (c.anim_in == "custom_handled_in")
@@ -583,49 +598,42 @@ static std::string resolve_out_class(const lower_third_cfg &c)
 	return c.anim_out;
 }
 
-using slt_repl_map = std::unordered_map<std::string, std::string>;
-
-static slt_repl_map build_placeholder_map(const lower_third_cfg &c)
-{
-	slt_repl_map m;
-	m.reserve(32);
-	m["{{ID}}"] = c.id;
-	m["{{PRIMARY_COLOR}}"] = c.primary_color;
-	m["{{SECONDARY_COLOR}}"] = c.secondary_color;
-	m["{{TITLE_COLOR}}"] = c.title_color;
-	m["{{SUBTITLE_COLOR}}"] = c.subtitle_color;
-	m["{{TITLE}}"] = c.title;
-	m["{{SUBTITLE}}"] = c.subtitle;
-	m["{{OPACITY}}"] = std::to_string(c.opacity);
-	m["{{RADIUS}}"] = std::to_string(c.radius);
-	m["{{FONT_FAMILY}}"] = c.font_family.empty() ? "Inter" : c.font_family;
-	m["{{TITLE_SIZE}}"] = std::to_string(c.title_size);
-	m["{{SUBTITLE_SIZE}}"] = std::to_string(c.subtitle_size);
-	m["{{AVATAR_WIDTH}}"] = std::to_string(c.avatar_width);
-	m["{{AVATAR_HEIGHT}}"] = std::to_string(c.avatar_height);
-	m["{{ANIM_IN}}"] = c.anim_in;
-	m["{{ANIM_OUT}}"] = c.anim_out;
-	const std::string pic = c.profile_picture.empty() ? "./" : ("./" + c.profile_picture);
-	m["{{PROFILE_PICTURE_URL}}"] = pic;
-	const std::string sIn = c.anim_in_sound.empty() ? "" : ("./" + c.anim_in_sound);
-	const std::string sOut = c.anim_out_sound.empty() ? "" : ("./" + c.anim_out_sound);
-	m["{{SOUND_IN_URL}}"] = sIn;
-	m["{{SOUND_OUT_URL}}"] = sOut;
-	m["{{BG_COLOR}}"] = c.primary_color;
-	m["{{TEXT_COLOR}}"] = c.title_color;
-	return m;
-}
-
-static std::string replace_placeholders(std::string s, const slt_repl_map &m)
-{
-	std::vector<std::pair<std::string, std::string>> kv;
-	kv.reserve(m.size());
-	for (const auto &it : m)
-		kv.emplace_back(it.first, it.second);
-	std::sort(kv.begin(), kv.end(), [](const auto &a, const auto &b) { return a.first.size() > b.first.size(); });
-	for (const auto &it : kv)
-		s = replace_all(s, it.first, it.second);
-	return s;
+// The profile picture file the overlay loads: the original until its variant scaled to the avatar
+// size is written (avatar_assets.hpp), which then requests a rebuild.
+static std::string rendered_profile_picture(const lower_third_cfg &c)
+{
+	return avatar::rendered_file(output_dir(), c.profile_picture, c.avatar_width, c.avatar_height);
+}
+
+// `picture` is rendered_profile_picture(c), resolved once by the caller.
+static tpl::values build_placeholder_values(const lower_third_cfg &c, const std::string &picture)
+{
+	using tpl::slot;
+	tpl::values v;
+	auto set = [&v](slot s, std::string val) { v[(size_t)s] = std::move(val); };
+
+	set(slot::Id, c.id);
+	set(slot::PrimaryColor, c.primary_color);
+	set(slot::SecondaryColor, c.secondary_color);
+	set(slot::TitleColor, c.title_color);
+	set(slot::SubtitleColor, c.subtitle_color);
+	set(slot::Title, c.title);
+	set(slot::Subtitle, c.subtitle);
+	set(slot::Opacity, std::to_string(c.opacity));
+	set(slot::Radius, std::to_string(c.radius));
+	set(slot::FontFamily, c.font_family.empty() ? "Inter" : c.font_family);
+	set(slot::TitleSize, std::to_string(c.title_size));
+	set(slot::SubtitleSize, std::to_string(c.subtitle_size));
+	set(slot::AvatarWidth, std::to_string(c.avatar_width));
+	set(slot::AvatarHeight, std::to_string(c.avatar_height));
+	set(slot::AnimIn, c.anim_in);
+	set(slot::AnimOut, c.anim_out);
+	set(slot::ProfilePictureUrl, picture.empty() ? "./" : ("./" + picture));
+	set(slot::SoundInUrl, c.anim_in_sound.empty() ? "" : ("./" + c.anim_in_sound));
+	set(slot::SoundOutUrl, c.anim_out_sound.empty() ? "" : ("./" + c.anim_out_sound));
+	set(slot::BgColor, c.primary_color);
+	set(slot::TextColor, c.title_color);
+	return v;
 }
 
 static std::string build_shared_css()
@@ -651,101 +659,73 @@ html,body{ margin:0; padding:0; background:transparent; overflow:hidden; }
 )CSS";
 }
 
-static std::string scope_css_best_effort(const lower_third_cfg &c)
+// Per-item animation config as a JSON object; it is both a valid entry of the animMap literal in
+// lt.js and the "anim" member of an lt-patch.json item.
+static std::string build_anim_cfg_json(const lower_third_cfg &c)
 {
-	std::string css = c.css_template;
-
-	const auto repl = build_placeholder_map(c);
-	css = replace_placeholders(std::move(css), repl);
-
-	if (css.find("#" + c.id) != std::string::npos) {
-		return "/* ---- " + c.id + " ---- */\n" + css + "\n";
-	}
-
-	std::stringstream in(css);
-	std::string line;
-	std::string out;
-	out += "/* ---- " + c.id + " ---- */\n";
-
-	while (std::getline(in, line)) {
-		std::string trimmed = line;
-		trimmed.erase(trimmed.begin(), std::find_if(trimmed.begin(), trimmed.end(),
-							    [](unsigned char ch) { return !std::isspace(ch); }));
-
-		const bool isAt = (!trimmed.empty() && trimmed[0] == '@');
-		if (!isAt && line.find('{') != std::string::npos) {
-			const auto pos = line.find('{');
-			std::string sel = line.substr(0, pos);
-			std::string rest = line.substr(pos);
-
-			std::stringstream ss(sel);
-			std::string part;
-			std::string newSel;
-			bool first = true;
-			while (std::getline(ss, part, ',')) {
-				if (part.find("#" + c.id) == std::string::npos)
-					part = " #" + c.id + " " + part;
-				if (!first)
-					newSel += ",";
-				newSel += part;
-				first = false;
-			}
-			out += newSel + rest + "\n";
-		} else {
-			out += line + "\n";
-		}
-	}
+	const bool inCustom = (c.anim_in == "custom_handled_in");
+	const bool outCustom = (c.anim_out == "custom_handled_out");
+
+	const std::string inCls = inCustom ? std::string() : c.anim_in;
+	const std::string outCls = outCustom ? std::string() : c.anim_out;
+
+	const std::string inSound = c.anim_in_sound.empty() ? std::string() : ("./" + c.anim_in_sound);
+	const std::string outSound = c.anim_out_sound.empty() ? std::string() : ("./" + c.anim_out_sound);
+
+	int delay = 0;
+
+	return "{ "
+	       "\"inCustom\": " +
+	       std::string(inCustom ? "true" : "false") +
+	       ", "
+	       "\"outCustom\": " +
+	       std::string(outCustom ? "true" : "false") +
+	       ", "
+	       "\"inCls\": " +
+	       (inCls.empty() ? "null" : ("\"" + inCls + "\"")) +
+	       ", "
+	       "\"outCls\": " +
+	       (outCls.empty() ? "null" : ("\"" + outCls + "\"")) +
+	       ", "
+	       "\"inSound\": " +
+	       (inSound.empty() ? "null" : ("\"" + inSound + "\"")) +
+	       ", "
+	       "\"outSound\": " +
+	       (outSound.empty() ? "null" : ("\"" + outSound + "\"")) +
+	       ", "
+	       "\"delay\": " +
+	       std::to_string(delay) + " }";
+}
 
-	return out;
+// animJson: build_anim_cfg_json() output for the item.
+static std::string build_anim_map_entry(const lower_third_cfg &c, const std::string &animJson)
+{
+	return "  \"" + c.id + "\": " + animJson + ",\n";
 }
 
-static std::string build_base_script(const std::vector<lower_third_cfg> &items)
+// mapEntries: concatenated build_anim_map_entry() output for every item, in list order.
+static std::string build_anim_map_script(const std::string &mapEntries)
 {
+	return "window.__sltAnimMap = {\n" + mapEntries + "};\n";
+}
 
-	std::string map = "{\n";
-	for (const auto &c : items) {
-		const bool inCustom = (c.anim_in == "custom_handled_in");
-		const bool outCustom = (c.anim_out == "custom_handled_out");
-
-		const std::string inCls = inCustom ? std::string() : c.anim_in;
-		const std::string outCls = outCustom ? std::string() : c.anim_out;
-
-		const std::string inSound = c.anim_in_sound.empty() ? std::string() : ("./" + c.anim_in_sound);
-		const std::string outSound = c.anim_out_sound.empty() ? std::string() : ("./" + c.anim_out_sound);
-
-		int delay = 0;
-
-		map += "  \"" + c.id +
-		       "\": { "
-		       "inCustom: " +
-		       std::string(inCustom ? "true" : "false") +
-		       ", "
-		       "outCustom: " +
-		       std::string(outCustom ? "true" : "false") +
-		       ", "
-		       "inCls: " +
-		       (inCls.empty() ? "null" : ("\"" + inCls + "\"")) +
-		       ", "
-		       "outCls: " +
-		       (outCls.empty() ? "null" : ("\"" + outCls + "\"")) +
-		       ", "
-		       "inSound: " +
-		       (inSound.empty() ? "null" : ("\"" + inSound + "\"")) +
-		       ", "
-		       "outSound: " +
-		       (outSound.empty() ? "null" : ("\"" + outSound + "\"")) +
-		       ", "
-		       "delay: " +
-		       std::to_string(delay) + " },\n";
-	}
-	map += "};\n";
-
-	return std::string(R"JS(
-/* Smart Lower Thirds – Base Animation Script (simple polling + per-item transition lock) */
+// The base script carries no per-item data (the animMap lives in window.__sltAnimMap), so it only
+// changes with the plugin itself. While it matches the loaded page, rebuilds are hot-patched.
+static const std::string &build_base_script()
+{
+	static const std::string script = R"JS(
+/* Smart Lower Thirds – Base Animation Script (push channel / polling fallback + per-item transition lock + hot patches) */
 (() => {
   const VISIBLE_URL = "./lt-visible.json";
-  const animMap = )JS") +
-	       map + std::string(R"JS(
+  const PATCH_URL = "./lt-patch.json";
+  const PUSH_URL = "./lt-push.json";
+  const PUSH_RETRY_MS = 3000;
+  const animMap = window.__sltAnimMap || (window.__sltAnimMap = {});
+  let pageBase = null;
+  let patchRev = 0;
+  let pushLive = false;       // push channel connected: polling is paused
+  let ackUrl = null;          // where transition acknowledgements are POSTed (lt-push.json "ack")
+  let wanted = new Set();     // ids that should be on air
   // Safety bounds (avoid deadlocks if a template forgets to resolve)
   const MAX_CUSTOM_WAIT_MS = 8000;
   const MAX_ANIM_WAIT_MS   = 2000;
@@ -895,7 +875,178 @@ static std::string build_base_script(const std::vector<lower_third_cfg> &items)
       .catch(() => {}); // never break the chain
   }
 
+  // Reports a transition phase ("start" | "end") for the command with sequence number seq
+  // (0 = whichever command is latest for the item). Used for the core's latency histograms.
+  function ack(id, seq, phase) {
+    if (!ackUrl) return;
+    try {
+      fetch(ackUrl, {
+        method: "POST",
+        mode: "no-cors",
+        headers: { "Content-Type": "text/plain" },
+        body: JSON.stringify({ id: id, seq: seq, phase: phase })
+      }).catch(() => {});
+    } catch (e) {}
+  }
+
+  function applyWant(el, want) {
+    const cfg = animMap[el.id] || {};
+
+    // Store desired state
+    el.dataset.want = want ? "1" : "0";
+
+    const isMounted = el.classList.contains("slt-visible") || el.style.display === "block";
+
+    // Already in desired mounted state
+    if (want && isMounted) return;
+    if (!want && !isMounted) return;
+
+    // Avoid enqueuing duplicates while one is active
+    if (el.dataset.busy === "1") return;
+
+    el.dataset.busy = "1";
+    enqueue(el, async () => {
+      try {
+        // Re-check desire at execution time (it may have changed meanwhile)
+        const stillWant = el.dataset.want === "1";
+        const seq = Number(el.dataset.sltSeq || 0);
+        ack(el.id, seq, "start");
+        if (stillWant) await doShow(el, cfg);
+        else await doHide(el, cfg);
+        ack(el.id, seq, "end");
+      } finally {
+        el.dataset.busy = "0";
+      }
+      // A change that arrived mid-transition has no later poll to pick it up when pushed.
+      applyWant(el, el.dataset.want === "1");
+    });
+  }
+
+  function applyVisible(ids) {
+    wanted = new Set(ids.map(String));
+    const els = Array.from(document.querySelectorAll("#slt-root > li[id]"));
+    for (const el of els) {
+      delete el.dataset.sltSeq; // full state carries no command; acks match the latest one
+      applyWant(el, wanted.has(el.id));
+    }
+  }
+
+  // Push deltas only touch the <li> elements they name.
+  function applyDelta(d) {
+    const seq = String(d.seq || 0);
+    for (const id of (d.show || [])) {
+      wanted.add(String(id));
+      const el = itemEl(String(id));
+      if (el) { el.dataset.sltSeq = seq; applyWant(el, true); }
+    }
+    for (const id of (d.hide || [])) {
+      wanted.delete(String(id));
+      const el = itemEl(String(id));
+      if (el) { el.dataset.sltSeq = seq; applyWant(el, false); }
+    }
+  }
+
+  // ---- Hot patches (lt-patch.json) ----
+  // A patch is cumulative against the page this document was loaded from (data-slt-base), so applying
+  // the latest one is enough; items whose data-slt-hash already matches are left alone.
+
+  function rootEl() { return document.getElementById("slt-root"); }
+
+  function itemEl(id) {
+    const el = document.getElementById(id);
+    return (el && el.parentNode === rootEl()) ? el : null;
+  }
+
+  function runItemScript(js) {
+    if (!js) return;
+    const s = document.createElement("script");
+    s.textContent = js;
+    document.body.appendChild(s);
+    s.remove();
+  }
+
+  function swapStylesheet(href) {
+    const cur = document.querySelector("[data-slt-css]"); // <link>, or <style> on single-file pages
+    if (!href || (cur && cur.getAttribute("href") === href)) return;
+    const next = document.createElement("link");
+    next.rel = "stylesheet";
+    next.href = href;
+    next.setAttribute("data-slt-css", "");
+    // Keep the old sheet until the new one is parsed so on-air items never render unstyled.
+    next.onload = next.onerror = () => { if (cur && cur !== next) cur.remove(); };
+    document.head.appendChild(next);
+  }
+
+  function mountPatchedItem(old, it) {
+    const tpl = document.createElement("template");
+    tpl.innerHTML = String(it.html || "").trim();
+    const el = tpl.content.firstElementChild;
+    if (!el) return null;
+
+    if (old) {
+      // Changed while on air: swap in place and stay mounted, without replaying the in-animation.
+      const onAir = old.classList.contains("slt-visible") || old.style.display === "block";
+      if (onAir) setMounted(el, true);
+      el.dataset.want = old.dataset.want || "0";
+      old.replaceWith(el);
+    } else {
+      rootEl().appendChild(el);
+    }
+    return el;
+  }
+
+  function applyPatch(p) {
+    for (const id of (p.removed || [])) {
+      const el = itemEl(id);
+      if (el) el.remove();
+      delete animMap[id];
+    }
+
+    swapStylesheet(p.css);
+
+    const items = p.items || {};
+    for (const id of Object.keys(items)) {
+      const it = items[id] || {};
+      const old = itemEl(id);
+      if (old && old.dataset.sltHash === it.hash) continue;
+
+      animMap[id] = it.anim || {};
+      const el = mountPatchedItem(old, it);
+      if (!el) continue;
+      runItemScript(it.js);
+      if (!old) applyWant(el, wanted.has(id));
+    }
+
+    const root = rootEl();
+    let prev = null;
+    for (const id of (p.order || [])) {
+      const el = itemEl(id);
+      if (!el) continue;
+      const at = prev ? prev.nextElementSibling : root.firstElementChild;
+      if (el !== at) root.insertBefore(el, at);
+      prev = el;
+    }
+  }
+
+  async function checkPatch() {
+    let p;
+    try {
+      const r = await fetch(PATCH_URL + "?t=" + Date.now(), { cache: "no-store" });
+      p = await r.json();
+    } catch (e) {
+      return;
+    }
+    if (!p || p.base !== pageBase || !(p.rev > patchRev)) return;
+
+    patchRev = p.rev;
+    try { applyPatch(p); } catch (e) { console.error("SLT patch failed", e); }
+  }
+
   async function tick() {
+    if (pushLive) return;
+
+    await checkPatch();
+
     let visibleIds;
     try {
       const r = await fetch(VISIBLE_URL + "?t=" + Date.now(), { cache: "no-store" });
@@ -905,53 +1056,62 @@ static std::string build_base_script(const std::vector<lower_third_cfg> &items)
       return;
     }
 
-    const visibleSet = new Set(visibleIds.map(String));
-    const els = Array.from(document.querySelectorAll("#slt-root > li[id]"));
+    applyVisible(visibleIds);
+  }
 
-    for (const el of els) {
-      const cfg = animMap[el.id] || {};
-      const want = visibleSet.has(el.id);
-
-      // Store desired state
-      el.dataset.want = want ? "1" : "0";
-
-      const isMounted = el.classList.contains("slt-visible") || el.style.display === "block";
-
-      // Already in desired mounted state
-      if (want && isMounted) continue;
-      if (!want && !isMounted) continue;
-
-      // Avoid enqueuing duplicates while one is active
-      if (el.dataset.busy === "1") continue;
-
-      el.dataset.busy = "1";
-      enqueue(el, async () => {
-        try {
-          // Re-check desire at execution time (poll may have changed)
-          const stillWant = el.dataset.want === "1";
-          if (stillWant) await doShow(el, cfg);
-          else await doHide(el, cfg);
-        } finally {
-          el.dataset.busy = "0";
-        }
-      });
+  // ---- Push channel (lt-push.json -> Server-Sent Events) ----
+  // While connected, visibility deltas and patch hints arrive as they happen and polling pauses;
+  // on any error the page falls back to polling and re-reads the endpoint (it may have moved).
+  async function connectPush() {
+    let url = null;
+    try {
+      const r = await fetch(PUSH_URL + "?t=" + Date.now(), { cache: "no-store" });
+      const cfg = await r.json();
+      url = cfg && cfg.url;
+      ackUrl = (cfg && cfg.ack) || null;
+    } catch (e) {}
+
+    if (!url || typeof EventSource !== "function") {
+      setTimeout(connectPush, PUSH_RETRY_MS * 5);
+      return;
     }
+
+    const es = new EventSource(url);
+    const onData = (fn) => (ev) => {
+      let d;
+      try { d = JSON.parse(ev.data || "{}"); } catch (e) { return; }
+      fn(d);
+    };
+
+    es.addEventListener("snapshot", onData((d) => {
+      pushLive = true;
+      applyVisible(Array.isArray(d.visible) ? d.visible : []);
+      checkPatch();
+    }));
+    es.addEventListener("visibility", onData(applyDelta));
+    es.addEventListener("patch", () => { checkPatch(); });
+    es.onerror = () => {
+      pushLive = false;
+      es.close();
+      setTimeout(connectPush, PUSH_RETRY_MS);
+    };
   }
 
   document.addEventListener("DOMContentLoaded", () => {
+    const root = rootEl();
+    pageBase = root ? (root.dataset.sltBase || null) : null;
     tick();
     setInterval(tick, 350);
+    connectPush();
   });
 })();
-)JS");
+)JS";
+	return script;
 }
 
-static std::string build_item_script(const lower_third_cfg &c)
+// js: the item script with placeholders already rendered.
+static std::string build_item_script(const lower_third_cfg &c, const std::string &js)
 {
-	std::string js = c.js_template;
-	const auto repl = build_placeholder_map(c);
-	js = replace_placeholders(std::move(js), repl);
-
 	std::string out;
 	out += "\n/* ---- " + c.id + " ---- */\n";
 	out += "(() => {\n";
@@ -964,78 +1124,142 @@ static std::string build_item_script(const lower_third_cfg &c)
 	return out;
 }
 
-static std::string build_full_html(const std::string &ts, const std::string &cssFile, const std::string &jsFile)
+// inner: the item HTML template with placeholders already rendered.
+// hashHex: the item's content hash, used by hot patches to skip unchanged items.
+static std::string build_item_html(const lower_third_cfg &c, const std::string &hashHex, std::string inner)
 {
-	std::string html;
-	html += "<!doctype html>\n<html>\n<head>\n<meta charset=\"utf-8\"/>\n";
-	html += "<meta name=\"viewport\" content=\"width=device-width, initial-scale=1\"/>\n";
-	html += "<link rel=\"stylesheet\" href=\"./" + cssFile + "?v=" + ts + "\"/>\n";
-
-	const std::string animateLocalAbs = path_animate_css();
-	if (!animateLocalAbs.empty() && file_exists(animateLocalAbs)) {
-		LOGI("Using local animate.min.css");
-		html += "<link rel=\"stylesheet\" href=\"./animate.min.css\"/>\n";
-	} else {
-		LOGI("Using CDN animate.css (local animate.min.css not found)");
-		html += "<link rel=\"stylesheet\" href=\"https://cdnjs.cloudflare.com/ajax/libs/animate.css/4.1.1/animate.min.css\"/>\n";
+	if (inner.find("onerror") == std::string::npos) {
+		inner = replace_all(inner, "<img ", "<img onerror=\"this.style.display='none'\" ");
 	}
 
-	html += "</head>\n<body>\n<ul id=\"slt-root\">\n";
-
-	for (const auto &c : g_items) {
-		std::string inner = c.html_template;
-		const auto repl = build_placeholder_map(c);
-		inner = replace_placeholders(std::move(inner), repl);
+	const bool customMode = (c.anim_in == "custom_handled_in") || (c.anim_out == "custom_handled_out");
 
-		if (inner.find("onerror") == std::string::npos) {
-			inner = replace_all(inner, "<img ", "<img onerror=\"this.style.display='none'\" ");
-		}
+	std::string html;
+	html += "  <li id=\"" + c.id + "\" class=\"" + c.lt_position + "\" data-slt-hash=\"" + hashHex + "\"" +
+		(customMode ? " data-slt-mode=\"custom\"" : "") + ">";
+	html += inner;
+	html += "</li>\n";
+	return html;
+}
 
-		const bool customMode = (c.anim_in == "custom_handled_in") || (c.anim_out == "custom_handled_out");
+// Stylesheet tags for the head and the script tag closing the body of a page that links its files.
+// cssHref/jsHref point at content-named files, so the HTML of an unchanged bundle is byte-identical
+// across rebuilds.
+static void linked_asset_tags(const std::string &cssHref, const std::string &jsHref, std::string &head,
+			      std::string &tail)
+{
+	head = "<link rel=\"stylesheet\" href=\"" + cssHref + "\" data-slt-css/>\n";
+	tail = "<script defer src=\"" + jsHref + "\"></script>\n";
+}
 
-		html += "  <li id=\"" + c.id + "\" class=\"" + c.lt_position + "\"" +
-			(customMode ? " data-slt-mode=\"custom\"" : "") + ">";
-		html += inner;
-		html += "</li>\n";
+// Breaks up "</tag" inside embedded text so it cannot close the element early ("<\/" means the same
+// in JS strings/regexes and in CSS).
+static std::string escape_raw_text(std::string text, const std::string &tag)
+{
+	for (size_t p = text.find("</"); p != std::string::npos; p = text.find("</", p + 2)) {
+		size_t i = 0;
+		while (i < tag.size() && p + 2 + i < text.size() &&
+		       std::tolower((unsigned char)text[p + 2 + i]) == tag[i])
+			++i;
+		if (i == tag.size())
+			text.insert(p + 1, 1, '\\');
 	}
+	return text;
+}
 
-	html += "</ul>\n<script defer src=\"./" + jsFile + "?v=" + ts + "\"></script>\n</body>\n</html>\n";
+// Single-file pages embed the stylesheet and the script, so a swap costs one file read.
+static void inline_asset_tags(const std::string &css, const std::string &js, std::string &head, std::string &tail)
+{
+	head = "<style data-slt-css>" + escape_raw_text(css, "style") + "</style>\n";
+	tail = "<script>" + escape_raw_text(js, "script") + "</script>\n";
+}
+
+// itemsHtml: concatenated build_item_html() output for every item, in list order.
+// baseId identifies the page for lt-patch.json; head/tail come from linked_asset_tags() or
+// inline_asset_tags().
+static std::string build_full_html(const std::string &baseId, const std::string &head, const std::string &tail,
+				   const std::string &itemsHtml)
+{
+	std::string html;
+	html += "<!doctype html>\n<html>\n<head>\n<meta charset=\"utf-8\"/>\n";
+	html += "<meta name=\"viewport\" content=\"width=device-width, initial-scale=1\"/>\n";
+	html += head;
+	html += "</head>\n<body>\n<ul id=\"slt-root\" data-slt-base=\"" + baseId + "\">\n";
+	html += itemsHtml;
+	html += "</ul>\n" + tail + "</body>\n</html>\n";
 	return html;
 }
 
 bool has_output_dir()
 {
+	std::lock_guard<std::mutex> lk(g_output_dir_mx);
 	return !g_output_dir.empty();
 }
 
 std::string output_dir()
 {
+	std::lock_guard<std::mutex> lk(g_output_dir_mx);
 	return g_output_dir;
 }
 
-std::string path_state_json()
+static std::string output_path(const std::string &name)
 {
-	return has_output_dir() ? join_path(g_output_dir, "lt-state.json") : "";
+	const std::string dir = output_dir();
+	return dir.empty() ? std::string() : join_path(dir, name);
 }
 
-std::string path_visible_json()
+// A bare file name: joined to the output dir, it cannot point anywhere else.
+static bool is_plain_file_name(const std::string &name)
+{
+	if (name.empty() || name == "." || name == "..")
+		return false;
+	return name.find_first_of(std::string("/\\:\0", 4)) == std::string::npos;
+}
+
+// Output-dir path of an asset named in item state; empty unless `name` is a plain file name. Item
+// fields come from clients and hand-edited lt-state.json, and these paths are copied and deleted.
+static std::string asset_path(const std::string &name)
+{
+	return is_plain_file_name(name) ? output_path(name) : std::string();
+}
+
+std::string import_profile_picture(const std::string &srcPath)
 {
-	return has_output_dir() ? join_path(g_output_dir, "lt-visible.json") : "";
+	const QFileInfo src(QString::fromStdString(srcPath));
+	if (!has_output_dir() || !src.isFile())
+		return std::string();
+
+	std::string name = new_id() + "_" + now_timestamp_string();
+	const std::string ext = src.suffix().toLower().toStdString();
+	if (!ext.empty())
+		name += "." + ext;
+
+	const std::string dst = output_path(name);
+	if (!QFile::copy(src.absoluteFilePath(), QString::fromStdString(dst))) {
+		LOGW("Failed to copy profile picture '%s' -> '%s'", srcPath.c_str(), dst.c_str());
+		return std::string();
+	}
+	return name;
+}
+
+std::string path_state_json()
+{
+	return output_path("lt-state.json");
 }
 
-std::string path_styles_css()
+std::string path_visible_json()
 {
-	return has_output_dir() ? join_path(g_output_dir, "lt.css") : "";
+	return output_path("lt-visible.json");
 }
 
-std::string path_scripts_js()
+std::string path_patch_json()
 {
-	return has_output_dir() ? join_path(g_output_dir, "lt.js") : "";
+	return output_path("lt-patch.json");
 }
 
-std::string path_animate_css()
+std::string path_push_json()
 {
-	return has_output_dir() ? join_path(g_output_dir, "animate.min.css") : "";
+	return output_path("lt-push.json");
 }
 
 std::string now_timestamp_string()
@@ -1056,164 +1280,845 @@ std::string new_id()
 	return sanitize_id(ss.str());
 }
 
-std::vector<lower_third_cfg> &all()
+const std::vector<lower_third_cfg> &all_const()
 {
 	return g_items;
 }
 
-const std::vector<lower_third_cfg> &all_const()
+// -------------------------
+// State indexes
+// -------------------------
+// Kept in step with g_items / g_groups / g_visible by every mutation path in this file, so lookups on
+// hot paths (dock timers, websocket requests) are O(1). Bulk loads rebuild them; CRUD paths patch them.
+static std::unordered_map<std::string, size_t> g_item_slot;  // item id -> index in g_items
+static std::unordered_map<std::string, size_t> g_group_slot; // group id -> index in g_groups
+static std::unordered_map<std::string, std::vector<std::string>> g_member_groups; // item id -> group ids
+static std::unordered_set<std::string> g_visible_set;
+
+static std::vector<visibility_preset> g_presets; // persisted with the items in lt-state.json
+
+static bool item_less(const lower_third_cfg &a, const lower_third_cfg &b)
 {
-	return g_items;
+	if (a.order != b.order)
+		return a.order < b.order;
+	return a.id < b.id;
 }
 
-lower_third_cfg *get_by_id(const std::string &id)
+static bool group_less(const group_cfg &a, const group_cfg &b)
 {
-	for (auto &c : g_items)
-		if (c.id == id)
-			return &c;
-	return nullptr;
+	if (a.order != b.order)
+		return a.order < b.order;
+	return a.id < b.id;
 }
 
-std::vector<group_cfg> &groups()
+static void reindex_items(size_t from = 0)
 {
-	return g_groups;
+	g_items_dirty = true;
+	if (from == 0) {
+		g_item_slot.clear();
+		g_item_slot.reserve(g_items.size() * 2 + 1);
+	}
+	for (size_t i = from; i < g_items.size(); ++i)
+		g_item_slot[g_items[i].id] = i;
 }
 
-const std::vector<group_cfg> &groups_const()
+static void reindex_groups(size_t from = 0)
 {
-	return g_groups;
+	g_groups_dirty = true;
+	if (from == 0) {
+		g_group_slot.clear();
+		g_group_slot.reserve(g_groups.size() * 2 + 1);
+	}
+	for (size_t i = from; i < g_groups.size(); ++i)
+		g_group_slot[g_groups[i].id] = i;
 }
 
-group_cfg *get_group_by_id(const std::string &id)
+static void index_group_members(const group_cfg &g)
 {
-	const std::string sid = sanitize_id(id);
-	for (auto &c : g_groups) {
-		if (c.id == sid)
-			return &c;
+	for (const auto &mid : g.members) {
+		auto &owners = g_member_groups[mid];
+		if (std::find(owners.begin(), owners.end(), g.id) == owners.end())
+			owners.push_back(g.id);
 	}
-	return nullptr;
 }
 
-std::vector<std::string> groups_containing(const std::string &lower_third_id)
+static void unindex_group_members(const group_cfg &g)
 {
-	std::vector<std::string> out;
-	const std::string sid = sanitize_id(lower_third_id);
-	for (const auto &c : g_groups) {
-		for (const auto &mid : c.members) {
-			if (mid == sid) {
-				out.push_back(c.id);
-				break;
-			}
-		}
+	for (const auto &mid : g.members) {
+		auto it = g_member_groups.find(mid);
+		if (it == g_member_groups.end())
+			continue;
+		auto &owners = it->second;
+		owners.erase(std::remove(owners.begin(), owners.end(), g.id), owners.end());
+		if (owners.empty())
+			g_member_groups.erase(it);
 	}
-	return out;
 }
 
-std::vector<std::string> visible_ids()
+static void reindex_members()
 {
-	return g_visible;
+	g_groups_dirty = true;
+	g_member_groups.clear();
+	for (const auto &g : g_groups)
+		index_group_members(g);
 }
 
-bool is_visible(const std::string &id)
+static void clear_items_and_groups()
 {
-	return std::find(g_visible.begin(), g_visible.end(), id) != g_visible.end();
+	g_items.clear();
+	g_groups.clear();
+	g_presets.clear();
+	reindex_items();
+	reindex_groups();
+	reindex_members();
 }
 
-void set_visible_nosave(const std::string &id, bool visible)
+static void clear_visible()
 {
-	if (id.empty())
-		return;
+	g_visible.clear();
+	g_visible_set.clear();
+	g_visible_snapshot.reset();
+}
 
-	if (visible) {
-		if (!is_visible(id))
-			g_visible.push_back(id);
-	} else {
-		g_visible.erase(std::remove(g_visible.begin(), g_visible.end(), id), g_visible.end());
-	}
+// Immutable copy of g_visible, made at most once per change and shared by all events until then.
+static id_list_ref visible_snapshot()
+{
+	if (!g_visible_snapshot)
+		g_visible_snapshot = std::make_shared<const std::vector<std::string>>(g_visible);
+	return g_visible_snapshot;
 }
 
-void toggle_visible_nosave(const std::string &id)
+// Inserts keeping g_items sorted by (order, id); only the slots from the insertion point shift.
+static void insert_item_sorted(const lower_third_cfg &c)
 {
-	set_visible_nosave(id, !is_visible(id));
+	const auto pos = std::upper_bound(g_items.begin(), g_items.end(), c, item_less);
+	const size_t at = (size_t)(pos - g_items.begin());
+	g_items.insert(pos, c);
+	reindex_items(at);
 }
 
-bool set_visible_persist(const std::string &id, bool visible)
+static void insert_group_sorted(const group_cfg &c)
 {
-	if (!has_output_dir() || id.empty())
-		return false;
+	const auto pos = std::upper_bound(g_groups.begin(), g_groups.end(), c, group_less);
+	const size_t at = (size_t)(pos - g_groups.begin());
+	g_groups.insert(pos, c);
+	reindex_groups(at);
+	index_group_members(c);
+}
 
-	if (!get_by_id(id))
-		return false;
+// Mutable lookups for the commands below; they mark the list for the next publish.
+static lower_third_cfg *get_by_id(const std::string &id)
+{
+	auto it = g_item_slot.find(id);
+	if (it == g_item_slot.end())
+		return nullptr;
+	g_items_dirty = true;
+	return &g_items[it->second];
+}
 
-	const bool before = is_visible(id);
-	if (before == visible) {
-		return true;
+const lower_third_cfg *get_by_id_const(const std::string &id)
+{
+	auto it = g_item_slot.find(id);
+	return it == g_item_slot.end() ? nullptr : &g_items[it->second];
+}
+
+const std::vector<group_cfg> &groups_const()
+{
+	return g_groups;
+}
+
+// Stored ids are already sanitized, so the raw id is tried first and only sanitized on a miss.
+template<typename Map> static typename Map::const_iterator find_sanitized(const Map &m, const std::string &id)
+{
+	auto it = m.find(id);
+	if (it != m.end() || id.empty())
+		return it;
+	const std::string sid = sanitize_id(id);
+	return sid == id ? m.end() : m.find(sid);
+}
+
+static group_cfg *get_group_by_id(const std::string &id)
+{
+	auto it = find_sanitized(g_group_slot, id);
+	if (it == g_group_slot.end())
+		return nullptr;
+	g_groups_dirty = true;
+	return &g_groups[it->second];
+}
+
+const group_cfg *get_group_by_id_const(const std::string &id)
+{
+	auto it = find_sanitized(g_group_slot, id);
+	return it == g_group_slot.end() ? nullptr : &g_groups[it->second];
+}
+
+std::vector<std::string> groups_containing(const std::string &lower_third_id)
+{
+	auto it = find_sanitized(g_member_groups, lower_third_id);
+	if (it == g_member_groups.end())
+		return {};
+
+	std::vector<std::string> out = it->second;
+	if (out.size() > 1) {
+		// Callers rely on g_groups order (e.g. owners.front() picks the dock color).
+		std::sort(out.begin(), out.end(), [](const std::string &a, const std::string &b) {
+			return g_group_slot[a] < g_group_slot[b];
+		});
 	}
+	return out;
+}
 
-	std::vector<std::string> hidden;
-
-	// Group-level exclusive mode: if this item belongs to a group with exclusive enabled,
-	// hide any other currently-visible members in the same group before showing it.
-	if (visible && !before) {
-		const auto owners = groups_containing(id);
-		if (!owners.empty()) {
-			group_cfg *g = get_group_by_id(owners.front());
-			if (g && g->exclusive) {
-				std::unordered_set<std::string> memberSet;
-				memberSet.reserve(g->members.size() * 2 + 1);
-				for (const auto &m : g->members)
-					memberSet.insert(m);
-
-				for (const auto &vid : g_visible) {
-					if (vid == id)
-						continue;
-					if (memberSet.find(vid) != memberSet.end())
-						hidden.push_back(vid);
-				}
-			}
+std::vector<std::string> visible_ids()
+{
+	return g_visible;
+}
+
+bool is_visible(const std::string &id)
+{
+	return g_visible_set.find(id) != g_visible_set.end();
+}
+
+// -------------------------
+// Read snapshots
+// -------------------------
+// Published by the owner thread only; other threads just load it. Parts that did not change since
+// the previous snapshot are shared, so a visibility command copies the id list and nothing else.
+// g_state_mx only covers copying the pointer (std::atomic<std::shared_ptr> is missing from libc++).
+static std::mutex g_state_mx;
+static state_ref g_state;
+
+static state_ref load_published_state()
+{
+	std::lock_guard<std::mutex> lk(g_state_mx);
+	return g_state;
+}
+
+static void store_published_state(state_ref s)
+{
+	std::lock_guard<std::mutex> lk(g_state_mx);
+	g_state = std::move(s);
+}
+static uint64_t g_state_version = 0;
+
+// Change log: fixed-size ring of the most recent changes. g_log_floor is the oldest revision a client
+// can still diff from; anything older has (partly) been overwritten. Guarded by g_log_mx, which is also
+// held while a snapshot is stored so readers see the log and the snapshot in step.
+static constexpr size_t kChangeLogCapacity = 1024;
+static std::mutex g_log_mx;
+static std::vector<state_change> g_log;
+static size_t g_log_head = 0; // next slot to write once the ring is full
+static uint64_t g_log_floor = 0;
+
+const lower_third_cfg *state_snapshot::find(const std::string &id) const
+{
+	if (!item_slot)
+		return nullptr;
+	auto it = item_slot->find(id);
+	return it == item_slot->end() ? nullptr : &(*items)[it->second];
+}
+
+bool state_snapshot::is_visible(const std::string &id) const
+{
+	return visible && std::find(visible->begin(), visible->end(), id) != visible->end();
+}
+
+template<typename T>
+static void diff_records(const std::vector<T> &prev, const std::vector<T> &next, uint64_t rev,
+			 state_change_kind upserted, state_change_kind removed, std::vector<state_change> &out)
+{
+	std::unordered_map<std::string, const T *> before;
+	before.reserve(prev.size() * 2 + 1);
+	for (const auto &r : prev)
+		before.emplace(r.id, &r);
+	for (const auto &r : next) {
+		auto it = before.find(r.id);
+		if (it == before.end() || !(*it->second == r))
+			out.push_back(state_change{rev, upserted, r.id});
+		if (it != before.end())
+			before.erase(it);
+	}
+	for (const auto &r : prev) {
+		if (before.count(r.id))
+			out.push_back(state_change{rev, removed, r.id});
+	}
+}
+
+static void diff_visible(const std::vector<std::string> &prev, const std::vector<std::string> &next, uint64_t rev,
+			 std::vector<state_change> &out)
+{
+	const std::unordered_set<std::string> a(prev.begin(), prev.end());
+	const std::unordered_set<std::string> b(next.begin(), next.end());
+	for (const auto &id : next)
+		if (!a.count(id))
+			out.push_back(state_change{rev, state_change_kind::Visibility, id});
+	for (const auto &id : prev)
+		if (!b.count(id))
+			out.push_back(state_change{rev, state_change_kind::Visibility, id});
+}
+
+static void append_changes(const std::vector<state_change> &changes)
+{
+	for (const auto &c : changes) {
+		if (g_log.size() < kChangeLogCapacity) {
+			g_log.push_back(c);
+			continue;
 		}
+		g_log_floor = std::max(g_log_floor, g_log[g_log_head].revision);
+		g_log[g_log_head] = c;
+		g_log_head = (g_log_head + 1) % kChangeLogCapacity;
 	}
+}
 
-	for (const auto &hid : hidden)
-		set_visible_nosave(hid, false);
+static state_ref publish_state()
+{
+	state_ref cur = load_published_state();
+	id_list_ref vis = visible_snapshot();
+	if (cur && !g_items_dirty && !g_groups_dirty && cur->visible == vis)
+		return cur;
+
+	auto next = std::make_shared<state_snapshot>();
+	next->version = g_state_version + 1;
+	if (cur && !g_items_dirty) {
+		next->items = cur->items;
+		next->item_slot = cur->item_slot;
+	} else {
+		next->items = std::make_shared<const std::vector<lower_third_cfg>>(g_items);
+		next->item_slot = std::make_shared<const std::unordered_map<std::string, size_t>>(g_item_slot);
+	}
+	next->groups = (cur && !g_groups_dirty) ? cur->groups : std::make_shared<const std::vector<group_cfg>>(g_groups);
+	next->visible = std::move(vis);
+
+	g_items_dirty = false;
+	g_groups_dirty = false;
+
+	std::vector<state_change> changes;
+	if (cur) {
+		if (next->items != cur->items)
+			diff_records(*cur->items, *next->items, next->version, state_change_kind::ItemUpserted,
+				     state_change_kind::ItemRemoved, changes);
+		if (next->groups != cur->groups)
+			diff_records(*cur->groups, *next->groups, next->version, state_change_kind::GroupUpserted,
+				     state_change_kind::GroupRemoved, changes);
+		if (next->visible != cur->visible)
+			diff_visible(*cur->visible, *next->visible, next->version, changes);
+
+		// Marked dirty but nothing actually differs (e.g. a mutator reloaded lt-state.json): keep the
+		// current revision so pollers are not told to refetch.
+		if (changes.empty())
+			return cur;
+	}
 
-	set_visible_nosave(id, visible);
-	if (!save_visible_json())
-		return false;
+	g_state_version = next->version;
+	state_ref out = next;
+	std::lock_guard<std::mutex> lk(g_log_mx);
+	if (!cur)
+		g_log_floor = out->version; // nothing before the first snapshot can be diffed
+	append_changes(changes);
+	store_published_state(out);
+	return out;
+}
 
-	// Emit per-id events so the dock stays consistent.
-	const auto visNow = visible_ids();
-	for (const auto &hid : hidden) {
-		core_event ev;
-		ev.type = event_type::VisibilityChanged;
-		ev.id = hid;
-		ev.visible = false;
-		ev.visible_ids = visNow;
-		emit_event(ev);
+state_ref snapshot()
+{
+	if (cmd::on_owner_thread())
+		return publish_state();
+
+	state_ref cur = load_published_state();
+	if (cur)
+		return cur;
+
+	// Nothing published yet (called before init_from_disk): an empty state.
+	static const state_ref empty = [] {
+		auto e = std::make_shared<state_snapshot>();
+		e->items = std::make_shared<const std::vector<lower_third_cfg>>();
+		e->item_slot = std::make_shared<const std::unordered_map<std::string, size_t>>();
+		e->groups = std::make_shared<const std::vector<group_cfg>>();
+		e->visible = std::make_shared<const std::vector<std::string>>();
+		return state_ref(e);
+	}();
+	return empty;
+}
+
+uint64_t state_epoch()
+{
+	static const uint64_t epoch = []() {
+		std::random_device rd;
+		return ((uint64_t)rd() << 32) ^ (uint64_t)rd();
+	}();
+	return epoch;
+}
+
+state_delta changes_since(uint64_t revision)
+{
+	if (cmd::on_owner_thread())
+		publish_state();
+
+	state_delta d;
+	std::lock_guard<std::mutex> lk(g_log_mx);
+	d.state = load_published_state();
+	if (!d.state) {
+		d.resync = true;
+		d.state = snapshot();
+		return d;
+	}
+	if (revision >= d.state->version) {
+		d.resync = revision > d.state->version; // a revision we never issued (e.g. before a restart)
+		return d;
+	}
+	if (revision < g_log_floor) {
+		d.resync = true;
+		return d;
+	}
+
+	// Oldest first: the ring starts at g_log_head once it has wrapped.
+	for (size_t i = 0; i < g_log.size(); ++i) {
+		const state_change &c = g_log[(g_log_head + i) % g_log.size()];
+		if (c.revision > revision)
+			d.changes.push_back(c);
+	}
+	return d;
+}
+
+// Every event goes out after the state it describes is published, so a listener that reads snapshot()
+// sees at least that version.
+static void emit_core_event(core_event ev)
+{
+	ev.state_version = publish_state()->version;
+	emit_event(ev);
+}
+
+void set_visible_nosave(const std::string &id, bool visible)
+{
+	if (id.empty())
+		return;
+
+	if (visible) {
+		if (g_visible_set.insert(id).second) {
+			g_visible.push_back(id);
+			g_visible_snapshot.reset();
+		}
+	} else if (g_visible_set.erase(id)) {
+		g_visible.erase(std::remove(g_visible.begin(), g_visible.end(), id), g_visible.end());
+		g_visible_snapshot.reset();
+	}
+}
+
+void toggle_visible_nosave(const std::string &id)
+{
+	set_visible_nosave(id, !is_visible(id));
+}
+
+// -------------------------
+// Visibility latency
+// -------------------------
+struct pending_visibility {
+	uint64_t seq = 0;
+	std::chrono::steady_clock::time_point issued;
+	bool started = false;
+};
+
+static std::mutex g_latency_mx;
+static uint64_t g_visibility_seq = 0;
+static std::unordered_map<std::string, pending_visibility> g_pending_visibility; // latest command per id
+static std::unordered_map<std::string, visibility_latency> g_visibility_latency;
+
+void latency_histogram::add(double ms)
+{
+	size_t b = 0;
+	while (b + 1 < bucket_count && ms >= (double)(2ULL << b))
+		b++;
+	buckets[b]++;
+	count++;
+	sum_ms += ms;
+	max_ms = std::max(max_ms, ms);
+}
+
+void latency_histogram::merge(const latency_histogram &o)
+{
+	for (size_t b = 0; b < bucket_count; ++b)
+		buckets[b] += o.buckets[b];
+	count += o.count;
+	sum_ms += o.sum_ms;
+	max_ms = std::max(max_ms, o.max_ms);
+}
+
+double latency_histogram::quantile_ms(double q) const
+{
+	if (count == 0)
+		return 0.0;
+
+	const double want = q * (double)count;
+	uint64_t seen = 0;
+	for (size_t b = 0; b < bucket_count; ++b) {
+		seen += buckets[b];
+		if ((double)seen >= want && buckets[b] > 0)
+			return std::min((double)(2ULL << b), max_ms);
+	}
+	return max_ms;
+}
+
+// When a visibility command started, taken before it does any work (file writes included) so the
+// latency it reports covers them.
+struct command_time {
+	int64_t ts_ms = (int64_t)QDateTime::currentMSecsSinceEpoch();
+	std::chrono::steady_clock::time_point issued = std::chrono::steady_clock::now();
+};
+
+// Stamps one visibility command (covering every id it changes) and starts its latency clock at `start`.
+static uint64_t begin_visibility_command(const std::vector<std::string> &ids, const command_time &start)
+{
+	std::lock_guard<std::mutex> lk(g_latency_mx);
+	const uint64_t seq = ++g_visibility_seq;
+	for (const auto &id : ids) {
+		pending_visibility &p = g_pending_visibility[id];
+		p.seq = seq;
+		p.issued = start.issued;
+		p.started = false;
+	}
+	return seq;
+}
+
+static void forget_visibility_latency(const std::string &id)
+{
+	std::lock_guard<std::mutex> lk(g_latency_mx);
+	g_pending_visibility.erase(id);
+	g_visibility_latency.erase(id);
+}
+
+void record_visibility_ack(const std::string &id, uint64_t seq, visibility_ack_phase phase)
+{
+	const auto now = std::chrono::steady_clock::now();
+
+	std::lock_guard<std::mutex> lk(g_latency_mx);
+	auto it = g_pending_visibility.find(id);
+	if (it == g_pending_visibility.end())
+		return;
+
+	pending_visibility &p = it->second;
+	if (seq != 0 && seq != p.seq)
+		return;
+
+	const double ms = std::chrono::duration<double, std::milli>(now - p.issued).count();
+	visibility_latency &lat = g_visibility_latency[id];
+	lat.id = id;
+
+	if (phase == visibility_ack_phase::Start) {
+		if (!p.started) {
+			p.started = true;
+			lat.to_mount.add(ms);
+		}
+		return;
 	}
 
+	lat.to_animation_end.add(ms);
+	g_pending_visibility.erase(it);
+}
+
+std::vector<visibility_latency> visibility_latency_stats()
+{
+	std::lock_guard<std::mutex> lk(g_latency_mx);
+	std::vector<visibility_latency> out;
+	out.reserve(g_visibility_latency.size());
+	for (const auto &kv : g_visibility_latency)
+		out.push_back(kv.second);
+	std::sort(out.begin(), out.end(),
+		  [](const visibility_latency &a, const visibility_latency &b) { return a.id < b.id; });
+	return out;
+}
+
+void reset_visibility_latency_stats()
+{
+	std::lock_guard<std::mutex> lk(g_latency_mx);
+	g_visibility_latency.clear();
+}
+
+// Makes `next` the visible set as one command: one lt-visible.json write, one sequence number, one
+// event. Nothing changes when the write fails. target* fill the event's id/visible for single-item
+// commands.
+static bool commit_visible_set(const command_time &start, std::vector<std::string> next,
+			       const std::string &targetId, bool targetVisible)
+{
+	std::unordered_set<std::string> nextSet(next.begin(), next.end());
+
+	std::vector<std::string> shown, hidden;
+	for (const auto &id : next) {
+		if (g_visible_set.find(id) == g_visible_set.end())
+			shown.push_back(id);
+	}
+	for (const auto &id : g_visible) {
+		if (nextSet.find(id) == nextSet.end())
+			hidden.push_back(id);
+	}
+	if (shown.empty() && hidden.empty())
+		return true;
+
+	std::swap(g_visible, next);
+	std::swap(g_visible_set, nextSet);
+	g_visible_snapshot.reset();
+	if (!save_visible_json()) {
+		g_visible = std::move(next);
+		g_visible_set = std::move(nextSet);
+		g_visible_snapshot.reset();
+		return false;
+	}
+
+	// One command: exclusive-group hides share the sequence number of the change that caused them.
+	std::vector<std::string> changed = hidden;
+	changed.insert(changed.end(), shown.begin(), shown.end());
+	const uint64_t seq = begin_visibility_command(changed, start);
+
 	core_event ev;
 	ev.type = event_type::VisibilityChanged;
-	ev.id = id;
-	ev.visible = visible;
-	ev.visible_ids = visNow;
-	emit_event(ev);
+	ev.id = targetId;
+	ev.visible = targetVisible;
+	ev.visible_ids = visible_snapshot();
+	ev.shown_ids = std::move(shown);
+	ev.hidden_ids = std::move(hidden);
+	ev.seq = seq;
+	ev.ts_ms = start.ts_ms;
+	emit_core_event(ev);
 
 	return true;
 }
 
-bool toggle_visible_persist(const std::string &id)
+// The exclusive group `id` belongs to, or nullptr.
+static const group_cfg *exclusive_group_of(const std::string &id)
+{
+	const auto owners = groups_containing(id);
+	if (owners.empty())
+		return nullptr;
+	const group_cfg *g = get_group_by_id_const(owners.front());
+	return g && g->exclusive ? g : nullptr;
+}
+
+// True when `ids` could all be visible at once: no two of them share an exclusive group.
+static bool exclusive_groups_allow(const std::vector<std::string> &ids)
+{
+	std::unordered_set<std::string> taken;
+	for (const auto &id : ids) {
+		const group_cfg *g = exclusive_group_of(id);
+		if (g && !taken.insert(g->id).second)
+			return false;
+	}
+	return true;
+}
+
+// Resolves `changes` in order against a working copy of the visible set (showing a member of an
+// exclusive group hides the others), then commits the result. Callers validate ids.
+static bool commit_visibility_command(const std::vector<visibility_change> &changes, const std::string &targetId,
+				      bool targetVisible)
+{
+	const command_time start;
+	std::vector<std::string> next = g_visible;
+	std::unordered_set<std::string> nextSet = g_visible_set;
+
+	auto hide = [&](const std::string &id) {
+		if (nextSet.erase(id))
+			next.erase(std::remove(next.begin(), next.end(), id), next.end());
+	};
+
+	auto show = [&](const std::string &id) {
+		if (nextSet.find(id) != nextSet.end())
+			return;
+
+		if (const group_cfg *g = exclusive_group_of(id)) {
+			for (const auto &m : g->members) {
+				if (m != id)
+					hide(m);
+			}
+		}
+
+		nextSet.insert(id);
+		next.push_back(id);
+	};
+
+	for (const auto &c : changes) {
+		if (c.visible)
+			show(c.id);
+		else
+			hide(c.id);
+	}
+
+	return commit_visible_set(start, std::move(next), targetId, targetVisible);
+}
+
+static bool set_visible_persist_now(const std::string &id, bool visible)
+{
+	if (!has_output_dir() || id.empty())
+		return false;
+
+	if (!get_by_id_const(id))
+		return false;
+
+	return commit_visibility_command({visibility_change{id, visible}}, id, visible);
+}
+
+static bool set_visible_batch_now(const std::vector<visibility_change> &changes, std::string *error)
+{
+	if (!has_output_dir()) {
+		if (error)
+			*error = "No output dir configured";
+		return false;
+	}
+
+	for (const auto &c : changes) {
+		if (c.id.empty() || !get_by_id_const(c.id)) {
+			if (error)
+				*error = "Unknown lower third id: " + c.id;
+			return false;
+		}
+	}
+
+	if (changes.empty())
+		return true;
+
+	// Single-item batches read like set_visible_persist() to event consumers.
+	if (changes.size() == 1)
+		return commit_visibility_command(changes, changes.front().id, changes.front().visible);
+	return commit_visibility_command(changes, std::string(), false);
+}
+
+static bool set_visible_set_now(const std::vector<std::string> &ids)
+{
+	const command_time start;
+	if (!has_output_dir())
+		return false;
+
+	std::vector<std::string> target;
+	target.reserve(ids.size());
+	for (const auto &id : ids) {
+		if (get_by_id_const(id) && std::find(target.begin(), target.end(), id) == target.end())
+			target.push_back(id);
+	}
+	// Exactly the target set, or nothing: resolving exclusive groups one show at a time would
+	// silently drop members of it.
+	if (!exclusive_groups_allow(target)) {
+		LOGW("Visible set rejected: it shows several members of one exclusive group");
+		return false;
+	}
+
+	// Items that stay visible keep their place; new ones follow in the given order.
+	const std::unordered_set<std::string> want(target.begin(), target.end());
+	std::vector<std::string> next;
+	next.reserve(target.size());
+	for (const auto &id : g_visible) {
+		if (want.find(id) != want.end())
+			next.push_back(id);
+	}
+	for (const auto &id : target) {
+		if (g_visible_set.find(id) == g_visible_set.end())
+			next.push_back(id);
+	}
+
+	return commit_visible_set(start, std::move(next), std::string(), false);
+}
+
+// -------------------------
+// Visibility presets
+// -------------------------
+static std::string preset_name(const std::string &name)
+{
+	return QString::fromStdString(name).trimmed().toStdString();
+}
+
+static std::vector<visibility_preset>::iterator find_preset(const std::string &name)
+{
+	return std::find_if(g_presets.begin(), g_presets.end(),
+			    [&](const visibility_preset &p) { return p.name == name; });
+}
+
+std::vector<visibility_preset> visibility_presets()
+{
+	return g_presets;
+}
+
+static bool save_visibility_preset_now(const std::string &name, const std::vector<std::string> *ids)
+{
+	const std::string n = preset_name(name);
+	if (!has_output_dir() || n.empty())
+		return false;
+
+	ensure_output_artifacts_exist();
+
+	visibility_preset p;
+	p.name = n;
+	for (const auto &id : ids ? *ids : g_visible) {
+		const std::string sid = sanitize_id(id);
+		if (get_by_id_const(sid) && std::find(p.ids.begin(), p.ids.end(), sid) == p.ids.end())
+			p.ids.push_back(sid);
+	}
+	if (!exclusive_groups_allow(p.ids)) {
+		LOGW("Preset '%s' rejected: it shows several members of one exclusive group", n.c_str());
+		return false;
+	}
+
+	auto it = find_preset(n);
+	if (it != g_presets.end())
+		*it = std::move(p);
+	else
+		g_presets.push_back(std::move(p));
+
+	return save_state_json();
+}
+
+static bool delete_visibility_preset_now(const std::string &name)
+{
+	const std::string n = preset_name(name);
+	if (!has_output_dir() || n.empty())
+		return false;
+
+	ensure_output_artifacts_exist();
+
+	auto it = find_preset(n);
+	if (it == g_presets.end())
+		return false;
+	g_presets.erase(it);
+
+	return save_state_json();
+}
+
+static bool recall_visibility_preset_now(const std::string &name)
+{
+	auto it = find_preset(preset_name(name));
+	if (it == g_presets.end())
+		return false;
+
+	const std::vector<std::string> ids = it->ids;
+	return set_visible_set(ids);
+}
+
+static bool toggle_visible_persist_now(const std::string &id)
 {
 	if (!has_output_dir() || id.empty())
 		return false;
 
-	if (!get_by_id(id))
+	if (!get_by_id_const(id))
 		return false;
 
 	const bool after = !is_visible(id);
 	return set_visible_persist(id, after);
 }
 
+static bool write_push_json()
+{
+	if (!has_output_dir())
+		return false;
+
+	QJsonObject root;
+	if (!g_push_url.empty())
+		root["url"] = QString::fromStdString(g_push_url);
+	if (!g_ack_url.empty())
+		root["ack"] = QString::fromStdString(g_ack_url);
+	return write_text_file(path_push_json(), QJsonDocument(root).toJson(QJsonDocument::Compact).toStdString());
+}
+
+void set_push_endpoint(const std::string &eventsUrl, const std::string &ackUrl)
+{
+	g_push_url = eventsUrl;
+	g_ack_url = ackUrl;
+	write_push_json();
+}
+
 bool ensure_output_artifacts_exist()
 {
 	if (!has_output_dir())
@@ -1223,18 +2128,14 @@ bool ensure_output_artifacts_exist()
 
 	if (!QFile::exists(QString::fromStdString(path_state_json()))) {
 		g_items.clear();
+		reindex_items();
 		save_state_json();
 	}
 	if (!QFile::exists(QString::fromStdString(path_visible_json()))) {
-		g_visible.clear();
+		clear_visible();
 		save_visible_json();
 	}
-	if (!QFile::exists(QString::fromStdString(path_styles_css()))) {
-		write_text_file(path_styles_css(), "/* generated */\n");
-	}
-	if (!QFile::exists(QString::fromStdString(path_scripts_js()))) {
-		write_text_file(path_scripts_js(), "/* generated */\n");
-	}
+	write_push_json();
 
 	return true;
 }
@@ -1246,15 +2147,13 @@ bool load_state_json()
 
 	const std::string p = path_state_json();
 	if (!QFile::exists(QString::fromStdString(p))) {
-		g_items.clear();
-		g_groups.clear();
+		clear_items_and_groups();
 		return true;
 	}
 
 	const std::string txt = read_text_file(p);
 	if (txt.empty()) {
-		g_items.clear();
-		g_groups.clear();
+		clear_items_and_groups();
 		return true;
 	}
 
@@ -1262,8 +2161,7 @@ bool load_state_json()
 	const QJsonDocument doc = QJsonDocument::fromJson(QByteArray::fromStdString(txt), &err);
 	if (err.error != QJsonParseError::NoError || !doc.isObject()) {
 		LOGW("Invalid lt-state.json; reset");
-		g_items.clear();
-		g_groups.clear();
+		clear_items_and_groups();
 		return false;
 	}
 
@@ -1302,13 +2200,8 @@ bool load_state_json()
 
 		c.title_size = o.value("title_size").toInt(46);
 		c.subtitle_size = o.value("subtitle_size").toInt(24);
-		c.title_size = std::max(6, std::min(200, c.title_size));
-		c.subtitle_size = std::max(6, std::min(200, c.subtitle_size));
-
 		c.avatar_width = o.value("avatar_width").toInt(100);
 		c.avatar_height = o.value("avatar_height").toInt(100);
-		c.avatar_width = std::max(10, std::min(400, c.avatar_width));
-		c.avatar_height = std::max(10, std::min(400, c.avatar_height));
 
 		c.anim_in = o.value("anim_in").toString().toStdString();
 		c.anim_out = o.value("anim_out").toString().toStdString();
@@ -1332,11 +2225,6 @@ bool load_state_json()
 		c.opacity = o.value("opacity").toInt(0);
 		c.radius = o.value("radius").toInt(0);
 
-		if (c.opacity < 0 || c.opacity > 100)
-			c.opacity = 85;
-		if (c.radius < 0 || c.radius > 100)
-			c.radius = 5;
-
 		c.html_template = o.value("html_template").toString().toStdString();
 		c.css_template = o.value("css_template").toString().toStdString();
 		c.js_template = o.value("js_template").toString().toStdString();
@@ -1355,39 +2243,8 @@ bool load_state_json()
 		c.repeat_every_sec = o.value("repeat_every_sec").toInt(0);
 		c.repeat_visible_sec = o.value("repeat_visible_sec").toInt(0);
 
-		if (c.repeat_every_sec < 0)
-			c.repeat_every_sec = 0;
-		if (c.repeat_visible_sec < 0)
-			c.repeat_visible_sec = 0;
-
-		if (c.html_template.empty() || c.css_template.empty()) {
-			auto d = default_cfg();
-			if (c.html_template.empty())
-				c.html_template = d.html_template;
-			if (c.css_template.empty())
-				c.css_template = d.css_template;
-			if (c.js_template.empty())
-				c.js_template = d.js_template;
-		}
-
-		if (c.lt_position.empty())
-			c.lt_position = "lt-pos-bottom-left";
-		if (c.anim_in.empty())
-			c.anim_in = "animate__fadeInUp";
-		if (c.anim_out.empty())
-			c.anim_out = "animate__fadeOutDown";
-		if (c.primary_color.empty())
-			c.primary_color = "#111827";
-		if (c.secondary_color.empty())
-			c.secondary_color = "#1F2937";
-		if (c.title_color.empty())
-			c.title_color = "#F9FAFB";
-		if (c.subtitle_color.empty())
-			c.subtitle_color = "#D1D5DB";
-
-		if (c.label.empty())
-			c.label = c.title.empty() ? c.id : c.title;
-
+		// Group members are zeroed below, once membership is known.
+		normalize_item(c, false);
 		out.push_back(std::move(c));
 	}
 
@@ -1468,11 +2325,7 @@ bool load_state_json()
 			c.order = nextCarOrder;
 		nextCarOrder = std::max(nextCarOrder, c.order + 1);
 	}
-	std::sort(outCars.begin(), outCars.end(), [](const group_cfg &a, const group_cfg &b) {
-		if (a.order != b.order)
-			return a.order < b.order;
-		return a.id < b.id;
-	});
+	std::sort(outCars.begin(), outCars.end(), group_less);
 
 	g_groups = std::move(outCars);
 
@@ -1495,6 +2348,25 @@ bool load_state_json()
 	}
 
 	g_items = std::move(out);
+	reindex_items();
+	reindex_groups();
+	reindex_members();
+
+	// "presets": [{ "name": "...", "visible": ["<lt_id>", ...] }]
+	g_presets.clear();
+	for (const auto &pv : root.value("presets").toArray()) {
+		const QJsonObject po = pv.toObject();
+		visibility_preset p;
+		p.name = preset_name(po.value("name").toString().toStdString());
+		if (p.name.empty() || find_preset(p.name) != g_presets.end())
+			continue;
+		for (const auto &iv : po.value("visible").toArray()) {
+			const std::string sid = sanitize_id(iv.toString().toStdString());
+			if (!sid.empty())
+				p.ids.push_back(sid);
+		}
+		g_presets.push_back(std::move(p));
+	}
 
 	for (const auto &car : g_groups) {
 		for (const auto &mid : car.members) {
@@ -1601,8 +2473,22 @@ bool save_state_json()
 	hkRoot["groups"] = hkGroups;
 	root["hotkeys"] = hkRoot;
 
+	QJsonArray presets;
+	for (const auto &p : g_presets) {
+		QJsonObject po;
+		po["name"] = QString::fromStdString(p.name);
+		QJsonArray ids;
+		for (const auto &id : p.ids)
+			ids.append(QString::fromStdString(id));
+		po["visible"] = ids;
+		presets.append(po);
+	}
+	root["presets"] = presets;
+
 	const QJsonDocument doc(root);
-	return write_text_file(path_state_json(), doc.toJson(QJsonDocument::Indented).toStdString());
+	const bool ok = write_text_file(path_state_json(), doc.toJson(QJsonDocument::Indented).toStdString());
+	publish_state();
+	return ok;
 }
 
 bool load_visible_json()
@@ -1612,13 +2498,13 @@ bool load_visible_json()
 
 	const std::string p = path_visible_json();
 	if (!QFile::exists(QString::fromStdString(p))) {
-		g_visible.clear();
+		clear_visible();
 		return true;
 	}
 
 	const std::string txt = read_text_file(p);
 	if (txt.empty()) {
-		g_visible.clear();
+		clear_visible();
 		return true;
 	}
 
@@ -1626,7 +2512,7 @@ bool load_visible_json()
 	const QJsonDocument doc = QJsonDocument::fromJson(QByteArray::fromStdString(txt), &err);
 	if (err.error != QJsonParseError::NoError) {
 		LOGW("Invalid lt-visible.json; reset");
-		g_visible.clear();
+		clear_visible();
 		return false;
 	}
 
@@ -1639,13 +2525,12 @@ bool load_visible_json()
 		}
 	}
 
-	std::vector<std::string> keep;
-	keep.reserve(ids.size());
+	clear_visible();
+	g_visible.reserve(ids.size());
 	for (const auto &id : ids)
-		if (get_by_id(id))
-			keep.push_back(id);
+		if (get_by_id_const(id))
+			set_visible_nosave(id, true);
 
-	g_visible = std::move(keep);
 	return true;
 }
 
@@ -1659,22 +2544,353 @@ bool save_visible_json()
 	std::sort(ids.begin(), ids.end());
 	ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
 
-	QJsonArray a;
-	for (const auto &id : ids)
-		a.append(QString::fromStdString(id));
+	QJsonArray a;
+	for (const auto &id : ids)
+		a.append(QString::fromStdString(id));
+
+	const QJsonDocument doc(a);
+	const bool ok = write_text_file(path_visible_json(), doc.toJson(QJsonDocument::Indented).toStdString());
+	publish_state();
+	return ok;
+}
+
+// -------------------------
+// Per-item artifact cache
+// -------------------------
+// Every rebuild used to recompile the CSS/JS/HTML of every item. Items are now compiled once into
+// fragments keyed by a content hash of the fields that affect the overlay output; a rebuild only
+// recompiles items whose hash changed and splices the cached fragments in for the rest.
+struct item_fragments {
+	uint64_t hash = 0;
+	std::string css;                            // scoped per-item CSS, keyframes lifted out
+	std::vector<extracted_keyframes> keyframes; // keyframes blocks extracted from the item CSS
+	std::string js;                             // wrapped per-item script (build_item_script)
+	std::string html;                           // <li> markup (build_item_html)
+	std::string hash_hex;                       // hash as hex, stamped on the <li> as data-slt-hash
+	std::string anim_json;                      // animation config (build_anim_cfg_json)
+	std::string anim_entry;                     // animMap entry for lt.js
+	std::vector<std::string> animate_classes;   // animate__* classes the item uses (anim in/out, markup, script)
+	std::vector<std::string> assets;            // output-dir files the item loads (picture, sounds)
+
+	// Templates compiled once; only recompiled when the template text itself changes.
+	tpl::compiled_template html_tpl;
+	tpl::compiled_template css_tpl;
+	tpl::compiled_template js_tpl;
+};
+
+// The fragment cache, keyframes table and loaded-page state below belong to the rebuild worker (see
+// "Rebuild worker"), which holds g_build_mx while it uses them.
+static std::mutex g_build_mx;
+static std::unordered_map<std::string, item_fragments> g_fragment_cache;
+static std::mutex g_stats_mx;
+static artifact_cache_stats g_fragment_stats;
+
+static void hash_bytes(uint64_t &h, const void *data, size_t len)
+{
+	const auto *p = static_cast<const unsigned char *>(data);
+	for (size_t i = 0; i < len; ++i) {
+		h ^= (uint64_t)p[i];
+		h *= 1099511628211ULL;
+	}
+}
+
+static void hash_field(uint64_t &h, const std::string &s)
+{
+	// Length prefix keeps ("ab","c") and ("a","bc") apart.
+	const uint64_t n = (uint64_t)s.size();
+	hash_bytes(h, &n, sizeof(n));
+	hash_bytes(h, s.data(), s.size());
+}
+
+static void hash_field(uint64_t &h, int v)
+{
+	hash_bytes(h, &v, sizeof(v));
+}
+
+// Content hash of everything that ends up in the generated overlay. Dock-only fields (label, order,
+// hotkey, repeat timing) are deliberately excluded so editing them never invalidates the cache.
+static uint64_t cfg_content_hash(const lower_third_cfg &c)
+{
+	uint64_t h = 14695981039346656037ULL;
+	hash_field(h, c.id);
+	hash_field(h, c.title);
+	hash_field(h, c.subtitle);
+	hash_field(h, rendered_profile_picture(c)); // changes when the scaled variant is ready
+	hash_field(h, c.anim_in_sound);
+	hash_field(h, c.anim_out_sound);
+	hash_field(h, c.title_size);
+	hash_field(h, c.subtitle_size);
+	hash_field(h, c.avatar_width);
+	hash_field(h, c.avatar_height);
+	hash_field(h, c.anim_in);
+	hash_field(h, c.anim_out);
+	hash_field(h, c.font_family);
+	hash_field(h, c.lt_position);
+	hash_field(h, c.primary_color);
+	hash_field(h, c.secondary_color);
+	hash_field(h, c.title_color);
+	hash_field(h, c.subtitle_color);
+	hash_field(h, c.opacity);
+	hash_field(h, c.radius);
+	hash_field(h, c.html_template);
+	hash_field(h, c.css_template);
+	hash_field(h, c.js_template);
+	return h;
+}
+
+static void compile_item_fragments(const lower_third_cfg &c, uint64_t hash, item_fragments &out)
+{
+	out.hash = hash;
+
+	auto ensure_compiled = [](tpl::compiled_template &t, const std::string &src) {
+		if (t.source() != src)
+			t = tpl::compiled_template::compile(src);
+	};
+	ensure_compiled(out.html_tpl, c.html_template);
+	ensure_compiled(out.css_tpl, c.css_template);
+	ensure_compiled(out.js_tpl, c.js_template);
+
+	const std::string picture = rendered_profile_picture(c);
+	const tpl::values vals = build_placeholder_values(c, picture);
+
+	out.assets.clear();
+	for (const std::string *f : {&picture, &c.anim_in_sound, &c.anim_out_sound}) {
+		if (is_plain_file_name(*f))
+			out.assets.push_back(*f);
+	}
+
+	const std::string per = out.css_tpl.render(vals);
+
+	// One tokenizer pass scopes the selectors and lifts the keyframes blocks out.
+	std::vector<css::keyframes_block> kfs;
+	out.css.clear();
+	out.css += "/* ---- " + c.id + " ---- */\n";
+	css::scope_stylesheet(per, c.id, out.css, kfs);
+	out.css += "\n";
+
+	out.keyframes.clear();
+	out.keyframes.reserve(kfs.size());
+	for (auto &kb : kfs) {
+		extracted_keyframes kf;
+		kf.at_rule = std::move(kb.at_rule);
+		kf.name = std::move(kb.name);
+		kf.block = std::move(kb.block);
+		kf.name_pos = kb.name_pos;
+		kf.digest = keyframes_digest(kf.block);
+		out.keyframes.push_back(std::move(kf));
+	}
+
+	out.js = build_item_script(c, out.js_tpl.render(vals));
+	out.hash_hex = QByteArray::number((qulonglong)hash, 16).toStdString();
+	out.html = build_item_html(c, out.hash_hex, out.html_tpl.render(vals));
+	out.anim_json = build_anim_cfg_json(c);
+	out.anim_entry = build_anim_map_entry(c, out.anim_json);
+
+	out.animate_classes.clear();
+	for (std::string_view text : {std::string_view(c.anim_in), std::string_view(c.anim_out),
+				      std::string_view(out.html), std::string_view(out.js)})
+		animate_css::collect_classes(text, out.animate_classes);
+}
+
+// Every asset the items of `frags` load, each once.
+static std::vector<std::string> fragment_assets(const std::vector<const item_fragments *> &frags)
+{
+	std::vector<std::string> out;
+	for (const auto *f : frags) {
+		for (const auto &a : f->assets) {
+			if (std::find(out.begin(), out.end(), a) == out.end())
+				out.push_back(a);
+		}
+	}
+	return out;
+}
+
+// Returns the fragments of every item in `items` order, recompiling only cache misses.
+// Entries for items that no longer exist are dropped.
+static std::vector<const item_fragments *> refresh_fragment_cache(const std::vector<lower_third_cfg> &items)
+{
+	std::vector<const item_fragments *> out;
+	out.reserve(items.size());
+
+	uint64_t hits = 0;
+	uint64_t misses = 0;
+
+	std::unordered_set<std::string> alive;
+	alive.reserve(items.size() * 2 + 1);
+
+	for (const auto &c : items) {
+		alive.insert(c.id);
+
+		const uint64_t h = cfg_content_hash(c);
+		auto &frag = g_fragment_cache[c.id];
+		if (frag.hash == h && h != 0) {
+			hits++;
+		} else {
+			compile_item_fragments(c, h, frag);
+			misses++;
+		}
+		out.push_back(&frag);
+	}
+
+	for (auto it = g_fragment_cache.begin(); it != g_fragment_cache.end();) {
+		if (alive.find(it->first) == alive.end())
+			it = g_fragment_cache.erase(it);
+		else
+			++it;
+	}
+
+	{
+		std::lock_guard<std::mutex> lk(g_stats_mx);
+		g_fragment_stats.hits += hits;
+		g_fragment_stats.misses += misses;
+		g_fragment_stats.last_hits = hits;
+		g_fragment_stats.last_misses = misses;
+		g_fragment_stats.entries = (uint64_t)g_fragment_cache.size();
+	}
+
+	LOGI("Artifact cache: %llu hit(s), %llu miss(es) (%llu items)", (unsigned long long)hits,
+	     (unsigned long long)misses, (unsigned long long)items.size());
+	return out;
+}
+
+artifact_cache_stats artifact_cache_statistics()
+{
+	std::lock_guard<std::mutex> lk(g_stats_mx);
+	return g_fragment_stats;
+}
+
+// -------------------------
+// Keyframes intern table
+// -------------------------
+// Every distinct keyframes block (by digest) gets one emitted name that stays stable across
+// rebuilds. Blocks whose name is already taken by different content are renamed to name_<id>.
+struct interned_keyframes {
+	std::string name;  // emitted name (empty for anonymous blocks)
+	std::string block; // block text carrying the emitted name
+	uint64_t last_used = 0;
+};
+
+static std::unordered_map<std::string, interned_keyframes> g_kf_by_digest;
+static std::unordered_map<std::string, std::string> g_kf_name_owner; // emitted name -> digest
+static uint64_t g_kf_generation = 0;
+
+// Resolves a block to its interned entry, creating it on first sight. `ownerId` disambiguates
+// name collisions.
+static interned_keyframes &intern_keyframes(const extracted_keyframes &kf, const std::string &ownerId)
+{
+	auto it = g_kf_by_digest.find(kf.digest);
+	if (it != g_kf_by_digest.end())
+		return it->second;
+
+	interned_keyframes e;
+	e.name = kf.name;
+	e.block = kf.block;
+
+	if (!kf.name.empty()) {
+		auto owner = g_kf_name_owner.find(kf.name);
+		if (owner != g_kf_name_owner.end() && owner->second != kf.digest) {
+			std::string newName = kf.name + "_" + ownerId;
+			for (int n = 2; g_kf_name_owner.count(newName); ++n)
+				newName = kf.name + "_" + ownerId + "_" + std::to_string(n);
+
+			e.block.replace(kf.name_pos, kf.name.size(), newName);
+			e.name = std::move(newName);
+		}
+		g_kf_name_owner[e.name] = kf.digest;
+	}
+
+	return g_kf_by_digest.emplace(kf.digest, std::move(e)).first->second;
+}
+
+// Drops entries that no item referenced in the current generation.
+static void prune_keyframes_table()
+{
+	for (auto it = g_kf_by_digest.begin(); it != g_kf_by_digest.end();) {
+		if (it->second.last_used != g_kf_generation) {
+			if (!it->second.name.empty())
+				g_kf_name_owner.erase(it->second.name);
+			it = g_kf_by_digest.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+// Output settings, read once per build so one build never mixes modes.
+struct output_options {
+	bool minify = false;
+	bool single_file = false; // pages embed their stylesheet and script (see inline_asset_tags())
+
+	// Part of the page signature: switching modes always reloads.
+	std::string tag() const { return std::string(minify ? "min" : "") + (single_file ? "one" : ""); }
+};
+
+// Minifies `text` when enabled; `what` (optional) names it in the size report.
+static std::string finish_output(const output_options &opts, std::string text,
+				 std::string (*minifier)(std::string_view), const char *what = nullptr)
+{
+	if (!opts.minify)
+		return text;
+
+	std::string min = minifier(text);
+	if (what)
+		LOGI("Minified %s: %zu -> %zu bytes", what, text.size(), min.size());
+	return min;
+}
+
+// The animate.css rules for the animate__* classes the items use, in place of the whole library.
+// Their keyframes go through the intern table, so they land in the deduped keyframes section.
+static std::string build_used_animate_css(const std::vector<const item_fragments *> &frags, uint64_t gen,
+					  std::vector<const interned_keyframes *> &kfOrder)
+{
+	std::vector<std::string> used;
+	for (const auto *f : frags) {
+		for (const auto &cls : f->animate_classes) {
+			if (std::find(used.begin(), used.end(), cls) == used.end())
+				used.push_back(cls);
+		}
+	}
+	std::sort(used.begin(), used.end()); // reordering the list must not change lt.css
+
+	std::string modifiers, rules;
+	for (const auto &cls : used) {
+		const animate_css::animation *a = animate_css::find_animation(cls);
+		if (!a) {
+			const std::string_view rule = animate_css::find_modifier(cls);
+			if (!rule.empty())
+				modifiers.append(rule).append("\n");
+			continue;
+		}
+
+		extracted_keyframes kf;
+		kf.at_rule = "@keyframes";
+		kf.name = std::string(a->name);
+		kf.block = "@keyframes " + kf.name + " {" + std::string(a->frames) + "}";
+		kf.name_pos = kf.at_rule.size() + 1;
+		kf.digest = keyframes_digest(kf.block);
+
+		interned_keyframes &e = intern_keyframes(kf, "animate");
+		if (e.last_used != gen) {
+			e.last_used = gen;
+			kfOrder.push_back(&e);
+		}
+		rules += "." + cls + "{animation-name:" + e.name + ";" + std::string(a->extra) + "}\n";
+	}
 
-	const QJsonDocument doc(a);
-	return write_text_file(path_visible_json(), doc.toJson(QJsonDocument::Indented).toStdString());
+	if (rules.empty())
+		return std::string(); // modifiers alone animate nothing
+	return "\n/* animate.css (used animations only) */\n" + std::string(animate_css::base_rules()) + modifiers +
+	       rules;
 }
 
-static bool regenerate_merged_css_js(const std::string &ts, std::string &outCssFile, std::string &outJsFile)
+// Writes the stylesheet to a content-named file; `outCss` receives its text.
+static bool regenerate_merged_css(const std::vector<lower_third_cfg> &items,
+				  const std::vector<const item_fragments *> &frags, const output_options &opts,
+				  std::string &outCssFile, std::string &outCss)
 {
 	if (!has_output_dir())
 		return false;
 
-	outCssFile = bundle_styles_name(ts);
-	outJsFile = bundle_scripts_name(ts);
-
 	std::string css;
 	css += build_shared_css();
 
@@ -1721,328 +2937,1055 @@ static bool regenerate_merged_css_js(const std::string &ts, std::string &outCssF
 
 )CSS";
 
+	const uint64_t gen = ++g_kf_generation;
+	std::vector<const interned_keyframes *> kfOrder;
+
+	// Interned before the items' own keyframes, so animate.css keeps its names on a fresh table.
+	css += build_used_animate_css(frags, gen, kfOrder);
+
 	css += "\n/* Per-LT scoped styles */\n";
 
-	std::unordered_map<std::string, std::string> kfNameToNorm;
-	std::unordered_map<std::string, std::string> kfNameToBlock;
-	std::vector<std::string> kfOrder;
+	for (size_t i = 0; i < frags.size(); ++i) {
+		const lower_third_cfg &c = items[i];
+		const item_fragments &f = *frags[i];
 
-	for (const auto &c : g_items) {
+		// Renames only happen on keyframes name collisions, so the cached CSS is copied lazily.
+		std::string renamed;
+		bool hasRename = false;
 
-		std::string per = c.css_template;
-		per = replace_all(per, "{{ID}}", c.id);
-		per = replace_all(per, "{{PRIMARY_COLOR}}", c.primary_color);
-		per = replace_all(per, "{{SECONDARY_COLOR}}", c.secondary_color);
-		per = replace_all(per, "{{TITLE_COLOR}}", c.title_color);
-		per = replace_all(per, "{{SUBTITLE_COLOR}}", c.subtitle_color);
-
-		per = replace_all(per, "{{BG_COLOR}}", c.primary_color);
-		per = replace_all(per, "{{TEXT_COLOR}}", c.title_color);
-		per = replace_all(per, "{{OPACITY}}", std::to_string(c.opacity));
-		per = replace_all(per, "{{RADIUS}}", std::to_string(c.radius));
-		per = replace_all(per, "{{FONT_FAMILY}}", c.font_family.empty() ? "Inter" : c.font_family);
-		per = replace_all(per, "{{TITLE_SIZE}}", std::to_string(c.title_size));
-		per = replace_all(per, "{{SUBTITLE_SIZE}}", std::to_string(c.subtitle_size));
-
-		std::vector<extracted_keyframes> extracted;
-		extract_keyframes_blocks(per, extracted);
-
-		for (auto &kf : extracted) {
-
-			if (kf.name.empty()) {
-				const std::string sig = kf.norm;
-				bool exists = false;
-				for (const auto &kv : kfNameToNorm) {
-					if (kv.second == sig) {
-						exists = true;
-						break;
-					}
-				}
-				if (!exists) {
-					const std::string anonName =
-						"kf_" + c.id + "_" + std::to_string(kfOrder.size());
-					kfNameToNorm[anonName] = sig;
-					kfNameToBlock[anonName] = kf.block;
-					kfOrder.push_back(anonName);
-				}
+		for (const auto &kf : f.keyframes) {
+			interned_keyframes &e = intern_keyframes(kf, c.id);
+			if (e.last_used != gen) {
+				e.last_used = gen;
+				kfOrder.push_back(&e);
+			}
+
+			if (kf.name.empty() || e.name == kf.name)
 				continue;
+
+			if (!hasRename) {
+				renamed = f.css;
+				hasRename = true;
 			}
+			renamed = replace_whole_ident(renamed, kf.name, e.name);
+		}
+
+		css += "\n";
+		css += hasRename ? renamed : f.css;
+	}
+
+	css += "\n/* Keyframes (deduped) */\n";
+	for (const auto *e : kfOrder)
+		css += "\n" + e->block + "\n";
+
+	prune_keyframes_table();
+
+	css = finish_output(opts, std::move(css), minify::css, "stylesheet");
+	outCssFile = bundle_styles_name(content_digest(css));
+	const std::string cssPath = output_path(outCssFile);
+	if (cssPath.empty() || !write_text_file(cssPath, css)) {
+		LOGW("Failed writing %s", cssPath.empty() ? "<empty css path>" : cssPath.c_str());
+		return false;
+	}
+
+	outCss = std::move(css);
+	return true;
+}
+
+static std::string build_merged_js(const std::vector<const item_fragments *> &frags)
+{
+	std::string animMap;
+	for (const auto *f : frags)
+		animMap += f->anim_entry;
+
+	std::string js;
+	js += build_anim_map_script(animMap);
+	js += build_base_script();
+	js += "\n\n/* Per-LT scripts */\n";
+	for (const auto *f : frags)
+		js += f->js;
+	return js;
+}
+
+static std::string generate_bundle_html(const std::string &htmlFile, const std::string &html)
+{
+	const std::string abs = output_path(htmlFile);
+	if (abs.empty())
+		return {};
+
+	if (!write_text_file(abs, html))
+		return {};
+	return abs;
+}
+
+static obs_source_t *get_target_browser_source()
+{
+	if (g_target_browser_source.empty())
+		return nullptr;
+
+	return obs_get_source_by_name(g_target_browser_source.c_str());
+}
+
+std::vector<std::string> list_browser_source_names()
+{
+	std::vector<std::string> out;
+
+	auto enum_cb = [](void *param, obs_source_t *src) -> bool {
+		if (!src)
+			return true;
+
+		const char *id = obs_source_get_id(src);
+		if (!id)
+			return true;
+
+		if (std::string(id) != sltBrowserSourceId)
+			return true;
+
+		const char *name = obs_source_get_name(src);
+		if (name && *name) {
+			auto *vec = static_cast<std::vector<std::string> *>(param);
+			vec->push_back(std::string(name));
+		}
+		return true;
+	};
+
+	obs_enum_sources(enum_cb, &out);
+
+	std::sort(out.begin(), out.end());
+	out.erase(std::unique(out.begin(), out.end()), out.end());
+	return out;
+}
+
+std::string target_browser_source_name()
+{
+	return g_target_browser_source;
+}
+
+static bool set_target_browser_source_name_now(const std::string &name)
+{
+	g_target_browser_source = name;
+	return save_global_config();
+}
+
+int target_browser_width()
+{
+	return g_target_browser_width;
+}
+
+int target_browser_height()
+{
+	return g_target_browser_height;
+}
+
+static bool set_target_browser_dimensions_now(int width, int height)
+{
+	if (width < 1)
+		width = 1;
+	if (height < 1)
+		height = 1;
+
+	g_target_browser_width = width;
+	g_target_browser_height = height;
+
+	obs_source_t *src = get_target_browser_source();
+	if (src) {
+		obs_data_t *s = obs_source_get_settings(src);
+		obs_data_set_int(s, "width", (int64_t)g_target_browser_width);
+		obs_data_set_int(s, "height", (int64_t)g_target_browser_height);
+		obs_source_update(src, s);
+		obs_data_release(s);
+		obs_source_release(src);
+	}
+
+	return save_global_config();
+}
+
+bool target_browser_source_exists()
+{
+	obs_source_t *src = get_target_browser_source();
+	if (!src)
+		return false;
+
+	const char *id = obs_source_get_id(src);
+	const bool ok = (id && std::string(id) == sltBrowserSourceId);
+
+	obs_source_release(src);
+	return ok;
+}
+
+static void refreshSourceSettings(obs_source_t *s)
+{
+	if (!s)
+		return;
+
+	obs_data_t *data = obs_source_get_settings(s);
+	obs_source_update(s, data);
+	obs_data_release(data);
+
+	if (strcmp(obs_source_get_id(s), "browser_source") == 0) {
+		obs_properties_t *sourceProperties = obs_source_properties(s);
+		obs_property_t *property = obs_properties_get(sourceProperties, "refreshnocache");
+		if (property)
+			obs_property_button_clicked(property, s);
+		obs_properties_destroy(sourceProperties);
+	}
+}
+
+// local_file of the target browser source, or empty if it is missing / not a browser source.
+static std::string target_browser_source_file()
+{
+	obs_source_t *src = get_target_browser_source();
+	if (!src)
+		return {};
+
+	std::string out;
+	const char *id = obs_source_get_id(src);
+	if (id && std::string(id) == sltBrowserSourceId) {
+		obs_data_t *s = obs_source_get_settings(src);
+		const char *p = obs_data_get_string(s, "local_file");
+		out = p ? std::string(p) : std::string();
+		obs_data_release(s);
+	}
+	obs_source_release(src);
+	return out;
+}
+
+bool swap_target_browser_source_to_file(const std::string &absoluteHtmlPath)
+{
+	if (absoluteHtmlPath.empty())
+		return false;
+
+	obs_source_t *src = get_target_browser_source();
+	if (!src) {
+		if (g_target_browser_source.empty())
+			LOGW("No target Browser Source selected.");
+		else
+			LOGW("Target Browser Source '%s' not found.", g_target_browser_source.c_str());
+		return false;
+	}
+
+	const char *id = obs_source_get_id(src);
+	if (!id || std::string(id) != sltBrowserSourceId) {
+		LOGW("Target source '%s' is not a Browser Source.", g_target_browser_source.c_str());
+		obs_source_release(src);
+		return false;
+	}
+
+	obs_data_t *s = obs_source_get_settings(src);
+	const char *prevPathC = obs_data_get_string(s, "local_file");
+	const std::string prevPath = prevPathC ? std::string(prevPathC) : std::string();
+
+	if (!prevPath.empty() && prevPath == absoluteHtmlPath) {
+		obs_data_set_string(s, "local_file", "");
+		obs_source_update(src, s);
+	}
+	obs_data_set_bool(s, "is_local_file", true);
+	obs_data_set_string(s, "local_file", absoluteHtmlPath.c_str());
+
+	obs_data_set_bool(s, "is_control_audio", true);
+	obs_data_set_bool(s, "control_audio", true);
+	obs_data_set_bool(s, "reroute_audio", true);
+
+	obs_data_set_bool(s, "smart_lt_managed", true);
+	obs_data_set_int(s, "width", (int64_t)g_target_browser_width);
+	obs_data_set_int(s, "height", (int64_t)g_target_browser_height);
+	obs_source_update(src, s);
+
+	obs_data_release(s);
+
+	refreshSourceSettings(src);
+	obs_source_release(src);
+	return true;
+}
+
+// -------------------------
+// Bundle manifest
+// -------------------------
+// lt-bundles.json lists the pages written to the output dir, newest (the loaded one) first: each page
+// with the stylesheet and script it links, the stylesheets hot patches later moved it to, and the
+// pictures and sounds it loads (recorded as it is written, so nothing ever re-reads a page). The
+// newest kKeepBundleGenerations pages stay on disk so the overlay can be rolled back; files that no
+// kept generation references are deleted right away, so the directory is never scanned. Pictures and
+// sounds an edit dropped are listed as "discarded" until the last kept page loading them is gone.
+static constexpr const char *kBundleManifestName = "lt-bundles.json";
+static constexpr size_t kKeepBundleGenerations = 5;
+static constexpr size_t kKeepPatchStyles = 4; // per generation; only the newest one is in use
+
+struct bundle_generation {
+	std::string html; // file names in the output dir
+	std::string css;
+	std::string js;
+	std::vector<std::string> patch_css; // oldest first
+	std::vector<std::string> assets;    // pictures and sounds the page (or a patch applied to it) loads
+	int64_t created_ms = 0;
+};
+
+struct bundle_manifest {
+	std::string dir;                     // output dir the manifest belongs to
+	std::vector<bundle_generation> gens; // newest first
+	std::vector<std::string> discarded;  // assets to delete once nothing loads them (discard_output_file)
+};
+
+static bundle_manifest g_bundles; // rebuild worker (g_build_mx)
+
+static bool bundle_file_referenced(const std::string &file)
+{
+	for (const auto &g : g_bundles.gens) {
+		if (g.html == file || g.css == file || g.js == file ||
+		    std::find(g.patch_css.begin(), g.patch_css.end(), file) != g.patch_css.end() ||
+		    std::find(g.assets.begin(), g.assets.end(), file) != g.assets.end())
+			return true;
+	}
+	return false;
+}
+
+// Deletes those of `files` that no generation references any more.
+static void remove_unreferenced(const std::vector<std::string> &files)
+{
+	for (const auto &f : files) {
+		if (f.empty() || bundle_file_referenced(f))
+			continue;
+		const std::string path = join_path(g_bundles.dir, f);
+		forget_written_file(path);
+		if (QFile::remove(QString::fromStdString(path)))
+			LOGD("Removed old bundle file %s", f.c_str());
+	}
+}
+
+static void save_bundle_manifest()
+{
+	QJsonArray gens;
+	for (const auto &g : g_bundles.gens) {
+		QJsonArray patches;
+		for (const auto &p : g.patch_css)
+			patches.append(QString::fromStdString(p));
+		QJsonArray assets;
+		for (const auto &a : g.assets)
+			assets.append(QString::fromStdString(a));
+
+		QJsonObject o;
+		o["html"] = QString::fromStdString(g.html);
+		o["css"] = QString::fromStdString(g.css);
+		o["js"] = QString::fromStdString(g.js);
+		o["patchCss"] = patches;
+		o["assets"] = assets;
+		o["created"] = (qint64)g.created_ms;
+		gens.append(o);
+	}
+
+	QJsonArray discarded;
+	for (const auto &f : g_bundles.discarded)
+		discarded.append(QString::fromStdString(f));
+
+	QJsonObject root;
+	root["generations"] = gens;
+	root["discarded"] = discarded;
+	const std::string path = join_path(g_bundles.dir, kBundleManifestName);
+	if (!write_text_file(path, QJsonDocument(root).toJson(QJsonDocument::Compact).toStdString()))
+		LOGW("Failed writing %s", path.c_str());
+}
+
+// Output dirs from before the manifest hold lt.css, lt.js and one lt-<timestamp>.html; adopt them as a
+// generation so they are collected like any other. This is the only directory scan left.
+static void adopt_legacy_bundle()
+{
+	const std::string html = find_latest_lt_html();
+	if (html.empty())
+		return;
+
+	bundle_generation g;
+	g.html = QFileInfo(QString::fromStdString(html)).fileName().toStdString();
+	g.css = "lt.css";
+	g.js = "lt.js";
+	g_bundles.gens.push_back(std::move(g));
+	save_bundle_manifest();
+}
+
+// Points g_bundles at the current output dir, reading its manifest on a dir change.
+static void sync_bundle_manifest()
+{
+	const std::string dir = output_dir();
+	if (dir == g_bundles.dir)
+		return;
+
+	g_bundles = bundle_manifest();
+	g_bundles.dir = dir;
+	if (dir.empty())
+		return;
+
+	const std::string txt = read_text_file(join_path(dir, kBundleManifestName));
+	if (txt.empty()) {
+		adopt_legacy_bundle();
+		return;
+	}
 
-			auto it = kfNameToNorm.find(kf.name);
-			if (it == kfNameToNorm.end()) {
+	const QJsonDocument doc = QJsonDocument::fromJson(QByteArray::fromStdString(txt));
+	for (const auto &v : doc.object().value("generations").toArray()) {
+		const QJsonObject o = v.toObject();
+		bundle_generation g;
+		g.html = o.value("html").toString().toStdString();
+		g.css = o.value("css").toString().toStdString();
+		g.js = o.value("js").toString().toStdString();
+		for (const auto &p : o.value("patchCss").toArray())
+			g.patch_css.push_back(p.toString().toStdString());
+		for (const auto &a : o.value("assets").toArray())
+			g.assets.push_back(a.toString().toStdString());
+		g.created_ms = (int64_t)o.value("created").toDouble();
+		if (!g.html.empty())
+			g_bundles.gens.push_back(std::move(g));
+	}
+	for (const auto &f : doc.object().value("discarded").toArray()) {
+		const std::string name = f.toString().toStdString();
+		if (is_plain_file_name(name))
+			g_bundles.discarded.push_back(name);
+	}
+}
 
-				kfNameToNorm[kf.name] = kf.norm;
-				kfNameToBlock[kf.name] = kf.block;
-				kfOrder.push_back(kf.name);
-				continue;
-			}
+// The browser source was swapped to page `g`: it becomes the newest generation.
+static void record_bundle_page(bundle_generation g)
+{
+	std::vector<std::string> dropped;
+	auto same = std::find_if(g_bundles.gens.begin(), g_bundles.gens.end(),
+				 [&](const bundle_generation &e) { return e.html == g.html; });
+	if (same != g_bundles.gens.end()) {
+		// Reloaded, so the patch stylesheets of its earlier life are gone from the page.
+		dropped = same->patch_css;
+		g_bundles.gens.erase(same);
+	}
 
-			if (it->second == kf.norm) {
+	g.created_ms = QDateTime::currentMSecsSinceEpoch();
+	g_bundles.gens.insert(g_bundles.gens.begin(), std::move(g));
 
-				continue;
-			}
+	while (g_bundles.gens.size() > kKeepBundleGenerations) {
+		const bundle_generation &old = g_bundles.gens.back();
+		dropped.insert(dropped.end(), {old.html, old.css, old.js});
+		dropped.insert(dropped.end(), old.patch_css.begin(), old.patch_css.end());
+		g_bundles.gens.pop_back();
+	}
 
-			const std::string oldName = kf.name;
-			const std::string newName = oldName + "_" + c.id;
+	save_bundle_manifest();
+	remove_unreferenced(dropped);
+}
 
-			const std::string fromHdr = kf.at_rule + std::string(" ") + oldName;
-			const std::string toHdr = kf.at_rule + std::string(" ") + newName;
-			kf.block = replace_all(kf.block, fromHdr, toHdr);
-			kf.name = newName;
-			kf.norm = normalize_ws_no_space(kf.block);
+// Discards queued by any thread; the rebuild worker moves them into the manifest (see collect_discarded).
+static std::mutex g_discard_mx;
+static std::vector<std::pair<std::string, std::string>> g_discard_queue; // (dir, file)
 
-			per = replace_whole_ident(per, oldName, newName);
+void discard_output_file(const std::string &dir, const std::string &file)
+{
+	if (dir.empty() || !is_plain_file_name(file))
+		return;
+	std::lock_guard<std::mutex> lk(g_discard_mx);
+	g_discard_queue.emplace_back(dir, file);
+}
 
-			kfNameToNorm[kf.name] = kf.norm;
-			kfNameToBlock[kf.name] = kf.block;
-			kfOrder.push_back(kf.name);
-		}
+// Deletes the discarded assets that no kept generation and no item of `state` loads any more; the
+// others wait in lt-bundles.json for the generations that load them to be dropped. Worker only.
+static void collect_discarded(const state_snapshot &state)
+{
+	std::lock_guard<std::mutex> lk(g_build_mx);
+	sync_bundle_manifest();
 
-		lower_third_cfg tmp = c;
-		tmp.css_template = per;
-		css += "\n" + scope_css_best_effort(tmp);
+	std::vector<std::pair<std::string, std::string>> queued;
+	{
+		std::lock_guard<std::mutex> qlk(g_discard_mx);
+		queued.swap(g_discard_queue);
 	}
 
-	css += "\n/* Keyframes (deduped) */\n";
-	{
-		std::unordered_set<std::string> emitted;
-		for (const auto &name : kfOrder) {
-			if (!emitted.insert(name).second)
-				continue;
-			auto it = kfNameToBlock.find(name);
-			if (it != kfNameToBlock.end()) {
-				css += "\n" + it->second + "\n";
-			}
+	bool changed = false;
+	for (auto &[dir, file] : queued) {
+		if (dir != g_bundles.dir) {
+			// No longer the output dir: no overlay can roll back to its pages.
+			QFile::remove(QString::fromStdString(join_path(dir, file)));
+		} else if (std::find(g_bundles.discarded.begin(), g_bundles.discarded.end(), file) ==
+			   g_bundles.discarded.end()) {
+			g_bundles.discarded.push_back(std::move(file));
+			changed = true;
 		}
 	}
 
-	const std::string cssPath = bundle_styles_path(ts);
-	if (cssPath.empty() || !write_text_file(cssPath, css)) {
-		LOGW("Failed writing %s", cssPath.empty() ? "<empty css path>" : cssPath.c_str());
+	auto in_use = [&](const std::string &file) {
+		if (bundle_file_referenced(file) || avatar::variant_in_use(g_bundles.dir, file))
+			return true;
+		for (const auto &c : *state.items) {
+			if (c.profile_picture == file || c.anim_in_sound == file || c.anim_out_sound == file)
+				return true;
+		}
 		return false;
-	}
-
-	std::string js;
-	js += build_base_script(g_items);
-	js += "\n\n/* Per-LT scripts */\n";
-	for (const auto &c : g_items)
-		js += build_item_script(c);
+	};
 
-	const std::string jsPath = bundle_scripts_path(ts);
-	if (jsPath.empty() || !write_text_file(jsPath, js)) {
-		LOGW("Failed writing %s", jsPath.empty() ? "<empty js path>" : jsPath.c_str());
-		return false;
+	for (auto it = g_bundles.discarded.begin(); it != g_bundles.discarded.end();) {
+		if (in_use(*it)) {
+			++it;
+			continue;
+		}
+		const std::string path = join_path(g_bundles.dir, *it);
+		forget_written_file(path);
+		if (QFile::remove(QString::fromStdString(path)))
+			LOGD("Removed discarded asset %s", it->c_str());
+		it = g_bundles.discarded.erase(it);
+		changed = true;
 	}
 
-	return true;
+	if (changed)
+		save_bundle_manifest();
 }
 
-static std::string generate_bundle_html(const std::string &ts, const std::string &cssFile, const std::string &jsFile)
+// A hot patch moved the loaded page to stylesheet `css` and made it load `assets` too.
+static void record_bundle_patch(const std::string &css, const std::vector<std::string> &assets)
 {
-	if (!has_output_dir())
-		return {};
+	if (g_bundles.gens.empty())
+		return;
 
-	const std::string abs = bundle_html_path(ts);
-	if (abs.empty())
-		return {};
+	bundle_generation &g = g_bundles.gens.front();
+	bool changed = false;
+	for (const auto &a : assets) {
+		if (std::find(g.assets.begin(), g.assets.end(), a) == g.assets.end()) {
+			g.assets.push_back(a);
+			changed = true;
+		}
+	}
 
-	if (!write_text_file(abs, build_full_html(ts, cssFile, jsFile)))
-		return {};
-	return abs;
+	std::vector<std::string> dropped;
+	if (css != g.css && (g.patch_css.empty() || g.patch_css.back() != css)) {
+		g.patch_css.erase(std::remove(g.patch_css.begin(), g.patch_css.end(), css), g.patch_css.end());
+		g.patch_css.push_back(css);
+		while (g.patch_css.size() > kKeepPatchStyles) {
+			dropped.push_back(g.patch_css.front());
+			g.patch_css.erase(g.patch_css.begin());
+		}
+		changed = true;
+	}
+	if (!changed)
+		return;
+
+	save_bundle_manifest();
+	remove_unreferenced(dropped);
 }
 
-static obs_source_t *get_target_browser_source()
-{
-	if (g_target_browser_source.empty())
-		return nullptr;
+// -------------------------
+// Hot patches
+// -------------------------
+// The page the target browser source was last fully loaded with. While its base script and head
+// still match, rebuilds are delivered as lt-patch.json (a diff against this page, cumulative since
+// the load) and applied to the live DOM instead of reloading the source.
+struct loaded_page {
+	bool known = false;      // item_hashes describe what the page was built from
+	std::string dir;         // output dir the page lives in
+	std::string html_digest; // content_digest() of its HTML
+	std::string base_id;     // data-slt-base of the page
+	std::string base_sig;    // digest of the base script + head it was built with
+	std::unordered_map<std::string, uint64_t> item_hashes;
+	std::unordered_set<std::string> touched; // ids patched since the load; always re-sent
+	std::string patch_digest;                // last patch written, minus its revision
+};
 
-	return obs_get_source_by_name(g_target_browser_source.c_str());
+static loaded_page g_page;
+static uint64_t g_patch_rev = 0;
+
+static bool write_patch_json(QJsonObject patch)
+{
+	patch["rev"] = (qint64)++g_patch_rev;
+	return write_text_file(path_patch_json(), QJsonDocument(patch).toJson(QJsonDocument::Compact).toStdString());
 }
 
-std::vector<std::string> list_browser_source_names()
+static bool write_hot_patch(const std::vector<lower_third_cfg> &cfgs, const std::vector<const item_fragments *> &frags,
+			    const std::string &cssHref, const output_options &opts)
 {
-	std::vector<std::string> out;
+	QJsonObject items;
+	QJsonArray order;
+	QJsonArray removed;
+	size_t changed = 0;
+
+	std::unordered_set<std::string> current;
+	current.reserve(frags.size() * 2 + 1);
+
+	for (size_t i = 0; i < frags.size(); ++i) {
+		const std::string &id = cfgs[i].id;
+		const item_fragments &f = *frags[i];
+
+		current.insert(id);
+		order.append(QString::fromStdString(id));
+
+		auto it = g_page.item_hashes.find(id);
+		const bool differs = (it == g_page.item_hashes.end() || it->second != f.hash);
+		if (differs) {
+			g_page.touched.insert(id);
+			changed++;
+		} else if (g_page.touched.find(id) == g_page.touched.end()) {
+			continue;
+		}
 
-	auto enum_cb = [](void *param, obs_source_t *src) -> bool {
-		if (!src)
-			return true;
+		QJsonObject o;
+		o["hash"] = QString::fromStdString(f.hash_hex);
+		o["html"] = QString::fromStdString(finish_output(opts, f.html, minify::html));
+		o["js"] = QString::fromStdString(finish_output(opts, f.js, minify::js));
+		o["anim"] = QJsonDocument::fromJson(QByteArray::fromStdString(f.anim_json)).object();
+		items[QString::fromStdString(id)] = o;
+	}
 
-		const char *id = obs_source_get_id(src);
-		if (!id)
-			return true;
+	for (const auto &kv : g_page.item_hashes) {
+		if (current.find(kv.first) != current.end())
+			continue;
+		removed.append(QString::fromStdString(kv.first));
+		g_page.touched.insert(kv.first);
+	}
 
-		if (std::string(id) != sltBrowserSourceId)
-			return true;
+	QJsonObject patch;
+	patch["base"] = QString::fromStdString(g_page.base_id);
+	patch["css"] = QString::fromStdString(cssHref);
+	patch["order"] = order;
+	patch["items"] = items;
+	patch["removed"] = removed;
 
-		const char *name = obs_source_get_name(src);
-		if (name && *name) {
-			auto *vec = static_cast<std::vector<std::string> *>(param);
-			vec->push_back(std::string(name));
-		}
+	const std::string digest = content_digest(QJsonDocument(patch).toJson(QJsonDocument::Compact).toStdString());
+	if (digest == g_page.patch_digest) {
+		LOGI("Bundle unchanged; nothing to patch");
 		return true;
-	};
+	}
 
-	obs_enum_sources(enum_cb, &out);
+	if (!write_patch_json(patch)) {
+		LOGW("Failed writing %s", path_patch_json().c_str());
+		return false;
+	}
+	g_page.patch_digest = digest;
 
-	std::sort(out.begin(), out.end());
-	out.erase(std::unique(out.begin(), out.end()), out.end());
-	return out;
+	LOGI("Hot-patched overlay (rev %llu): %zu changed, %d removed", (unsigned long long)g_patch_rev, changed,
+	     (int)removed.size());
+	return true;
 }
 
-std::string target_browser_source_name()
+// -------------------------
+// Rebuild worker
+// -------------------------
+// Rebuild requests are cheap: they capture the current state snapshot and bump a generation. The
+// worker waits until requests pause for kRebuildDebounce (at most kRebuildMaxDelay after the first
+// one), builds the artifacts from the newest snapshot, and only hands the browser source swap and the
+// completion event to the main thread. A build that a newer request overtook is dropped there.
+static constexpr std::chrono::milliseconds kRebuildDebounce{120};
+static constexpr std::chrono::milliseconds kRebuildMaxDelay{1000};
+
+using rebuild_clock = std::chrono::steady_clock;
+
+struct rebuild_job {
+	uint64_t generation = 0;
+	state_ref state;
+	bool forced = false; // started by kRebuildMaxDelay while requests kept coming
+	output_options opts;
+};
+
+static std::mutex g_rebuild_mx;
+static std::condition_variable g_rebuild_cv;
+static std::thread g_rebuild_thread;
+static bool g_rebuild_stop = false;
+static uint64_t g_rebuild_requested = 0; // generation of the newest request
+static uint64_t g_rebuild_started = 0;   // generation the worker last picked up
+static state_ref g_rebuild_state;        // snapshot of the newest request
+static bool g_rollback_pending = false;
+static rebuild_clock::time_point g_rebuild_first; // oldest request not picked up yet
+static rebuild_clock::time_point g_rebuild_last;
+
+// A forced build is never superseded, so a steady stream of requests cannot starve the swap.
+static bool rebuild_superseded(const rebuild_job &job)
 {
-	return g_target_browser_source;
+	std::lock_guard<std::mutex> lk(g_rebuild_mx);
+	return !job.forced && g_rebuild_requested != job.generation;
 }
 
-bool set_target_browser_source_name(const std::string &name)
+enum class swap_outcome { Superseded, TimedOut, Kept, Swapped };
+
+// Main-thread half of a rebuild: switches the browser source to `html` (empty = the loaded page stays)
+// and announces the new artifacts. Captured by value: the queued call outlives a caller that timed out.
+// g_build_mx (held by `lk`) is released while the main thread runs it, so a main-thread command that
+// needs the build state never waits on a worker that waits on it.
+static swap_outcome commit_rebuild(const rebuild_job &job, const std::string &html, std::unique_lock<std::mutex> &lk)
 {
-	g_target_browser_source = name;
-	return save_global_config();
+	lk.unlock();
+	const swap_outcome out = cmd::call(
+		[job, html]() {
+			if (rebuild_superseded(job))
+				return swap_outcome::Superseded;
+
+			swap_outcome out = swap_outcome::Kept;
+			if (!html.empty()) {
+				if (target_browser_source_exists()) {
+					if (swap_target_browser_source_to_file(html))
+						out = swap_outcome::Swapped;
+				} else if (g_target_browser_source.empty()) {
+					LOGW("Rebuilt artifacts but did not swap: no target Browser Source selected.");
+				} else {
+					LOGW("Rebuilt artifacts but did not swap: target Browser Source '%s' missing or not a Browser Source.",
+					     g_target_browser_source.c_str());
+				}
+			}
+
+			core_event ev;
+			ev.type = event_type::ArtifactsRebuilt;
+			ev.count = (int64_t)job.state->items->size();
+			emit_core_event(ev);
+			return out;
+		},
+		swap_outcome::TimedOut, "rebuild_commit");
+	lk.lock();
+	return out;
 }
 
-int target_browser_width()
+// A build that failed (and was not overtaken by a newer request) is announced with ok = false, so
+// callers that only queued the request can still surface it.
+static void report_rebuild_failure(const rebuild_job &job)
 {
-	return g_target_browser_width;
+	cmd::post([job]() {
+		if (rebuild_superseded(job))
+			return;
+		core_event ev;
+		ev.type = event_type::ArtifactsRebuilt;
+		ev.ok = false;
+		ev.count = (int64_t)job.state->items->size();
+		emit_core_event(ev);
+	});
 }
 
-int target_browser_height()
+// The main thread did not take the swap in time: build the same state again (unless a newer request
+// does that anyway), so the overlay does not stay stale until the next edit.
+static void requeue_rebuild(const rebuild_job &job)
 {
-	return g_target_browser_height;
+	{
+		std::lock_guard<std::mutex> lk(g_rebuild_mx);
+		if (g_rebuild_stop || g_rebuild_requested != job.generation)
+			return;
+		g_rebuild_first = g_rebuild_last = rebuild_clock::now();
+		++g_rebuild_requested;
+	}
+	g_rebuild_cv.notify_one();
+	LOGW("Rebuild %llu not swapped in time; building again", (unsigned long long)job.generation);
 }
 
-bool set_target_browser_dimensions(int width, int height)
+static bool load_full_bundle(const rebuild_job &job, const std::vector<const item_fragments *> &frags,
+			     const std::string &cssFile, const std::string &css, const std::string &baseSig,
+			     const std::string &shownHtml, std::unique_lock<std::mutex> &lk)
 {
-	if (width < 1)
-		width = 1;
-	if (height < 1)
-		height = 1;
+	const std::vector<lower_third_cfg> &items = *job.state->items;
+	const bool single = job.opts.single_file;
+
+	const std::string js = finish_output(job.opts, build_merged_js(frags), minify::js, "script");
+	const std::string jsName = bundle_scripts_name(content_digest(js));
+	const std::string jsFile = single ? std::string() : jsName; // single-file pages embed it instead
+	if (!single) {
+		const std::string jsPath = output_path(jsFile);
+		if (jsPath.empty() || !write_text_file(jsPath, js)) {
+			LOGW("Failed writing %s", jsPath.empty() ? "<empty js path>" : jsPath.c_str());
+			remove_unreferenced({cssFile});
+			return false;
+		}
+	}
+	const std::string cssHref = "./" + cssFile;
+	const std::string jsHref = "./" + jsName;
 
-	g_target_browser_width = width;
-	g_target_browser_height = height;
+	std::string itemsHtml;
+	for (const auto *f : frags)
+		itemsHtml += f->html;
 
-	obs_source_t *src = get_target_browser_source();
-	if (src) {
-		obs_data_t *s = obs_source_get_settings(src);
-		obs_data_set_int(s, "width", (int64_t)g_target_browser_width);
-		obs_data_set_int(s, "height", (int64_t)g_target_browser_height);
-		obs_source_update(src, s);
-		obs_data_release(s);
-		obs_source_release(src);
+	std::string head, tail;
+	if (single)
+		inline_asset_tags(css, js, head, tail);
+	else
+		linked_asset_tags(cssHref, jsHref, head, tail);
+
+	const std::string baseId = digest_hex(content_digest(cssHref + jsHref + itemsHtml));
+	const std::string html =
+		finish_output(job.opts, build_full_html(baseId, head, tail, itemsHtml), minify::html, "page");
+	const std::string htmlDigest = content_digest(html);
+
+	// Whatever lt-patch.json describes belongs to the previous page; point it at this one first.
+	QJsonObject reset;
+	reset["base"] = QString::fromStdString(baseId);
+	write_patch_json(reset);
+
+	bool live = false;
+	if (htmlDigest == g_page.html_digest && !g_last_html_path.empty() && file_exists(g_last_html_path) &&
+	    shownHtml == g_last_html_path) {
+		// Nothing the overlay can see changed: keep the loaded page instead of forcing a reload.
+		LOGI("Bundle unchanged; browser source reload skipped");
+		if (commit_rebuild(job, std::string(), lk) == swap_outcome::TimedOut)
+			requeue_rebuild(job);
+		live = true;
+	} else {
+		bundle_generation gen;
+		gen.html = bundle_html_name(htmlDigest);
+		gen.css = cssFile;
+		gen.js = jsFile;
+		gen.assets = fragment_assets(frags);
+
+		const std::string newHtml = generate_bundle_html(gen.html, html);
+		if (newHtml.empty()) {
+			remove_unreferenced({cssFile, jsFile});
+			return false;
+		}
+
+		const swap_outcome out = commit_rebuild(job, newHtml, lk);
+		if (out == swap_outcome::Superseded) {
+			LOGD("Rebuild %llu superseded before its swap", (unsigned long long)job.generation);
+			remove_unreferenced({gen.html, gen.css, gen.js});
+		} else if (out == swap_outcome::TimedOut) {
+			remove_unreferenced({gen.html, gen.css, gen.js});
+			requeue_rebuild(job);
+		} else {
+			live = (out == swap_outcome::Swapped);
+			g_last_html_path = newHtml;
+			record_bundle_page(std::move(gen));
+		}
 	}
 
-	return save_global_config();
+	g_page = loaded_page();
+	if (live) {
+		g_page.known = true;
+		g_page.dir = output_dir();
+		g_page.html_digest = htmlDigest;
+		g_page.base_id = baseId;
+		g_page.base_sig = baseSig;
+		for (size_t i = 0; i < frags.size(); ++i)
+			g_page.item_hashes[items[i].id] = frags[i]->hash;
+	}
+	return true;
 }
 
-bool target_browser_source_exists()
+// Runs on the rebuild worker. g_build_mx is only released around calls into the main thread.
+static bool run_rebuild(const rebuild_job &job)
 {
-	obs_source_t *src = get_target_browser_source();
-	if (!src)
+	std::unique_lock<std::mutex> lk(g_build_mx);
+	if (!has_output_dir())
 		return false;
 
-	const char *id = obs_source_get_id(src);
-	const bool ok = (id && std::string(id) == sltBrowserSourceId);
+	sync_bundle_manifest();
 
-	obs_source_release(src);
-	return ok;
-}
+	const std::vector<lower_third_cfg> &items = *job.state->items;
+	const auto frags = refresh_fragment_cache(items);
 
-static void refreshSourceSettings(obs_source_t *s)
-{
-	if (!s)
-		return;
+	// Compiling is the expensive part; a newer request will build again, so nothing is written.
+	if (rebuild_superseded(job)) {
+		LOGD("Rebuild %llu superseded", (unsigned long long)job.generation);
+		return true;
+	}
 
-	obs_data_t *data = obs_source_get_settings(s);
-	obs_source_update(s, data);
-	obs_data_release(data);
+	// Single-file pages still get the stylesheet file: hot patches switch the page over to it.
+	std::string cssFile, css;
+	if (!regenerate_merged_css(items, frags, job.opts, cssFile, css))
+		return false;
 
-	if (strcmp(obs_source_get_id(s), "browser_source") == 0) {
-		obs_properties_t *sourceProperties = obs_source_properties(s);
-		obs_property_t *property = obs_properties_get(sourceProperties, "refreshnocache");
-		if (property)
-			obs_property_button_clicked(property, s);
-		obs_properties_destroy(sourceProperties);
+	lk.unlock();
+	const std::string shownHtml =
+		cmd::call([]() { return target_browser_source_file(); }, std::string(), "rebuild_target_file");
+	lk.lock();
+
+	// Nothing reaches lt-patch.json (or a new page) for a build a newer request already overtook.
+	if (rebuild_superseded(job)) {
+		LOGD("Rebuild %llu superseded", (unsigned long long)job.generation);
+		remove_unreferenced({cssFile});
+		return true;
 	}
+
+	// A full reload is only needed when the page itself (base script, head) would differ, or when the
+	// browser source is not showing the page we know about.
+	const std::string baseSig = content_digest(build_base_script() + job.opts.tag());
+	const bool pageLive = g_page.known && g_page.dir == output_dir() && g_page.base_sig == baseSig &&
+			      !g_last_html_path.empty() && file_exists(g_last_html_path) && shownHtml == g_last_html_path;
+
+	if (pageLive) {
+		if (!write_hot_patch(items, frags, "./" + cssFile, job.opts)) {
+			remove_unreferenced({cssFile});
+			return false;
+		}
+		record_bundle_patch(cssFile, fragment_assets(frags));
+		if (commit_rebuild(job, std::string(), lk) == swap_outcome::TimedOut)
+			requeue_rebuild(job);
+		return true;
+	}
+
+	return load_full_bundle(job, frags, cssFile, css, baseSig, shownHtml, lk);
 }
 
-bool swap_target_browser_source_to_file(const std::string &absoluteHtmlPath)
+// Runs on the rebuild worker: swaps back to the generation before the loaded one and forgets the
+// loaded one. The next rebuild starts from the current state again.
+static bool run_rollback(const rebuild_job &job)
 {
-	if (absoluteHtmlPath.empty())
-		return false;
+	std::unique_lock<std::mutex> lk(g_build_mx);
+	sync_bundle_manifest();
 
-	obs_source_t *src = get_target_browser_source();
-	if (!src) {
-		if (g_target_browser_source.empty())
-			LOGW("No target Browser Source selected.");
-		else
-			LOGW("Target Browser Source '%s' not found.", g_target_browser_source.c_str());
+	if (g_bundles.gens.size() < 2) {
+		LOGW("No earlier overlay generation to roll back to");
 		return false;
 	}
 
-	const char *id = obs_source_get_id(src);
-	if (!id || std::string(id) != sltBrowserSourceId) {
-		LOGW("Target source '%s' is not a Browser Source.", g_target_browser_source.c_str());
-		obs_source_release(src);
+	const bundle_generation prev = g_bundles.gens[1];
+	const std::string html = join_path(g_bundles.dir, prev.html);
+	if (!file_exists(html)) {
+		LOGW("Cannot roll back: %s is missing", prev.html.c_str());
 		return false;
 	}
+	if (commit_rebuild(job, html, lk) != swap_outcome::Swapped)
+		return false;
 
-	obs_data_t *s = obs_source_get_settings(src);
-	const char *prevPathC = obs_data_get_string(s, "local_file");
-	const std::string prevPath = prevPathC ? std::string(prevPathC) : std::string();
+	bundle_generation dropped = std::move(g_bundles.gens.front());
+	g_bundles.gens.erase(g_bundles.gens.begin());
+	save_bundle_manifest();
 
-	if (!prevPath.empty() && prevPath == absoluteHtmlPath) {
-		obs_data_set_string(s, "local_file", "");
-		obs_source_update(src, s);
-	}
-	obs_data_set_bool(s, "is_local_file", true);
-	obs_data_set_string(s, "local_file", absoluteHtmlPath.c_str());
+	std::vector<std::string> files = std::move(dropped.patch_css);
+	files.insert(files.end(), {dropped.html, dropped.css, dropped.js});
+	remove_unreferenced(files);
 
-	obs_data_set_bool(s, "is_control_audio", true);
-	obs_data_set_bool(s, "control_audio", true);
-	obs_data_set_bool(s, "reroute_audio", true);
+	// Item hashes are unknown again, so the next rebuild does a full load.
+	g_last_html_path = html;
+	g_page = loaded_page();
+	g_page.html_digest = content_digest(read_text_file(html));
 
-	obs_data_set_bool(s, "smart_lt_managed", true);
-	obs_data_set_int(s, "width", (int64_t)g_target_browser_width);
-	obs_data_set_int(s, "height", (int64_t)g_target_browser_height);
-	obs_source_update(src, s);
+	LOGI("Overlay rolled back to %s", prev.html.c_str());
+	return true;
+}
 
-	obs_data_release(s);
+static void rebuild_thread_main()
+{
+	std::unique_lock<std::mutex> lk(g_rebuild_mx);
+	while (true) {
+		// Pending work is dropped at shutdown: the command queue is gone, so nothing could be swapped.
+		// The state is saved; init_from_disk() builds it on the next load.
+		if (g_rebuild_stop)
+			return;
+
+		if (g_rollback_pending) {
+			rebuild_job job;
+			job.state = g_rebuild_state;
+			job.forced = true;
+			g_rollback_pending = false;
+
+			lk.unlock();
+			run_rollback(job);
+			collect_discarded(*snapshot());
+			lk.lock();
+			continue;
+		}
 
-	refreshSourceSettings(src);
-	obs_source_release(src);
-	return true;
+		if (g_rebuild_started == g_rebuild_requested) {
+			g_rebuild_cv.wait(lk);
+			continue;
+		}
+
+		const auto now = rebuild_clock::now();
+		const auto quiet = g_rebuild_last + kRebuildDebounce;
+		const auto deadline = g_rebuild_first + kRebuildMaxDelay;
+		if (now < quiet && now < deadline) {
+			g_rebuild_cv.wait_until(lk, std::min(quiet, deadline));
+			continue;
+		}
+
+		rebuild_job job;
+		job.generation = g_rebuild_requested;
+		job.state = g_rebuild_state;
+		job.forced = now < quiet;
+		job.opts.minify = g_minify_output;
+		job.opts.single_file = g_single_file_output;
+		g_rebuild_started = job.generation;
+
+		lk.unlock();
+		if (!run_rebuild(job)) {
+			LOGW("Overlay rebuild %llu failed", (unsigned long long)job.generation);
+			report_rebuild_failure(job);
+		}
+		collect_discarded(*snapshot());
+		lk.lock();
+	}
 }
 
-bool rebuild_and_swap()
+// Caller holds g_rebuild_mx.
+static void ensure_rebuild_thread()
+{
+	if (!g_rebuild_thread.joinable())
+		g_rebuild_thread = std::thread(rebuild_thread_main);
+}
+
+static bool rebuild_and_swap_now()
 {
 	if (!has_output_dir())
 		return false;
 
 	ensure_output_artifacts_exist();
 
-	const std::string ts = now_timestamp_string();
-	std::string cssFile, jsFile;
-	if (!regenerate_merged_css_js(ts, cssFile, jsFile))
-		return false;
+	const state_ref state = snapshot();
+	const auto now = rebuild_clock::now();
+	{
+		std::lock_guard<std::mutex> lk(g_rebuild_mx);
+		if (g_rebuild_stop)
+			return false;
+		if (g_rebuild_started == g_rebuild_requested)
+			g_rebuild_first = now;
+		g_rebuild_last = now;
+		g_rebuild_state = state;
+		++g_rebuild_requested;
+		ensure_rebuild_thread();
+	}
+	g_rebuild_cv.notify_one();
+	return true;
+}
 
-	const std::string newHtml = generate_bundle_html(ts, cssFile, jsFile);
-	if (newHtml.empty())
+static bool rollback_bundle_now()
+{
+	if (!has_output_dir())
 		return false;
 
-	cleanup_old_bundles(1);
+	const state_ref state = snapshot();
+	{
+		std::lock_guard<std::mutex> lk(g_rebuild_mx);
+		if (g_rebuild_stop)
+			return false;
+		if (!g_rebuild_state)
+			g_rebuild_state = state;
+		g_rollback_pending = true;
+		ensure_rebuild_thread();
+	}
+	g_rebuild_cv.notify_one();
+	return true;
+}
 
-	if (target_browser_source_exists()) {
-		swap_target_browser_source_to_file(newHtml);
-	} else {
-		if (g_target_browser_source.empty()) {
-			LOGW("Rebuilt artifacts but did not swap: no target Browser Source selected.");
-		} else {
-			LOGW("Rebuilt artifacts but did not swap: target Browser Source '%s' missing or not a Browser Source.",
-			     g_target_browser_source.c_str());
-		}
+void shutdown_rebuild_worker()
+{
+	{
+		std::lock_guard<std::mutex> lk(g_rebuild_mx);
+		g_rebuild_stop = true;
 	}
+	g_rebuild_cv.notify_one();
+	if (g_rebuild_thread.joinable())
+		g_rebuild_thread.join();
 
-	g_last_html_path = newHtml;
-	return true;
+	// Discards queued since the last build would be lost; park them in lt-bundles.json.
+	collect_discarded(*snapshot());
+
+	std::lock_guard<std::mutex> lk(g_rebuild_mx);
+	g_rebuild_state.reset();
+}
+
+// -------------------------
+// Output options
+// -------------------------
+bool minify_output()
+{
+	return g_minify_output;
+}
+
+// Persists a changed output option and rebuilds with it.
+static bool set_output_option_now(std::atomic<bool> &option, bool on)
+{
+	if (option == on)
+		return true;
+
+	option = on;
+	const bool saved = save_global_config();
+	if (has_output_dir())
+		rebuild_and_swap_now();
+	return saved;
+}
+
+bool single_file_output()
+{
+	return g_single_file_output;
 }
 
 void notify_list_updated(const std::string &id)
@@ -2052,10 +3995,10 @@ void notify_list_updated(const std::string &id)
 	l.reason = list_change_reason::Update;
 	l.id2 = id;
 	l.count = (int64_t)g_items.size();
-	emit_event(l);
+	emit_core_event(l);
 }
 
-bool reload_from_disk_and_rebuild()
+static bool reload_from_disk_and_rebuild_now()
 {
 	if (!has_output_dir())
 		return false;
@@ -2064,30 +4007,33 @@ bool reload_from_disk_and_rebuild()
 
 	const bool okState = load_state_json();
 	const bool okVis = load_visible_json();
-	const bool okReb = rebuild_and_swap();
-	const bool ok = okState && okVis && okReb;
+	const bool ok = okState && okVis;
+	rebuild_and_swap();
 
 	core_event r;
 	r.type = event_type::Reloaded;
 	r.ok = ok;
 	r.count = (int64_t)g_items.size();
-	emit_event(r);
+	emit_core_event(r);
 
 	core_event l;
 	l.type = event_type::ListChanged;
 	l.reason = list_change_reason::Reload;
 	l.count = (int64_t)g_items.size();
-	emit_event(l);
+	emit_core_event(l);
 
 	return ok;
 }
 
-bool set_output_dir_and_load(const std::string &dir)
+static bool set_output_dir_and_load_now(const std::string &dir)
 {
 	if (dir.empty())
 		return false;
 
-	g_output_dir = dir;
+	{
+		std::lock_guard<std::mutex> lk(g_output_dir_mx);
+		g_output_dir = dir;
+	}
 	ensure_dir(output_dir());
 
 	save_global_config();
@@ -2096,16 +4042,16 @@ bool set_output_dir_and_load(const std::string &dir)
 	load_state_json();
 	load_visible_json();
 
-	save_state_json();
+	const bool ok = save_state_json();
 	save_visible_json();
 
-	const bool ok = rebuild_and_swap();
+	rebuild_and_swap();
 
 	core_event l;
 	l.type = event_type::ListChanged;
 	l.reason = list_change_reason::Reload;
 	l.count = (int64_t)g_items.size();
-	emit_event(l);
+	emit_core_event(l);
 
 	return ok;
 }
@@ -2114,19 +4060,28 @@ void init_from_disk()
 {
 	load_global_config();
 
-	if (g_output_dir.empty())
+	if (!has_output_dir())
 		return;
 
 	ensure_dir(output_dir());
 	ensure_output_artifacts_exist();
 	load_state_json();
 	load_visible_json();
+	publish_state();
 
-	g_last_html_path = find_latest_lt_html();
+	std::lock_guard<std::mutex> lk(g_build_mx);
+	sync_bundle_manifest();
+	if (!g_bundles.gens.empty())
+		g_last_html_path = join_path(g_bundles.dir, g_bundles.gens.front().html);
 
 	if (!g_last_html_path.empty() && file_exists(g_last_html_path)) {
 		if (target_browser_source_exists()) {
-			swap_target_browser_source_to_file(g_last_html_path);
+			if (swap_target_browser_source_to_file(g_last_html_path)) {
+				// Item hashes are unknown, so the first rebuild does a full load (or adopts this
+				// page when it comes out byte-identical).
+				g_page = loaded_page();
+				g_page.html_digest = content_digest(read_text_file(g_last_html_path));
+			}
 		} else {
 			if (!g_target_browser_source.empty()) {
 				LOGW("Saved target Browser Source '%s' not found (startup swap skipped).",
@@ -2134,19 +4089,28 @@ void init_from_disk()
 			}
 		}
 	}
+
+	// Edits saved after the newest page and patch were written were still pending at the last unload
+	// (the worker drops them then); build them now.
+	int64_t builtMs = g_bundles.gens.empty() ? 0 : g_bundles.gens.front().created_ms;
+	const QFileInfo patch(QString::fromStdString(path_patch_json()));
+	if (patch.exists())
+		builtMs = std::max<int64_t>(builtMs, patch.lastModified().toMSecsSinceEpoch());
+	const QFileInfo state(QString::fromStdString(path_state_json()));
+	if (!state.exists() || state.lastModified().toMSecsSinceEpoch() > builtMs)
+		rebuild_and_swap_now();
 }
 
-std::string add_default_group()
+static std::string add_default_group_now()
 {
 	if (!has_output_dir())
 		return {};
 
 	ensure_output_artifacts_exist();
-	load_state_json();
 
 	group_cfg c;
 	c.id = new_id();
-	while (get_group_by_id(c.id))
+	while (get_group_by_id_const(c.id))
 		c.id = new_id();
 
 	int maxOrder = -1;
@@ -2162,12 +4126,7 @@ std::string add_default_group()
 	c.interval_ms = 5000;
 	c.dock_color = "#2EA043";
 
-	g_groups.push_back(c);
-	std::sort(g_groups.begin(), g_groups.end(), [](const group_cfg &a, const group_cfg &b) {
-		if (a.order != b.order)
-			return a.order < b.order;
-		return a.id < b.id;
-	});
+	insert_group_sorted(c);
 
 	save_state_json();
 
@@ -2176,26 +4135,27 @@ std::string add_default_group()
 	l.reason = list_change_reason::Update;
 	l.id = c.id;
 	l.count = (int64_t)g_items.size();
-	emit_event(l);
+	emit_core_event(l);
 
 	return c.id;
 }
 
-bool update_group(const group_cfg &c)
+static bool update_group_now(const group_cfg &c)
 {
 	if (!has_output_dir())
 		return false;
 
 	ensure_output_artifacts_exist();
-	load_state_json();
 
 	group_cfg *dst = get_group_by_id(c.id);
 	if (!dst)
 		return false;
 
+	unindex_group_members(*dst);
 	*dst = c;
 	if (dst->order_mode != 1)
 		dst->order_mode = 0;
+	index_group_members(*dst);
 
 	for (const auto &mid : dst->members) {
 		if (auto *lt = get_by_id(mid)) {
@@ -2210,30 +4170,81 @@ bool update_group(const group_cfg &c)
 	l.reason = list_change_reason::Update;
 	l.id = c.id;
 	l.count = (int64_t)g_items.size();
-	emit_event(l);
+	emit_core_event(l);
 
 	return true;
 }
 
-bool remove_group(const std::string &group_id)
+static QString portable_hotkey(const std::string &hotkey)
+{
+	return QKeySequence(QString::fromStdString(hotkey)).toString(QKeySequence::PortableText).trimmed();
+}
+
+// Clears `hotkey` from every item and group but `keep_id`, without saving. The ids of the items that
+// lost it are appended to `clearedItems`; true when a group lost it.
+static bool clear_hotkey_nosave(const std::string &hotkey, const std::string &keep_id,
+				std::vector<std::string> &clearedItems)
+{
+	const QString seq = portable_hotkey(hotkey);
+	if (seq.isEmpty())
+		return false;
+
+	const size_t before = clearedItems.size();
+	bool clearedGroup = false;
+	for (auto &c : g_items) {
+		if (c.id != keep_id && !c.hotkey.empty() && portable_hotkey(c.hotkey) == seq) {
+			c.hotkey.clear();
+			clearedItems.push_back(c.id);
+		}
+	}
+	for (auto &g : g_groups) {
+		if (g.id != keep_id && !g.toggle_hotkey.empty() && portable_hotkey(g.toggle_hotkey) == seq) {
+			g.toggle_hotkey.clear();
+			clearedGroup = true;
+		}
+	}
+	g_items_dirty = g_items_dirty || clearedItems.size() > before;
+	g_groups_dirty = g_groups_dirty || clearedGroup;
+	return clearedGroup;
+}
+
+static bool release_hotkey_now(const std::string &hotkey, const std::string &keep_id)
 {
 	if (!has_output_dir())
 		return false;
 
-	ensure_output_artifacts_exist();
-	load_state_json();
+	std::vector<std::string> clearedItems;
+	const bool clearedGroup = clear_hotkey_nosave(hotkey, keep_id, clearedItems);
+	if (clearedItems.empty() && !clearedGroup)
+		return true;
 
-	const std::string sid = sanitize_id(group_id);
-	const auto before = g_groups.size();
+	save_state_json();
+
+	for (const auto &id : clearedItems)
+		notify_list_updated(id);
+	if (clearedGroup)
+		notify_list_updated();
+	return true;
+}
+
+static bool remove_group_now(const std::string &group_id)
+{
+	if (!has_output_dir())
+		return false;
 
-	g_groups.erase(std::remove_if(g_groups.begin(), g_groups.end(),
-					 [&](const group_cfg &c) { return c.id == sid; }),
-			  g_groups.end());
+	ensure_output_artifacts_exist();
 
-	const bool removed = (g_groups.size() != before);
-	if (!removed)
+	const std::string sid = sanitize_id(group_id);
+	auto slot = g_group_slot.find(sid);
+	if (slot == g_group_slot.end())
 		return false;
 
+	const size_t at = slot->second;
+	unindex_group_members(g_groups[at]);
+	g_group_slot.erase(slot);
+	g_groups.erase(g_groups.begin() + (std::ptrdiff_t)at);
+	reindex_groups(at);
+
 	save_state_json();
 
 	core_event l;
@@ -2241,23 +4252,23 @@ bool remove_group(const std::string &group_id)
 	l.reason = list_change_reason::Update;
 	l.id = sid;
 	l.count = (int64_t)g_items.size();
-	emit_event(l);
+	emit_core_event(l);
 
 	return true;
 }
 
-bool set_group_members(const std::string &group_id, const std::vector<std::string> &members)
+static bool set_group_members_now(const std::string &group_id, const std::vector<std::string> &members)
 {
 	if (!has_output_dir())
 		return false;
 
 	ensure_output_artifacts_exist();
-	load_state_json();
 
 	group_cfg *c = get_group_by_id(group_id);
 	if (!c)
 		return false;
 
+	unindex_group_members(*c);
 	c->members.clear();
 	c->members.reserve(members.size());
 	for (const auto &m : members) {
@@ -2265,16 +4276,10 @@ bool set_group_members(const std::string &group_id, const std::vector<std::strin
 		if (mid.empty())
 			continue;
 
-		bool ownedByOther = false;
-		for (const auto &other : g_groups) {
-			if (other.id == c->id)
-				continue;
-			if (std::find(other.members.begin(), other.members.end(), mid) != other.members.end()) {
-				ownedByOther = true;
-				break;
-			}
-		}
-		if (ownedByOther)
+		// A lower third belongs to at most one group; c's own entries were just unindexed.
+		if (g_member_groups.find(mid) != g_member_groups.end())
+			continue;
+		if (std::find(c->members.begin(), c->members.end(), mid) != c->members.end())
 			continue;
 
 		c->members.push_back(mid);
@@ -2284,6 +4289,7 @@ bool set_group_members(const std::string &group_id, const std::vector<std::strin
 			lt->repeat_visible_sec = 0;
 		}
 	}
+	index_group_members(*c);
 
 	save_state_json();
 
@@ -2292,22 +4298,21 @@ bool set_group_members(const std::string &group_id, const std::vector<std::strin
 	l.reason = list_change_reason::Update;
 	l.id = c->id;
 	l.count = (int64_t)g_items.size();
-	emit_event(l);
+	emit_core_event(l);
 
 	return true;
 }
 
-std::string add_default_lower_third()
+static std::string add_default_lower_third_now()
 {
+	const command_time start; // the new item is shown by this command
 	if (!has_output_dir())
 		return {};
 
 	ensure_output_artifacts_exist();
-	load_state_json();
-	load_visible_json();
 
 	lower_third_cfg c = default_cfg();
-	while (get_by_id(c.id))
+	while (get_by_id_const(c.id))
 		c.id = new_id();
 
 	int maxOrder = -1;
@@ -2317,20 +4322,14 @@ std::string add_default_lower_third()
 	if (c.label.empty())
 		c.label = c.title.empty() ? c.id : c.title;
 
-	g_items.push_back(c);
-	std::sort(g_items.begin(), g_items.end(), [](const lower_third_cfg &a, const lower_third_cfg &b) {
-		if (a.order != b.order)
-			return a.order < b.order;
-		return a.id < b.id;
-	});
+	insert_item_sorted(c);
 	set_visible_nosave(c.id, true);
 
 	if (!save_state_json())
 		return {};
 	save_visible_json();
 
-	if (!rebuild_and_swap())
-		return {};
+	rebuild_and_swap();
 
 	{
 		core_event l;
@@ -2338,36 +4337,38 @@ std::string add_default_lower_third()
 		l.reason = list_change_reason::Create;
 		l.id = c.id;
 		l.count = (int64_t)g_items.size();
-		emit_event(l);
+		emit_core_event(l);
 
 		core_event v;
 		v.type = event_type::VisibilityChanged;
 		v.id = c.id;
 		v.visible = true;
-		v.visible_ids = visible_ids();
-		emit_event(v);
+		v.visible_ids = visible_snapshot();
+		v.shown_ids = {c.id};
+		v.seq = begin_visibility_command({c.id}, start);
+		v.ts_ms = start.ts_ms;
+		emit_core_event(v);
 	}
 
 	return c.id;
 }
 
-std::string clone_lower_third(const std::string &id)
+static std::string clone_lower_third_now(const std::string &id)
 {
+	const command_time start;
 	if (!has_output_dir())
 		return {};
 
 	ensure_output_artifacts_exist();
-	load_state_json();
-	load_visible_json();
 
 	const std::string sid = sanitize_id(id);
-	lower_third_cfg *src = get_by_id(sid);
+	const lower_third_cfg *src = get_by_id_const(sid);
 	if (!src)
 		return {};
 
 	lower_third_cfg c = *src;
 	c.id = new_id();
-	while (get_by_id(c.id))
+	while (get_by_id_const(c.id))
 		c.id = new_id();
 
 	if (!c.title.empty())
@@ -2382,7 +4383,7 @@ std::string clone_lower_third(const std::string &id)
 
 	if (!c.profile_picture.empty()) {
 		const std::string srcRel = c.profile_picture;
-		const std::string srcPath = output_dir() + "/" + srcRel;
+		const std::string srcPath = asset_path(srcRel);
 
 		std::string ext;
 		const auto dot = srcRel.find_last_of('.');
@@ -2398,7 +4399,7 @@ std::string clone_lower_third(const std::string &id)
 		const std::string dstPath = output_dir() + "/" + newName;
 
 		std::error_code ec;
-		if (std::filesystem::exists(std::filesystem::path(srcPath), ec) && !ec) {
+		if (!srcPath.empty() && std::filesystem::exists(std::filesystem::path(srcPath), ec) && !ec) {
 			ec.clear();
 			std::filesystem::copy_file(std::filesystem::path(srcPath), std::filesystem::path(dstPath),
 						   std::filesystem::copy_options::overwrite_existing, ec);
@@ -2423,20 +4424,14 @@ std::string clone_lower_third(const std::string &id)
 
 	const std::string newId = c.id;
 
-	g_items.push_back(c);
-	std::sort(g_items.begin(), g_items.end(), [](const lower_third_cfg &a, const lower_third_cfg &b) {
-		if (a.order != b.order)
-			return a.order < b.order;
-		return a.id < b.id;
-	});
+	insert_item_sorted(c);
 	set_visible_nosave(newId, true);
 
 	if (!save_state_json())
 		return {};
 	save_visible_json();
 
-	if (!rebuild_and_swap())
-		return {};
+	rebuild_and_swap();
 
 	{
 		core_event l;
@@ -2445,80 +4440,67 @@ std::string clone_lower_third(const std::string &id)
 		l.id = sid;
 		l.id2 = newId;
 		l.count = (int64_t)g_items.size();
-		emit_event(l);
+		emit_core_event(l);
 
 		core_event v;
 		v.type = event_type::VisibilityChanged;
 		v.id = newId;
 		v.visible = true;
-		v.visible_ids = visible_ids();
-		emit_event(v);
+		v.visible_ids = visible_snapshot();
+		v.shown_ids = {newId};
+		v.seq = begin_visibility_command({newId}, start);
+		v.ts_ms = start.ts_ms;
+		emit_core_event(v);
 	}
 
 	return newId;
 }
 
-bool remove_lower_third(const std::string &id)
+static bool remove_lower_third_now(const std::string &id)
 {
 	if (!has_output_dir())
 		return false;
 
 	ensure_output_artifacts_exist();
-	load_state_json();
-	load_visible_json();
 
 	const std::string sid = sanitize_id(id);
-	const auto before = g_items.size();
+	auto slot = g_item_slot.find(sid);
+	if (slot == g_item_slot.end())
+		return false;
 
-	std::string profileToDelete;
-	std::string animInSoundToDelete;
-	std::string animOutSoundToDelete;
-	for (const auto &c : g_items) {
-		if (c.id == sid) {
-			profileToDelete = c.profile_picture;
-			animInSoundToDelete = c.anim_in_sound;
-			animOutSoundToDelete = c.anim_out_sound;
-			break;
-		}
-	}
+	const size_t at = slot->second;
+	const std::string profileToDelete = g_items[at].profile_picture;
+	const std::string animInSoundToDelete = g_items[at].anim_in_sound;
+	const std::string animOutSoundToDelete = g_items[at].anim_out_sound;
 
 	const bool wasVisible = is_visible(sid);
 
-	g_items.erase(std::remove_if(g_items.begin(), g_items.end(),
-				     [&](const lower_third_cfg &c) { return c.id == sid; }),
-		      g_items.end());
+	g_item_slot.erase(slot);
+	g_items.erase(g_items.begin() + (std::ptrdiff_t)at);
+	reindex_items(at);
+	forget_visibility_latency(sid);
 
-	const bool removed = (g_items.size() != before);
-	if (!removed)
-		return false;
-
-	if (!profileToDelete.empty()) {
-		const std::string fullPath = output_dir() + "/" + profileToDelete;
-		std::error_code ec;
-		(void)std::filesystem::remove(std::filesystem::path(fullPath), ec);
-	}
-
-	if (!animInSoundToDelete.empty()) {
-		const std::string fullPath = output_dir() + "/" + animInSoundToDelete;
-		std::error_code ec;
-		(void)std::filesystem::remove(std::filesystem::path(fullPath), ec);
-	}
-	if (!animOutSoundToDelete.empty()) {
-		const std::string fullPath = output_dir() + "/" + animOutSoundToDelete;
-		std::error_code ec;
-		(void)std::filesystem::remove(std::filesystem::path(fullPath), ec);
-	}
+	// Deleted once no page kept for rollback loads them; only files inside the output dir, whatever
+	// the item state says.
+	discard_output_file(output_dir(), animInSoundToDelete);
+	discard_output_file(output_dir(), animOutSoundToDelete);
+	avatar::discard_picture(output_dir(), profileToDelete);
 
 	set_visible_nosave(sid, false);
 
-	for (auto &car : g_groups) {
-		car.members.erase(std::remove(car.members.begin(), car.members.end(), sid), car.members.end());
+	auto owners = g_member_groups.find(sid);
+	if (owners != g_member_groups.end()) {
+		for (const auto &gid : owners->second) {
+			auto &members = g_groups[g_group_slot[gid]].members;
+			members.erase(std::remove(members.begin(), members.end(), sid), members.end());
+		}
+		g_member_groups.erase(owners);
 	}
 
-	save_state_json();
+	const bool ok = save_state_json();
 	save_visible_json();
 
-	const bool ok = rebuild_and_swap();
+	rebuild_and_swap();
 
 	{
 		core_event l;
@@ -2526,29 +4508,28 @@ bool remove_lower_third(const std::string &id)
 		l.reason = list_change_reason::Delete;
 		l.id = sid;
 		l.count = (int64_t)g_items.size();
-		emit_event(l);
+		emit_core_event(l);
 
 		if (wasVisible) {
 			core_event v;
 			v.type = event_type::VisibilityChanged;
 			v.id = sid;
 			v.visible = false;
-			v.visible_ids = visible_ids();
-			emit_event(v);
+			v.visible_ids = visible_snapshot();
+			v.hidden_ids = {sid};
+			emit_core_event(v);
 		}
 	}
 
 	return ok;
 }
 
-bool move_lower_third(const std::string &id, int delta)
+static bool move_lower_third_now(const std::string &id, int delta)
 {
 	if (!has_output_dir())
 		return false;
 
 	ensure_output_artifacts_exist();
-	load_state_json();
-	load_visible_json();
 
 	const std::string sid = sanitize_id(id);
 	if (sid.empty())
@@ -2557,21 +4538,19 @@ bool move_lower_third(const std::string &id, int delta)
 	if (g_items.size() < 2)
 		return false;
 
-	int idx = -1;
-	for (int i = 0; i < (int)g_items.size(); ++i) {
-		if (g_items[(size_t)i].id == sid) {
-			idx = i;
-			break;
-		}
-	}
-	if (idx < 0)
+	auto slot = g_item_slot.find(sid);
+	if (slot == g_item_slot.end())
 		return false;
+	const int idx = (int)slot->second;
 
 	const int newIdx = idx + delta;
 	if (newIdx < 0 || newIdx >= (int)g_items.size())
 		return false;
 
+	g_items_dirty = true;
 	std::swap(g_items[(size_t)idx], g_items[(size_t)newIdx]);
+	g_item_slot[g_items[(size_t)idx].id] = (size_t)idx;
+	g_item_slot[g_items[(size_t)newIdx].id] = (size_t)newIdx;
 	for (int i = 0; i < (int)g_items.size(); ++i)
 		g_items[(size_t)i].order = i;
 
@@ -2583,9 +4562,384 @@ bool move_lower_third(const std::string &id, int delta)
 	l.reason = list_change_reason::Update;
 	l.id = sid;
 	l.count = (int64_t)g_items.size();
-	emit_event(l);
+	emit_core_event(l);
+
+	return true;
+}
+
+static bool update_lower_third_now(const lower_third_cfg &c)
+{
+	if (!has_output_dir())
+		return false;
+
+	ensure_output_artifacts_exist();
+
+	lower_third_cfg *dst = get_by_id(c.id);
+	if (!dst)
+		return false;
+
+	const lower_third_cfg before = *dst;
+	*dst = c;
+	dst->order = before.order;
+	normalize_item(*dst, g_member_groups.count(dst->id) != 0);
+	if (!save_state_json()) {
+		*dst = before;
+		publish_state();
+		return false;
+	}
+	return true;
+}
+
+// -------------------------
+// Batch create / update
+// -------------------------
+static void apply_fields(lower_third_cfg &c, const lower_third_fields &f)
+{
+	auto str = [](std::string &dst, const std::optional<std::string> &v) {
+		if (v)
+			dst = *v;
+	};
+	auto num = [](int &dst, const std::optional<int> &v) {
+		if (v)
+			dst = *v;
+	};
+
+	str(c.label, f.label);
+	str(c.title, f.title);
+	str(c.subtitle, f.subtitle);
+	str(c.profile_picture, f.profile_picture);
+	str(c.anim_in, f.anim_in);
+	str(c.anim_out, f.anim_out);
+	str(c.font_family, f.font_family);
+	str(c.lt_position, f.lt_position);
+	str(c.primary_color, f.primary_color);
+	str(c.secondary_color, f.secondary_color);
+	str(c.title_color, f.title_color);
+	str(c.subtitle_color, f.subtitle_color);
+	str(c.hotkey, f.hotkey);
+
+	num(c.title_size, f.title_size);
+	num(c.subtitle_size, f.subtitle_size);
+	num(c.avatar_width, f.avatar_width);
+	num(c.avatar_height, f.avatar_height);
+	num(c.opacity, f.opacity);
+	num(c.radius, f.radius);
+	num(c.repeat_every_sec, f.repeat_every_sec);
+	num(c.repeat_visible_sec, f.repeat_visible_sec);
+
+	normalize_item(c, g_member_groups.count(c.id) != 0);
+
+	// A hotkey belongs to one item or group; like the dock, the newest assignment wins.
+	if (f.hotkey) {
+		std::vector<std::string> cleared;
+		clear_hotkey_nosave(c.hotkey, c.id, cleared);
+	}
+}
+
+// Batches name profile pictures by file name only: the file must already be in the output dir
+// (import_profile_picture() puts it there). Anything else would let a client point item state, and
+// the delete that follows it, at arbitrary paths.
+static bool validate_fields(const std::vector<lower_third_fields> &items, std::string *error)
+{
+	for (size_t i = 0; i < items.size(); ++i) {
+		const lower_third_fields &f = items[i];
+		const struct {
+			const char *name;
+			const std::optional<int> &value;
+			int_range range;
+		} nums[] = {
+			{"titleSize", f.title_size, kFontSizeRange},
+			{"subtitleSize", f.subtitle_size, kFontSizeRange},
+			{"avatarWidth", f.avatar_width, kAvatarSizeRange},
+			{"avatarHeight", f.avatar_height, kAvatarSizeRange},
+			{"opacity", f.opacity, kPercentRange},
+			{"radius", f.radius, kPercentRange},
+			{"repeatEverySec", f.repeat_every_sec, kRepeatSecRange},
+			{"repeatVisibleSec", f.repeat_visible_sec, kRepeatSecRange},
+		};
+		for (const auto &n : nums) {
+			if (n.value && (*n.value < n.range.lo || *n.value > n.range.hi)) {
+				if (error)
+					*error = "items[" + std::to_string(i) + "]." + n.name + " must be " +
+						 std::to_string(n.range.lo) + ".." + std::to_string(n.range.hi);
+				return false;
+			}
+		}
+
+		const auto &pic = f.profile_picture;
+		if (!pic || pic->empty())
+			continue;
+		const std::string path = asset_path(*pic);
+		if (path.empty() || !file_exists(path)) {
+			if (error)
+				*error = "items[" + std::to_string(i) + "].profilePicture must name a file in the output folder";
+			return false;
+		}
+	}
+	return true;
+}
+
+// Persists and announces a batch already applied to g_items (and the group hotkeys it took over), or
+// puts `before` / `groupsBefore` back if the write fails.
+static bool commit_item_batch(std::vector<lower_third_cfg> &before, std::vector<group_cfg> &groupsBefore,
+			      list_change_reason reason, std::string *error)
+{
+	if (!save_state_json()) {
+		g_items = std::move(before);
+		reindex_items();
+		g_groups = std::move(groupsBefore);
+		g_groups_dirty = true;
+		publish_state();
+		if (error)
+			*error = "Failed to write lt-state.json";
+		return false;
+	}
+
+	// The state is saved either way; a failed build is reported as ArtifactsRebuilt with ok = false.
+	rebuild_and_swap();
 
+	core_event l;
+	l.type = event_type::ListChanged;
+	l.reason = reason;
+	l.count = (int64_t)g_items.size();
+	emit_core_event(l);
 	return true;
 }
 
+static std::vector<std::string> create_lower_thirds_now(const std::vector<lower_third_fields> &items,
+							std::string *error)
+{
+	if (!has_output_dir()) {
+		if (error)
+			*error = "No output dir configured";
+		return {};
+	}
+	if (items.empty() || !validate_fields(items, error))
+		return {};
+
+	ensure_output_artifacts_exist();
+
+	std::vector<lower_third_cfg> before = g_items;
+	std::vector<group_cfg> groupsBefore = g_groups;
+
+	int order = -1;
+	for (const auto &it : g_items)
+		order = std::max(order, it.order);
+
+	std::vector<std::string> ids;
+	ids.reserve(items.size());
+	g_items.reserve(g_items.size() + items.size());
+	for (const auto &f : items) {
+		lower_third_cfg c = default_cfg();
+		while (get_by_id_const(c.id) || std::find(ids.begin(), ids.end(), c.id) != ids.end())
+			c.id = new_id();
+		apply_fields(c, f);
+		if (!f.label)
+			c.label = c.title.empty() ? c.id : c.title;
+		c.order = ++order;
+
+		ids.push_back(c.id);
+		g_items.push_back(std::move(c)); // highest order so far: stays sorted
+	}
+	reindex_items(before.size());
+
+	if (!commit_item_batch(before, groupsBefore, list_change_reason::Create, error))
+		return {};
+
+	LOGI("Created %d lower third(s) in one batch", (int)ids.size());
+	return ids;
+}
+
+static bool update_lower_thirds_now(const std::vector<lower_third_fields> &items, std::string *error)
+{
+	if (!has_output_dir()) {
+		if (error)
+			*error = "No output dir configured";
+		return false;
+	}
+	if (items.empty())
+		return true;
+	if (!validate_fields(items, error))
+		return false;
+
+	ensure_output_artifacts_exist();
+
+	for (const auto &f : items) {
+		if (f.id.empty() || !get_by_id_const(f.id)) {
+			if (error)
+				*error = "Unknown id: " + f.id;
+			return false;
+		}
+	}
+
+	std::vector<lower_third_cfg> before = g_items;
+	std::vector<group_cfg> groupsBefore = g_groups;
+	for (const auto &f : items)
+		apply_fields(*get_by_id(f.id), f);
+
+	return commit_item_batch(before, groupsBefore, list_change_reason::Update, error);
+}
+
+// -------------------------
+// Command queue wrappers
+// -------------------------
+// Every public mutation runs on the owner (Qt main) thread: inline when called there, otherwise queued
+// and waited for, so concurrent callers (websocket, workers) are serialized in submission order.
+
+bool set_visible_persist(const std::string &id, bool visible)
+{
+	return cmd::call([=]() { return set_visible_persist_now(id, visible); }, false, "set_visible_persist");
+}
+
+bool set_visible_batch(const std::vector<visibility_change> &changes, std::string *error)
+{
+	// The command may outlive a timed-out caller, so it never writes through `error` directly.
+	auto err = std::make_shared<std::string>();
+	const bool ok = cmd::call([changes, err]() { return set_visible_batch_now(changes, err.get()); }, false,
+				  "set_visible_batch");
+	if (error)
+		*error = *err;
+	return ok;
+}
+
+bool set_visible_set(const std::vector<std::string> &ids)
+{
+	return cmd::call([=]() { return set_visible_set_now(ids); }, false, "set_visible_set");
+}
+
+bool save_visibility_preset(const std::string &name, const std::vector<std::string> *ids)
+{
+	const bool useCurrent = !ids;
+	std::vector<std::string> copy = ids ? *ids : std::vector<std::string>();
+	return cmd::call(
+		[name, useCurrent, copy]() { return save_visibility_preset_now(name, useCurrent ? nullptr : &copy); },
+		false, "save_visibility_preset");
+}
+
+bool delete_visibility_preset(const std::string &name)
+{
+	return cmd::call([=]() { return delete_visibility_preset_now(name); }, false, "delete_visibility_preset");
+}
+
+bool recall_visibility_preset(const std::string &name)
+{
+	return cmd::call([=]() { return recall_visibility_preset_now(name); }, false, "recall_visibility_preset");
+}
+
+bool toggle_visible_persist(const std::string &id)
+{
+	return cmd::call([=]() { return toggle_visible_persist_now(id); }, false, "toggle_visible_persist");
+}
+
+bool set_target_browser_source_name(const std::string &name)
+{
+	return cmd::call([=]() { return set_target_browser_source_name_now(name); }, false, "set_target_browser_source_name");
+}
+
+bool set_target_browser_dimensions(int width, int height)
+{
+	return cmd::call([=]() { return set_target_browser_dimensions_now(width, height); }, false, "set_target_browser_dimensions");
+}
+
+bool set_minify_output(bool on)
+{
+	return cmd::call([=]() { return set_output_option_now(g_minify_output, on); }, false, "set_minify_output");
+}
+
+bool set_single_file_output(bool on)
+{
+	return cmd::call([=]() { return set_output_option_now(g_single_file_output, on); }, false,
+			 "set_single_file_output");
+}
+
+bool rebuild_and_swap()
+{
+	return cmd::call([]() { return rebuild_and_swap_now(); }, false, "rebuild_and_swap");
+}
+
+bool rollback_bundle()
+{
+	return cmd::call([]() { return rollback_bundle_now(); }, false, "rollback_bundle");
+}
+
+bool reload_from_disk_and_rebuild()
+{
+	return cmd::call([]() { return reload_from_disk_and_rebuild_now(); }, false, "reload_from_disk_and_rebuild");
+}
+
+bool set_output_dir_and_load(const std::string &dir)
+{
+	return cmd::call([=]() { return set_output_dir_and_load_now(dir); }, false, "set_output_dir_and_load");
+}
+
+std::string add_default_group()
+{
+	return cmd::call([]() { return add_default_group_now(); }, std::string(), "add_default_group");
+}
+
+bool update_group(const group_cfg &c)
+{
+	return cmd::call([=]() { return update_group_now(c); }, false, "update_group");
+}
+
+bool release_hotkey(const std::string &hotkey, const std::string &keep_id)
+{
+	return cmd::call([=]() { return release_hotkey_now(hotkey, keep_id); }, false, "release_hotkey");
+}
+
+bool remove_group(const std::string &group_id)
+{
+	return cmd::call([=]() { return remove_group_now(group_id); }, false, "remove_group");
+}
+
+bool set_group_members(const std::string &group_id, const std::vector<std::string> &members)
+{
+	return cmd::call([=]() { return set_group_members_now(group_id, members); }, false, "set_group_members");
+}
+
+std::string add_default_lower_third()
+{
+	return cmd::call([]() { return add_default_lower_third_now(); }, std::string(), "add_default_lower_third");
+}
+
+std::string clone_lower_third(const std::string &id)
+{
+	return cmd::call([=]() { return clone_lower_third_now(id); }, std::string(), "clone_lower_third");
+}
+
+bool remove_lower_third(const std::string &id)
+{
+	return cmd::call([=]() { return remove_lower_third_now(id); }, false, "remove_lower_third");
+}
+
+bool move_lower_third(const std::string &id, int delta)
+{
+	return cmd::call([=]() { return move_lower_third_now(id, delta); }, false, "move_lower_third");
+}
+
+bool update_lower_third(const lower_third_cfg &c)
+{
+	return cmd::call([=]() { return update_lower_third_now(c); }, false, "update_lower_third");
+}
+
+std::vector<std::string> create_lower_thirds(const std::vector<lower_third_fields> &items, std::string *error)
+{
+	auto err = std::make_shared<std::string>();
+	auto ids = cmd::call([items, err]() { return create_lower_thirds_now(items, err.get()); },
+			     std::vector<std::string>(), "create_lower_thirds");
+	if (error)
+		*error = *err;
+	return ids;
+}
+
+bool update_lower_thirds(const std::vector<lower_third_fields> &items, std::string *error)
+{
+	auto err = std::make_shared<std::string>();
+	const bool ok = cmd::call([items, err]() { return update_lower_thirds_now(items, err.get()); }, false,
+				  "update_lower_thirds");
+	if (error)
+		*error = *err;
+	return ok;
+}
+
 } // namespace smart_lt
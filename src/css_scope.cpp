@@ -0,0 +1,274 @@
+// css_scope.cpp
+#include "css_scope.hpp"
+
+#include <cctype>
+
+namespace smart_lt::css {
+
+namespace {
+
+constexpr size_t npos = std::string_view::npos;
+
+bool is_ident_char(char c)
+{
+	return std::isalnum((unsigned char)c) || c == '_' || c == '-';
+}
+
+// If p points at a comment or a string, advances p past it and returns true.
+bool skip_opaque(std::string_view s, size_t &p)
+{
+	if (s[p] == '/' && p + 1 < s.size() && s[p + 1] == '*') {
+		const size_t e = s.find("*/", p + 2);
+		p = (e == npos) ? s.size() : e + 2;
+		return true;
+	}
+	if (s[p] == '"' || s[p] == '\'') {
+		const char q = s[p++];
+		while (p < s.size() && s[p] != q && s[p] != '\n') {
+			if (s[p] == '\\' && p + 1 < s.size())
+				p++;
+			p++;
+		}
+		if (p < s.size() && s[p] == q)
+			p++;
+		return true;
+	}
+	return false;
+}
+
+// First occurrence of any char in `stops` outside strings, comments, () and [].
+size_t find_top_level(std::string_view s, size_t p, std::string_view stops)
+{
+	int depth = 0;
+	while (p < s.size()) {
+		if (skip_opaque(s, p))
+			continue;
+		const char c = s[p];
+		if (c == '(' || c == '[')
+			depth++;
+		else if ((c == ')' || c == ']') && depth > 0)
+			depth--;
+		else if (depth == 0 && stops.find(c) != npos)
+			return p;
+		p++;
+	}
+	return npos;
+}
+
+// p points at '{'; returns the index one past its matching '}' (or s.size() if unterminated).
+size_t match_block(std::string_view s, size_t p)
+{
+	int depth = 0;
+	while (p < s.size()) {
+		if (skip_opaque(s, p))
+			continue;
+		if (s[p] == '{') {
+			depth++;
+		} else if (s[p] == '}') {
+			if (--depth == 0)
+				return p + 1;
+		}
+		p++;
+	}
+	return s.size();
+}
+
+bool is_keyframes(std::string_view name)
+{
+	return name == "keyframes" || name == "-webkit-keyframes";
+}
+
+// At-rules whose body is itself a list of rules that must be scoped.
+bool is_group_rule(std::string_view name)
+{
+	return name == "media" || name == "supports" || name == "container" || name == "layer" ||
+	       name == "document" || name == "-moz-document" || name == "starting-style";
+}
+
+struct scoper {
+	std::string_view s;
+	std::string_view id;
+	std::string &out;
+	std::vector<keyframes_block> &kfs;
+	size_t i = 0;
+
+	void append(size_t from, size_t to) { out.append(s.substr(from, to - from)); }
+
+	bool references_id(std::string_view sel) const
+	{
+		size_t p = 0;
+		while ((p = sel.find('#', p)) != npos) {
+			const size_t e = p + 1 + id.size();
+			if (sel.substr(p + 1, id.size()) == id && (e >= sel.size() || !is_ident_char(sel[e])))
+				return true;
+			p++;
+		}
+		return false;
+	}
+
+	void emit_selector(std::string_view part)
+	{
+		size_t lead = 0;
+		while (lead < part.size() && std::isspace((unsigned char)part[lead]))
+			lead++;
+
+		out.append(part.substr(0, lead));
+		const std::string_view sel = part.substr(lead);
+		if (!sel.empty() && !references_id(sel)) {
+			out.push_back('#');
+			out.append(id);
+			out.push_back(' ');
+		}
+		out.append(sel);
+	}
+
+	void emit_selector_list(std::string_view prelude)
+	{
+		size_t start = 0;
+		while (true) {
+			const size_t comma = find_top_level(prelude, start, ",");
+			const size_t end = (comma == npos) ? prelude.size() : comma;
+			emit_selector(prelude.substr(start, end - start));
+			if (comma == npos)
+				break;
+			out.push_back(',');
+			start = comma + 1;
+		}
+	}
+
+	// Copies a statement/malformed prelude up to `stop` (';' included, '}' left for the caller).
+	void copy_statement(size_t stop)
+	{
+		const size_t e = (s[stop] == ';') ? stop + 1 : stop;
+		append(i, e);
+		i = e;
+	}
+
+	void at_rule()
+	{
+		size_t p = i + 1;
+		while (p < s.size() && is_ident_char(s[p]))
+			p++;
+		const std::string_view name = s.substr(i + 1, p - i - 1);
+
+		const size_t stop = find_top_level(s, p, "{;}");
+		if (stop == npos) {
+			append(i, s.size());
+			i = s.size();
+			return;
+		}
+		if (s[stop] != '{') {
+			copy_statement(stop);
+			return;
+		}
+
+		if (is_keyframes(name)) {
+			size_t n = p;
+			while (n < stop && std::isspace((unsigned char)s[n]))
+				n++;
+			size_t ne = n;
+			while (ne < stop && is_ident_char(s[ne]))
+				ne++;
+
+			const size_t end = match_block(s, stop);
+
+			keyframes_block kb;
+			kb.at_rule.reserve(name.size() + 1);
+			kb.at_rule.push_back('@');
+			kb.at_rule.append(name);
+			kb.name = std::string(s.substr(n, ne - n));
+			kb.block = std::string(s.substr(i, end - i));
+			kb.name_pos = n - i;
+			kfs.push_back(std::move(kb));
+
+			out.push_back('\n');
+			i = end;
+			return;
+		}
+
+		if (is_group_rule(name)) {
+			append(i, stop + 1);
+			i = stop + 1;
+			rule_list(true);
+			if (i < s.size()) {
+				out.push_back('}');
+				i++;
+			}
+			return;
+		}
+
+		const size_t end = match_block(s, stop);
+		append(i, end);
+		i = end;
+	}
+
+	void style_rule()
+	{
+		const size_t stop = find_top_level(s, i, "{;}");
+		if (stop == npos) {
+			append(i, s.size());
+			i = s.size();
+			return;
+		}
+		if (s[stop] != '{') {
+			copy_statement(stop);
+			return;
+		}
+
+		emit_selector_list(s.substr(i, stop - i));
+
+		// Declarations (and any nested rules, which are relative to this one) are copied verbatim.
+		const size_t end = match_block(s, stop);
+		append(stop, end);
+		i = end;
+	}
+
+	void rule_list(bool nested)
+	{
+		while (i < s.size()) {
+			size_t p = i;
+			while (p < s.size()) {
+				if (std::isspace((unsigned char)s[p])) {
+					p++;
+					continue;
+				}
+				if (s[p] == '/' && p + 1 < s.size() && s[p + 1] == '*') {
+					skip_opaque(s, p);
+					continue;
+				}
+				break;
+			}
+			append(i, p);
+			i = p;
+			if (i >= s.size())
+				return;
+
+			if (s[i] == '}') {
+				if (nested)
+					return; // the group rule copies its own closing brace
+				out.push_back('}');
+				i++;
+				continue;
+			}
+
+			if (s[i] == '@')
+				at_rule();
+			else
+				style_rule();
+		}
+	}
+};
+
+} // namespace
+
+void scope_stylesheet(std::string_view src, std::string_view id, std::string &out,
+		      std::vector<keyframes_block> &keyframes)
+{
+	// One reservation per stylesheet; the slack covers the "#id " prefixes of typical templates.
+	out.reserve(out.size() + src.size() + src.size() / 4 + 64);
+
+	scoper sc{src, id, out, keyframes};
+	sc.rule_list(false);
+}
+
+} // namespace smart_lt::css
@@ -3,6 +3,8 @@
 #include "dock.hpp"
 
 #include "core.hpp"
+#include "roster_import.hpp"
+#include "scheduler.hpp"
 #include "settings.hpp"
 #include "widget.hpp"
 
@@ -36,7 +38,6 @@
 #include <QVariant>
 #include <QSizePolicy>
 #include <QTimer>
-#include <QDateTime>
 #include <QComboBox>
 #include <QSpinBox>
 #include <QMetaObject>
@@ -44,25 +45,12 @@
 #include <QAbstractButton>
 #include <QDesktopServices>
 #include <QMessageBox>
-#include <QRandomGenerator>
 #include <QKeySequenceEdit>
 
 static QWidget *g_dockWidget = nullptr;
 
 
 
-struct GroupRuntime {
-	bool running = false;
-	int index = 0; // position in seq
-	bool phaseShow = true;
-	QString currentId;
-	qint64 hideAtMs = 0;
-	QVector<int> seq;
-};
-
-static QHash<QString, GroupRuntime> g_groupRuns;
-static QHash<QString, qint64> g_groupHideAtMs; // ltId -> hideAtMs (only while a group-run is showing it)
-
 static void applyGroupRowStyle(QFrame *rowFrame)
 {
 	if (!rowFrame)
@@ -90,143 +78,6 @@ static void applyGroupRowStyle(QFrame *rowFrame)
 	rowFrame->setStyleSheet(QString());
 }
 
-static void stopGroupRun(const QString &groupId)
-{
-	auto it = g_groupRuns.find(groupId);
-	if (it == g_groupRuns.end())
-		return;
-
-	// Best-effort hide currently shown item
-	if (!it->currentId.isEmpty()) {
-		g_groupHideAtMs.remove(it->currentId);
-		smart_lt::set_visible_persist(it->currentId.toStdString(), false);
-	}
-
-	it->running = false;
-	it->index = 0;
-	it->phaseShow = true;
-	it->currentId.clear();
-	it->hideAtMs = 0;
-	it->seq.clear();
-}
-
-static void scheduleGroupStep(smart_lt::ui::LowerThirdDock *dock, const QString &groupId);
-
-static void startGroupRun(smart_lt::ui::LowerThirdDock *dock, const QString &groupId)
-{
-	if (!dock)
-		return;
-
-	auto *car = smart_lt::get_group_by_id(groupId.toStdString());
-	if (!car || car->members.empty())
-		return;
-
-	auto &rt = g_groupRuns[groupId];
-	rt.running = true;
-	rt.index = 0;
-	rt.phaseShow = true;
-	rt.currentId.clear();
-	rt.hideAtMs = 0;
-	rt.seq.clear();
-
-	scheduleGroupStep(dock, groupId);
-}
-
-static void scheduleGroupStep(smart_lt::ui::LowerThirdDock *dock, const QString &groupId)
-{
-	if (!dock)
-		return;
-
-	auto it = g_groupRuns.find(groupId);
-	if (it == g_groupRuns.end() || !it->running)
-		return;
-
-	auto *car = smart_lt::get_group_by_id(groupId.toStdString());
-	if (!car || car->members.empty()) {
-		stopGroupRun(groupId);
-		return;
-	}
-
-	const int visibleMs = std::max(0, car->visible_ms);
-	const int intervalMs = std::max(0, car->interval_ms);
-	const int count = (int)car->members.size();
-
-	// Build / refresh sequence
-	if (it->seq.size() != count) {
-		it->seq.clear();
-		it->seq.reserve(count);
-		for (int i = 0; i < count; ++i)
-			it->seq.push_back(i);
-		if (car->order_mode == 1) {
-			// Shuffle
-			auto *rng = QRandomGenerator::global();
-			for (int i = count - 1; i > 0; --i) {
-				const int j = (int)rng->bounded((quint32)(i + 1));
-				std::swap(it->seq[i], it->seq[j]);
-			}
-		}
-		it->index = 0;
-	}
-
-	if (it->phaseShow) {
-		// hide previous
-		if (!it->currentId.isEmpty()) {
-			g_groupHideAtMs.remove(it->currentId);
-			smart_lt::set_visible_persist(it->currentId.toStdString(), false);
-		}
-
-		// End condition (non-loop): stop before showing beyond last
-		if (!car->loop && it->index >= count) {
-			stopGroupRun(groupId);
-			return;
-		}
-
-		// Loop condition: wrap and reshuffle per cycle if randomized
-		if (it->index >= count) {
-			it->index = 0;
-			if (car->order_mode == 1) {
-				auto *rng = QRandomGenerator::global();
-				for (int i = count - 1; i > 0; --i) {
-					const int j = (int)rng->bounded((quint32)(i + 1));
-					std::swap(it->seq[i], it->seq[j]);
-				}
-			}
-		}
-
-		const int memberIdx = it->seq.value(it->index, 0);
-		const QString nextId = QString::fromStdString(car->members[(size_t)memberIdx]);
-		it->currentId = nextId;
-		it->hideAtMs = QDateTime::currentMSecsSinceEpoch() + (qint64)visibleMs;
-		g_groupHideAtMs[nextId] = it->hideAtMs;
-
-		smart_lt::set_visible_persist(nextId.toStdString(), true);
-
-		it->phaseShow = false;
-		QTimer::singleShot(visibleMs, dock, [dock, groupId]() { scheduleGroupStep(dock, groupId); });
-	} else {
-		// hide current and advance index
-		if (!it->currentId.isEmpty()) {
-			g_groupHideAtMs.remove(it->currentId);
-			smart_lt::set_visible_persist(it->currentId.toStdString(), false);
-		}
-
-		it->currentId.clear();
-		it->hideAtMs = 0;
-		it->index++;
-
-		// If we just finished the last item and loop is disabled, stop now.
-		if (!car->loop && it->index >= count) {
-			stopGroupRun(groupId);
-			return;
-		}
-
-		it->phaseShow = true;
-		QTimer::singleShot(intervalMs, dock, [dock, groupId]() { scheduleGroupStep(dock, groupId); });
-	}
-}
-
-
-
 namespace smart_lt::ui {
 
 // -------------------------
@@ -238,8 +89,8 @@ void LowerThirdDock::coreEventThunk(const smart_lt::core_event &ev, void *user)
 	if (!self)
 		return;
 
-	// Always marshal to Qt thread to keep UI safe
-	QMetaObject::invokeMethod(self, [self, ev]() { self->onCoreEvent(ev); }, Qt::QueuedConnection);
+	// Registered with delivery_context::QtMain, so this already runs on the UI thread.
+	self->onCoreEvent(ev);
 }
 
 LowerThirdDock::~LowerThirdDock()
@@ -255,12 +106,20 @@ void LowerThirdDock::onCoreEvent(const smart_lt::core_event &ev)
 {
 	switch (ev.type) {
 	case smart_lt::event_type::VisibilityChanged: {
-		const QString qid = QString::fromStdString(ev.id);
-		const bool active = ev.visible;
+		// One event per command; it lists every id the command showed or hid.
+		QHash<QString, bool> changed;
+		for (const auto &id : ev.shown_ids)
+			changed.insert(QString::fromStdString(id), true);
+		for (const auto &id : ev.hidden_ids)
+			changed.insert(QString::fromStdString(id), false);
+		if (!ev.id.empty() && !changed.contains(QString::fromStdString(ev.id)))
+			changed.insert(QString::fromStdString(ev.id), ev.visible);
 
 		for (auto &row : rows) {
-			if (row.id != qid)
+			auto it = changed.constFind(row.id);
+			if (it == changed.constEnd())
 				continue;
+			const bool active = it.value();
 
 			if (row.row) {
 				row.row->setProperty("sltActive", QVariant(active));
@@ -277,7 +136,6 @@ void LowerThirdDock::onCoreEvent(const smart_lt::core_event &ev)
 			}
 
 			updateRowCountdownFor(row);
-			break;
 		}
 		break;
 	}
@@ -528,6 +386,48 @@ QScrollArea#LowerThirdContent QPushButton:hover { background: rgba(255,255,255,0
 			&LowerThirdDock::onBrowserSizeChanged);
 	}
 
+	// -------------------------
+	// Output mode row
+	// -------------------------
+	{
+		auto *grid = new QGridLayout();
+		grid->setContentsMargins(0, 0, 0, 0);
+		grid->setHorizontalSpacing(6);
+		grid->setVerticalSpacing(0);
+		grid->setColumnStretch(0, 0);
+		grid->setColumnStretch(1, 1);
+
+		auto *lbl = new QLabel(tr("Output:"), this);
+		lbl->setObjectName(QStringLiteral("sltRowLabel"));
+		lbl->setAlignment(Qt::AlignLeft | Qt::AlignVCenter);
+		lbl->setSizePolicy(QSizePolicy::Maximum, QSizePolicy::Preferred);
+
+		auto *right = new QWidget(this);
+		auto *rightRow = new QHBoxLayout(right);
+		rightRow->setContentsMargins(0, 0, 0, 0);
+		rightRow->setSpacing(6);
+
+		minifyCheck_ = new QCheckBox(tr("Minify"), right);
+		minifyCheck_->setToolTip(
+			tr("Strip comments and whitespace from the generated CSS, JS and HTML (smaller, faster reloads)"));
+
+		singleFileCheck_ = new QCheckBox(tr("Single file"), right);
+		singleFileCheck_->setToolTip(
+			tr("Embed the CSS and JS in the generated HTML so a reload reads one file"));
+
+		rightRow->addWidget(minifyCheck_);
+		rightRow->addWidget(singleFileCheck_);
+		rightRow->addStretch(1);
+
+		grid->addWidget(lbl, 0, 0);
+		grid->addWidget(right, 0, 1);
+
+		rootLayout->addLayout(grid);
+
+		connect(minifyCheck_, &QCheckBox::toggled, this, &LowerThirdDock::onOutputModeChanged);
+		connect(singleFileCheck_, &QCheckBox::toggled, this, &LowerThirdDock::onOutputModeChanged);
+	}
+
 	// -------------------------
 	// List
 	// -------------------------
@@ -585,12 +485,24 @@ manageGroupsBtn_->setIcon(carIco);
 			plus = st->standardIcon(QStyle::SP_DialogYesButton);
 		addBtn->setIcon(plus);
 
+		importBtn_ = new QPushButton(this);
+		importBtn_->setCursor(Qt::PointingHandCursor);
+		importBtn_->setToolTip(tr("Import roster (CSV / JSON)"));
+		importBtn_->setFlat(true);
+
+		QIcon importIco = QIcon::fromTheme(QStringLiteral("document-import"));
+		if (importIco.isNull())
+			importIco = st->standardIcon(QStyle::SP_DialogOpenButton);
+		importBtn_->setIcon(importIco);
+
 		row->addWidget(infoBtn);
 		row->addWidget(addBtn);
+		row->addWidget(importBtn_);
 		row->addWidget(manageGroupsBtn_);
 		rootLayout->addLayout(row);
 
 		connect(addBtn, &QPushButton::clicked, this, &LowerThirdDock::onAddLowerThird);
+		connect(importBtn_, &QPushButton::clicked, this, &LowerThirdDock::onImportRoster);
 		connect(manageGroupsBtn_, &QPushButton::clicked, this, &LowerThirdDock::onManageGroups);
 
 		connect(infoBtn, &QPushButton::clicked, this, [this]() {
@@ -603,6 +515,7 @@ manageGroupsBtn_->setIcon(carIco);
 
 	const bool hasDir = smart_lt::has_output_dir();
 	addBtn->setEnabled(hasDir);
+	importBtn_->setEnabled(hasDir);
 	if (browserSourceCombo)
 		browserSourceCombo->setEnabled(true);
 	if (refreshSourcesBtn)
@@ -618,6 +531,7 @@ bool LowerThirdDock::init()
 
 	const bool hasDir = smart_lt::has_output_dir();
 	addBtn->setEnabled(hasDir);
+	importBtn_->setEnabled(hasDir);
 
 	if (hasDir)
 		smart_lt::ensure_output_artifacts_exist();
@@ -636,15 +550,27 @@ bool LowerThirdDock::init()
 		browserHeightSpin->setValue(smart_lt::target_browser_height());
 		browserHeightSpin->blockSignals(false);
 	}
+	if (minifyCheck_) {
+		minifyCheck_->blockSignals(true);
+		minifyCheck_->setChecked(smart_lt::minify_output());
+		minifyCheck_->blockSignals(false);
+	}
+	if (singleFileCheck_) {
+		singleFileCheck_->blockSignals(true);
+		singleFileCheck_->setChecked(smart_lt::single_file_output());
+		singleFileCheck_->blockSignals(false);
+	}
 
 	rebuildList();
 
 	// Subscribe to core events so dock stays in sync with WS + external edits
 	if (!coreListenerToken_) {
-		coreListenerToken_ = smart_lt::add_event_listener(&LowerThirdDock::coreEventThunk, this);
+		smart_lt::listener_options opts;
+		opts.context = smart_lt::delivery_context::QtMain;
+		coreListenerToken_ = smart_lt::add_event_listener(&LowerThirdDock::coreEventThunk, this, opts);
 	}
 
-	ensureRepeatTimerStarted();
+	ensureCountdownTimerStarted();
 	connectObsSignals();
 	return true;
 }
@@ -734,128 +660,30 @@ void LowerThirdDock::onBrowserSizeChanged()
 	emit requestSave();
 }
 
-
-// -------------------------
-// Repeat timer
-// -------------------------
-void LowerThirdDock::ensureRepeatTimerStarted()
+void LowerThirdDock::onOutputModeChanged()
 {
-	if (repeatTimer_)
+	if (!minifyCheck_ || !singleFileCheck_)
 		return;
 
-	repeatTimer_ = new QTimer(this);
-	repeatTimer_->setInterval(250);
-	connect(repeatTimer_, &QTimer::timeout, this, &LowerThirdDock::repeatTick);
-	repeatTimer_->start();
-
-	updateRowCountdowns();
+	// Persisted in the module config; each rebuilds the overlay only when it changes.
+	smart_lt::set_minify_output(minifyCheck_->isChecked());
+	smart_lt::set_single_file_output(singleFileCheck_->isChecked());
 }
 
-void LowerThirdDock::repeatTick()
+
+// -------------------------
+// Countdown labels
+// -------------------------
+// Show/hide timing lives in the core scheduler; this timer only re-renders the remaining times.
+void LowerThirdDock::ensureCountdownTimerStarted()
 {
-	if (!smart_lt::has_output_dir())
+	if (countdownTimer_)
 		return;
 
-	const qint64 now = QDateTime::currentMSecsSinceEpoch();
-
-	const auto &items = smart_lt::all();
-	{
-		QSet<QString> alive;
-		alive.reserve((int)items.size());
-		for (const auto &c : items)
-			alive.insert(QString::fromStdString(c.id));
-
-		for (auto it = nextOnMs_.begin(); it != nextOnMs_.end();) {
-			if (!alive.contains(it.key()))
-				it = nextOnMs_.erase(it);
-			else
-				++it;
-		}
-		for (auto it = offAtMs_.begin(); it != offAtMs_.end();) {
-			if (!alive.contains(it.key()))
-				it = offAtMs_.erase(it);
-			else
-				++it;
-		}
-	}
-
-	for (const auto &c : items) {
-		const QString qid = QString::fromStdString(c.id);
-
-		// If this lower third belongs to any currently-running group, do not let the per-item
-		// repeat/auto-hide scheduler interfere. Group run timing (visible_ms / interval_ms)
-		// must be authoritative, otherwise items may be hidden early (e.g. 3s default).
-		{
-			const auto owners = smart_lt::groups_containing(c.id);
-			bool inRunningGroup = false;
-			for (const auto &gid : owners) {
-				const QString qgid = QString::fromStdString(gid);
-				auto grt = g_groupRuns.find(qgid);
-				if (grt != g_groupRuns.end() && grt->running) {
-					inRunningGroup = true;
-					break;
-				}
-			}
-			if (inRunningGroup) {
-				nextOnMs_.remove(qid);
-				offAtMs_.remove(qid);
-				continue;
-			}
-		}
-
-		const int every = c.repeat_every_sec;
-		int visibleSec = c.repeat_visible_sec;
-
-		// Mode matrix:
-		//  - every==0 && visible==0   => full manual (no scheduling)
-		//  - every==0 && visible>0    => manual show + auto-hide after visibleSec
-		//  - every>0                 => full automated (auto-show + auto-hide). If visible==0, use default.
-		if (every <= 0) {
-			nextOnMs_.remove(qid);
-
-			if (visibleSec <= 0) {
-				offAtMs_.remove(qid);
-				continue;
-			}
-
-			if (smart_lt::is_visible(c.id)) {
-				if (!offAtMs_.contains(qid))
-					offAtMs_[qid] = now + (qint64)visibleSec * 1000;
-			} else {
-				offAtMs_.remove(qid);
-			}
-
-		} else {
-			if (visibleSec <= 0)
-				visibleSec = 3;
-
-			if (!nextOnMs_.contains(qid))
-				nextOnMs_[qid] = now + (qint64)every * 1000;
-		}
-
-		if (offAtMs_.contains(qid) && now >= offAtMs_[qid]) {
-			offAtMs_.remove(qid);
-			if (smart_lt::is_visible(c.id)) {
-				smart_lt::set_visible_persist(c.id, false);
-				emit requestSave();
-			}
-		}
-
-		// Auto-show
-		if (every > 0 && nextOnMs_.contains(qid) && now >= nextOnMs_[qid]) {
-			qint64 next = nextOnMs_[qid];
-			const qint64 step = (qint64)every * 1000;
-			while (next <= now)
-				next += step;
-			nextOnMs_[qid] = next;
-
-			if (!smart_lt::is_visible(c.id)) {
-				smart_lt::set_visible_persist(c.id, true);
-				offAtMs_[qid] = now + (qint64)visibleSec * 1000;
-				emit requestSave();
-			}
-		}
-	}
+	countdownTimer_ = new QTimer(this);
+	countdownTimer_->setInterval(250);
+	connect(countdownTimer_, &QTimer::timeout, this, &LowerThirdDock::updateRowCountdowns);
+	countdownTimer_->start();
 
 	updateRowCountdowns();
 }
@@ -871,13 +699,11 @@ void LowerThirdDock::onBrowseOutputFolder()
 
 	smart_lt::set_output_dir_and_load(dir.toStdString());
 
-	nextOnMs_.clear();
-	offAtMs_.clear();
-
 	outputPathEdit->setText(dir);
 
 	const bool hasDir = smart_lt::has_output_dir();
 	addBtn->setEnabled(hasDir);
+	importBtn_->setEnabled(hasDir);
 
 	populateBrowserSources(true);
 
@@ -898,6 +724,68 @@ void LowerThirdDock::onAddLowerThird()
 	emit requestSave();
 }
 
+// One batch through the same core path as CreateLowerThirdsBatch: a single save and a single rebuild.
+void LowerThirdDock::onImportRoster()
+{
+	if (!smart_lt::has_output_dir()) {
+		QMessageBox::information(this, tr("Output folder not set"),
+					 tr("Please choose an output folder first."));
+		return;
+	}
+
+	const QString path = QFileDialog::getOpenFileName(this, tr("Import Roster"), QString(),
+							  tr("Roster (*.csv *.json);;All files (*)"));
+	if (path.isEmpty())
+		return;
+
+	std::vector<smart_lt::lower_third_fields> items;
+	QString error;
+	if (!smart_lt::roster::load_file(path, items, &error)) {
+		QMessageBox::warning(this, tr("Import Roster"), tr("Could not read the roster:\n%1").arg(error));
+		return;
+	}
+	if (items.empty()) {
+		QMessageBox::information(this, tr("Import Roster"), tr("The roster has no usable rows."));
+		return;
+	}
+
+	const auto res = QMessageBox::question(this, tr("Import Roster"),
+					      tr("Create %1 lower third(s) from this roster?").arg((qint64)items.size()),
+					      QMessageBox::Yes | QMessageBox::No, QMessageBox::Yes);
+	if (res != QMessageBox::Yes)
+		return;
+
+	// Pictures are copied into the output folder like the settings dialog does; a missing one is dropped
+	// rather than failing the whole roster.
+	int missingPictures = 0;
+	for (auto &f : items) {
+		if (!f.profile_picture || f.profile_picture->empty())
+			continue;
+		const std::string name = smart_lt::import_profile_picture(*f.profile_picture);
+		if (name.empty()) {
+			LOGW("Roster picture '%s' not imported", f.profile_picture->c_str());
+			f.profile_picture.reset();
+			missingPictures++;
+		} else {
+			f.profile_picture = name;
+		}
+	}
+
+	std::string coreError;
+	if (smart_lt::create_lower_thirds(items, &coreError).empty()) {
+		QMessageBox::warning(this, tr("Import Roster"),
+				     tr("Import failed: %1").arg(QString::fromStdString(coreError)));
+		return;
+	}
+
+	if (missingPictures > 0)
+		QMessageBox::information(this, tr("Import Roster"),
+					 tr("%1 profile picture(s) could not be found and were skipped.").arg(missingPictures));
+
+	updateRowCountdowns();
+	emit requestSave();
+}
+
 void LowerThirdDock::onManageGroups()
 {
 	if (!smart_lt::has_output_dir()) {
@@ -1020,7 +908,7 @@ void LowerThirdDock::onManageGroups()
 	auto refreshMembers = [&](const std::string &groupId) {
 		members->clear();
 		QSet<QString> inSet;
-		if (auto *car = smart_lt::get_group_by_id(groupId)) {
+		if (auto *car = smart_lt::get_group_by_id_const(groupId)) {
 			for (const auto &m : car->members)
 				inSet.insert(QString::fromStdString(m));
 		}
@@ -1051,13 +939,10 @@ void LowerThirdDock::onManageGroups()
 			return;
 		}
 
-		bool running = false;
-		auto rt = g_groupRuns.find(qid);
-		if (rt != g_groupRuns.end())
-			running = rt->running;
+		const bool running = smart_lt::sched::group_running(qid.toStdString());
 
 		bool hasMembers = false;
-		if (auto *car = smart_lt::get_group_by_id(qid.toStdString()))
+		if (auto *car = smart_lt::get_group_by_id_const(qid.toStdString()))
 			hasMembers = !car->members.empty();
 
 		btnStart->setEnabled(!running && hasMembers);
@@ -1081,7 +966,7 @@ void LowerThirdDock::onManageGroups()
 			return;
 		}
 
-		if (auto *car = smart_lt::get_group_by_id(qid.toStdString())) {
+		if (auto *car = smart_lt::get_group_by_id_const(qid.toStdString())) {
 			titleEd->setText(QString::fromStdString(car->title));
 			orderCmb->setCurrentIndex(car->order_mode == 1 ? 1 : 0);
 				loopChk->setChecked(car->loop);
@@ -1143,7 +1028,7 @@ void LowerThirdDock::onManageGroups()
 		if (res != QMessageBox::Yes)
 			return;
 
-		stopGroupRun(qid);
+		smart_lt::sched::stop_group_run(qid.toStdString());
 		smart_lt::remove_group(qid.toStdString());
 		refreshList();
 		if (carList->count() > 0)
@@ -1158,7 +1043,7 @@ void LowerThirdDock::onManageGroups()
 		const QString qid = it->data(Qt::UserRole).toString();
 		if (qid.isEmpty())
 			return;
-		startGroupRun(this, qid);
+		smart_lt::sched::start_group_run(qid.toStdString());
 		updateStartStopButtons();
 	});
 
@@ -1169,7 +1054,7 @@ void LowerThirdDock::onManageGroups()
 		const QString qid = it->data(Qt::UserRole).toString();
 		if (qid.isEmpty())
 			return;
-		stopGroupRun(qid);
+		smart_lt::sched::stop_group_run(qid.toStdString());
 		updateStartStopButtons();
 	});
 
@@ -1181,7 +1066,7 @@ void LowerThirdDock::onManageGroups()
 		if (qid.isEmpty())
 			return;
 
-		auto *car = smart_lt::get_group_by_id(qid.toStdString());
+		auto *car = smart_lt::get_group_by_id_const(qid.toStdString());
 		if (!car)
 			return;
 
@@ -1200,30 +1085,9 @@ void LowerThirdDock::onManageGroups()
 
 		// Toggle hotkey (PortableText) + uniqueness enforcement
 		const QString seq = normalize(toggleHkEdit->keySequence().toString(QKeySequence::PortableText));
-		if (!seq.isEmpty()) {
-			// If this hotkey is already used by another lower third or group, clear the previous usage.
-			for (auto &it : smart_lt::all()) {
-				if (it.id == upd.id)
-					continue;
-				const QString other = normalize(QString::fromStdString(it.hotkey));
-				if (!other.isEmpty() && other == seq) {
-					it.hotkey.clear();
-					smart_lt::notify_list_updated(it.id);
-				}
-			}
-			bool clearedAnyGroup = false;
-			for (auto &g : smart_lt::groups()) {
-				if (g.id == upd.id)
-					continue;
-				const QString other = normalize(QString::fromStdString(g.toggle_hotkey));
-				if (!other.isEmpty() && other == seq) {
-					g.toggle_hotkey.clear();
-					clearedAnyGroup = true;
-				}
-			}
-			if (clearedAnyGroup)
-				smart_lt::notify_list_updated();
-		}
+		// If this hotkey is already used by another lower third or group, clear the previous usage.
+		if (!seq.isEmpty())
+			smart_lt::release_hotkey(seq.toStdString(), upd.id);
 		upd.toggle_hotkey = seq.toStdString();
 
 		smart_lt::update_group(upd);
@@ -1266,16 +1130,16 @@ void LowerThirdDock::rebuildList()
 	}
 	rows.clear();
 
-	const auto &items = smart_lt::all();
+	const smart_lt::state_ref snap = smart_lt::snapshot();
 	const QString outDir = QString::fromStdString(smart_lt::output_dir());
 
-	for (const auto &cfg : items) {
+	for (const auto &cfg : *snap->items) {
 		LowerThirdRowUi ui;
 		ui.id = QString::fromStdString(cfg.id);
 
 		auto *rowFrame = new QFrame(listContainer);
 		rowFrame->setObjectName(QStringLiteral("sltRowFrame"));
-		rowFrame->setProperty("sltActive", QVariant(smart_lt::is_visible(cfg.id)));
+		rowFrame->setProperty("sltActive", QVariant(snap->is_visible(cfg.id)));
 
 // Mark group membership (dock-only; does not affect overlay output)
 const auto carIds = smart_lt::groups_containing(cfg.id);
@@ -1283,7 +1147,7 @@ if (!carIds.empty()) {
 	rowFrame->setProperty("sltInGroup", QVariant(true));
 
 	std::string col = "#2EA043";
-	if (auto *car = smart_lt::get_group_by_id(carIds.front())) {
+	if (auto *car = smart_lt::get_group_by_id_const(carIds.front())) {
 		if (!car->dock_color.empty())
 			col = car->dock_color;
 	}
@@ -1301,7 +1165,7 @@ if (!carIds.empty()) {
 		h->setSpacing(6);
 
 		auto *visible = new QCheckBox(rowFrame);
-		visible->setChecked(smart_lt::is_visible(cfg.id));
+		visible->setChecked(snap->is_visible(cfg.id));
 		visible->setFocusPolicy(Qt::NoFocus);
 		visible->setAttribute(Qt::WA_TransparentForMouseEvents, true);
 		visible->setStyleSheet("QCheckBox::indicator { width: 0px; height: 0px; margin: 0; padding: 0; }");
@@ -1496,8 +1360,8 @@ void LowerThirdDock::rebuildShortcuts()
 {
 	clearShortcuts();
 
-	const auto &items = smart_lt::all();
-	for (const auto &cfg : items) {
+	const smart_lt::state_ref snap = smart_lt::snapshot();
+	for (const auto &cfg : *snap->items) {
 		if (cfg.hotkey.empty())
 			continue;
 
@@ -1519,7 +1383,7 @@ void LowerThirdDock::rebuildShortcuts()
 
 	// Group toggle hotkeys
 	for (const auto &g : smart_lt::groups_const()) {
-		const QString groupId = QString::fromStdString(g.id);
+		const std::string groupId = g.id;
 		const QString seqStr = QString::fromStdString(g.toggle_hotkey).trimmed();
 		if (seqStr.isEmpty())
 			continue;
@@ -1532,11 +1396,10 @@ void LowerThirdDock::rebuildShortcuts()
 		sc->setContext(Qt::ApplicationShortcut);
 		shortcuts_.push_back(sc);
 		connect(sc, &QShortcut::activated, this, [this, groupId]() {
-			auto it = g_groupRuns.find(groupId);
-			if (it != g_groupRuns.end() && it->running)
-				stopGroupRun(groupId);
+			if (smart_lt::sched::group_running(groupId))
+				smart_lt::sched::stop_group_run(groupId);
 			else
-				startGroupRun(this, groupId);
+				smart_lt::sched::start_group_run(groupId);
 			updateRowCountdowns();
 			updateRowActiveStyles();
 		});
@@ -1549,58 +1412,15 @@ void LowerThirdDock::handleToggleVisible(const QString &id)
 
 	// Manual override: if this lower third is part of a running group, stop the group-run.
 	// This prevents the scheduler from fighting the user's manual toggle.
-	for (const auto &g : smart_lt::groups_const()) {
-		bool isMember = false;
-		for (const auto &m : g.members) {
-			if (m == sid) {
-				isMember = true;
-				break;
-			}
-		}
-		if (!isMember)
-			continue;
-
-		const QString groupId = QString::fromStdString(g.id);
-		auto it = g_groupRuns.find(groupId);
-		if (it != g_groupRuns.end() && it->running) {
-			stopGroupRun(groupId);
-		}
+	for (const auto &gid : smart_lt::groups_containing(sid)) {
+		if (smart_lt::sched::group_running(gid))
+			smart_lt::sched::stop_group_run(gid);
 	}
-	const bool wasVisible = smart_lt::is_visible(sid);
-	const bool ok = smart_lt::toggle_visible_persist(sid);
 
-	if (!ok)
+	// Auto-hide / repeat deadlines follow the resulting visibility event.
+	if (!smart_lt::toggle_visible_persist(sid))
 		return;
 
-	const bool nowVisible = smart_lt::is_visible(sid);
-
-
-	if (!wasVisible && nowVisible) {
-		if (auto *cfg = smart_lt::get_by_id(sid)) {
-			const int every = cfg->repeat_every_sec;
-			int visibleSec = cfg->repeat_visible_sec;
-
-			// Same mode matrix as repeatTick()
-			//  - every==0 && visible==0   => full manual (no scheduling)
-			//  - every==0 && visible>0    => manual show + auto-hide after visibleSec
-			//  - every>0                 => full automated. If visible==0, use default.
-			if (every > 0 || visibleSec > 0) {
-				if (every > 0 && visibleSec <= 0)
-					visibleSec = 3;
-
-				if (visibleSec > 0) {
-					const qint64 now = QDateTime::currentMSecsSinceEpoch();
-					offAtMs_[id] = now + (qint64)visibleSec * 1000;
-				}
-
-				if (every > 0 && !nextOnMs_.contains(id)) {
-					const qint64 now = QDateTime::currentMSecsSinceEpoch();
-					nextOnMs_[id] = now + (qint64)every * 1000;
-				}
-			}
-		}
-	}
-
 	updateRowCountdowns();
 	emit requestSave();
 }
@@ -1648,9 +1468,6 @@ if (res != QMessageBox::Yes)
 
 	smart_lt::remove_lower_third(id.toStdString());
 
-	nextOnMs_.remove(id);
-	offAtMs_.remove(id);
-
 	emit requestSave();
 }
 
@@ -1669,22 +1486,20 @@ void LowerThirdDock::updateRowCountdownFor(const LowerThirdRowUi &rowUi)
 	if (!rowUi.subLbl)
 		return;
 
-	const auto *cfg = smart_lt::get_by_id(rowUi.id.toStdString());
+	const auto *cfg = smart_lt::get_by_id_const(rowUi.id.toStdString());
 	if (!cfg) {
 		rowUi.subLbl->clear();
 		rowUi.subLbl->setVisible(false);
 		return;
 	}
 
-	const qint64 now = QDateTime::currentMSecsSinceEpoch();
-	const QString qid = rowUi.id;
+	const auto cd = smart_lt::sched::countdown_for(cfg->id);
 
 	// Group-run countdown (takes precedence): if this lower third is currently being shown as part of
 	// an active group run, show time remaining until the group hides it.
-	if (g_groupHideAtMs.contains(qid) && smart_lt::is_visible(cfg->id)) {
+	if (cd.group_owned && smart_lt::is_visible(cfg->id)) {
 		rowUi.subLbl->setVisible(true);
-		const qint64 leftHide = g_groupHideAtMs.value(qid) - now;
-		rowUi.subLbl->setText(QStringLiteral("Hides in ") + formatCountdownMs(leftHide));
+		rowUi.subLbl->setText(QStringLiteral("Hides in ") + formatCountdownMs(cd.hide_in_ms));
 		return;
 	}
 
@@ -1696,53 +1511,32 @@ void LowerThirdDock::updateRowCountdownFor(const LowerThirdRowUi &rowUi)
 	//  - every==0 && keepVisible>0  => manual show + auto-hide countdown
 	//  - every>0                   => full automated (next + hide countdowns)
 	if (every <= 0) {
-		if (keepVisible <= 0) {
-			rowUi.subLbl->clear();
-			rowUi.subLbl->setVisible(false);
-			return;
-		}
-
-		const bool isVis = smart_lt::is_visible(cfg->id);
-		if (!isVis) {
+		if (keepVisible <= 0 || cd.hide_in_ms < 0) {
 			rowUi.subLbl->clear();
 			rowUi.subLbl->setVisible(false);
 			return;
 		}
 
 		rowUi.subLbl->setVisible(true);
-
-
-		if (!offAtMs_.contains(qid))
-			offAtMs_[qid] = now + (qint64)keepVisible * 1000;
-
-		const qint64 leftHide = offAtMs_[qid] - now;
-		rowUi.subLbl->setText(QStringLiteral("Hides in ") + formatCountdownMs(leftHide));
+		rowUi.subLbl->setText(QStringLiteral("Hides in ") + formatCountdownMs(cd.hide_in_ms));
 		return;
 	}
 
 	rowUi.subLbl->setVisible(true);
 
-	if (!nextOnMs_.contains(qid)) {
-		nextOnMs_[qid] = now + (qint64)every * 1000;
-	}
-
 	const bool isVis = smart_lt::is_visible(cfg->id);
 
 	QStringList parts;
 
-	if (isVis && offAtMs_.contains(qid)) {
-		const qint64 leftHide = offAtMs_[qid] - now;
-		parts << (QStringLiteral("Hides in ") + formatCountdownMs(leftHide));
-	} else if (isVis) {
+	if (isVis && cd.hide_in_ms >= 0)
+		parts << (QStringLiteral("Hides in ") + formatCountdownMs(cd.hide_in_ms));
+	else if (isVis)
 		parts << QStringLiteral("Visible");
-	}
 
-	if (nextOnMs_.contains(qid)) {
-		const qint64 leftNext = nextOnMs_[qid] - now;
-		parts << (QStringLiteral("Next in ") + formatCountdownMs(leftNext));
-	} else {
+	if (cd.next_in_ms >= 0)
+		parts << (QStringLiteral("Next in ") + formatCountdownMs(cd.next_in_ms));
+	else
 		parts << QStringLiteral("Repeating");
-	}
 
 	rowUi.subLbl->setText(parts.join(QStringLiteral(" • ")));
 }
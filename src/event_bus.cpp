@@ -0,0 +1,421 @@
+// event_bus.cpp
+#include "event_bus.hpp"
+
+#include <QCoreApplication>
+#include <QMetaObject>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+namespace smart_lt {
+
+using bus_clock = std::chrono::steady_clock;
+
+// -------------------------
+// Per-listener delivery queue
+// -------------------------
+// Multi-producer / single-consumer intrusive queue (Vyukov). Producers (any emitting thread, or the
+// bus thread) never block; the owning context is the only consumer.
+struct mpsc_node {
+	std::atomic<mpsc_node *> next{nullptr};
+	core_event ev;
+};
+
+class mpsc_queue {
+public:
+	mpsc_queue() : head_(&stub_), tail_(&stub_) {}
+	~mpsc_queue()
+	{
+		while (mpsc_node *n = pop())
+			delete n;
+	}
+
+	void push(mpsc_node *n)
+	{
+		n->next.store(nullptr, std::memory_order_relaxed);
+		mpsc_node *prev = head_.exchange(n, std::memory_order_acq_rel);
+		prev->next.store(n, std::memory_order_release);
+	}
+
+	// Returns the oldest node (caller owns it), or null when empty or a push is still linking in.
+	mpsc_node *pop()
+	{
+		mpsc_node *tail = tail_;
+		mpsc_node *next = tail->next.load(std::memory_order_acquire);
+		if (tail == &stub_) {
+			if (!next)
+				return nullptr;
+			tail_ = next;
+			tail = next;
+			next = next->next.load(std::memory_order_acquire);
+		}
+		if (next) {
+			tail_ = next;
+			return tail;
+		}
+		if (tail != head_.load(std::memory_order_acquire))
+			return nullptr;
+		push(&stub_);
+		next = tail->next.load(std::memory_order_acquire);
+		if (next) {
+			tail_ = next;
+			return tail;
+		}
+		return nullptr;
+	}
+
+private:
+	std::atomic<mpsc_node *> head_;
+	mpsc_node *tail_;
+	mpsc_node stub_;
+};
+
+// A pending delivery for a coalescing listener. `merged` counts the source events folded in.
+struct queued_event {
+	core_event ev;
+	bus_clock::time_point due;
+	int merged = 1;
+};
+
+struct listener_state {
+	uint64_t token = 0;
+	core_event_cb cb = nullptr;
+	void *user = nullptr;
+	delivery_context context = delivery_context::Inline;
+	std::atomic<bool> removed{false};
+
+	// Coalescing (coalesce_ms > 0): merged on the bus thread, then handed to the context below.
+	std::chrono::milliseconds window{0};
+	std::deque<queued_event> pending; // guarded by g_coalesce_mx
+
+	// QtMain / Worker
+	mpsc_queue queue;
+	std::atomic<bool> drain_posted{false}; // QtMain: a drain is queued on the Qt event loop
+	std::counting_semaphore<> wake{0};      // Worker: one release per queued event (+1 to stop)
+	std::thread worker;
+};
+
+using listener_ref = std::shared_ptr<listener_state>;
+using listener_list = std::vector<listener_ref>;
+
+// Copy-on-write: emitters take a reference to the current list instead of copying it.
+static std::mutex g_evt_mx;
+static std::shared_ptr<const listener_list> g_listeners = std::make_shared<listener_list>();
+static uint64_t g_next_token = 1;
+
+static std::mutex g_coalesce_mx;
+static std::condition_variable g_coalesce_cv;
+static std::vector<listener_ref> g_coalescing;
+static std::thread g_bus_thread;
+static bool g_bus_stop = false;
+
+// Held by the bus thread while it hands events on, so removal can wait for an in-flight delivery.
+static std::mutex g_deliver_mx;
+
+static const id_list_ref &empty_id_list()
+{
+	static const id_list_ref empty = std::make_shared<const std::vector<std::string>>();
+	return empty;
+}
+
+// -------------------------
+// Contexts
+// -------------------------
+static void drain_on_main(const listener_ref &l)
+{
+	// Cleared first: a producer that pushes after this point posts another drain.
+	l->drain_posted.store(false, std::memory_order_release);
+	while (mpsc_node *n = l->queue.pop()) {
+		if (!l->removed.load(std::memory_order_acquire))
+			l->cb(n->ev, l->user);
+		delete n;
+	}
+}
+
+static void worker_main(listener_ref l)
+{
+	while (true) {
+		l->wake.acquire();
+		if (l->removed.load(std::memory_order_acquire))
+			return;
+
+		// One release per push, but the node may still be linking in: wait for it.
+		mpsc_node *n;
+		while (!(n = l->queue.pop()))
+			std::this_thread::yield();
+		l->cb(n->ev, l->user);
+		delete n;
+	}
+}
+
+static void deliver(const listener_ref &l, const core_event &ev)
+{
+	if (l->removed.load(std::memory_order_acquire))
+		return;
+
+	switch (l->context) {
+	case delivery_context::Inline:
+		l->cb(ev, l->user);
+		return;
+
+	case delivery_context::QtMain: {
+		auto *n = new mpsc_node();
+		n->ev = ev;
+		l->queue.push(n);
+		if (!l->drain_posted.exchange(true, std::memory_order_acq_rel))
+			QMetaObject::invokeMethod(qApp, [l]() { drain_on_main(l); }, Qt::QueuedConnection);
+		return;
+	}
+
+	case delivery_context::Worker: {
+		auto *n = new mpsc_node();
+		n->ev = ev;
+		l->queue.push(n);
+		l->wake.release();
+		return;
+	}
+	}
+}
+
+// -------------------------
+// Delta merging
+// -------------------------
+static void toggle_delta(std::vector<std::string> &into, std::vector<std::string> &opposite, const std::string &id)
+{
+	auto it = std::find(opposite.begin(), opposite.end(), id);
+	if (it != opposite.end()) {
+		opposite.erase(it); // shown then hidden (or the reverse) within the window: no net change
+		return;
+	}
+	if (std::find(into.begin(), into.end(), id) == into.end())
+		into.push_back(id);
+}
+
+void merge_visibility_delta(core_event &m, const core_event &ev)
+{
+	for (const auto &id : ev.hidden_ids)
+		toggle_delta(m.hidden_ids, m.shown_ids, id);
+	for (const auto &id : ev.shown_ids)
+		toggle_delta(m.shown_ids, m.hidden_ids, id);
+
+	m.visible_ids = ev.visible_ids;
+	m.seq = ev.seq;
+	m.ts_ms = ev.ts_ms;
+	m.state_version = ev.state_version;
+	m.id.clear();
+	m.visible = false;
+}
+
+static void merge_visibility(queued_event &into, const core_event &ev)
+{
+	merge_visibility_delta(into.ev, ev);
+	into.merged++;
+}
+
+static void coalesce(listener_state &l, const core_event &ev)
+{
+	const auto now = bus_clock::now();
+
+	{
+		std::lock_guard<std::mutex> lk(g_coalesce_mx);
+
+		if (ev.type == event_type::VisibilityChanged) {
+			if (!l.pending.empty() && l.pending.back().ev.type == event_type::VisibilityChanged) {
+				merge_visibility(l.pending.back(), ev);
+				return; // the window is already armed
+			}
+			l.pending.push_back(queued_event{ev, now + l.window});
+		} else {
+			// Anything else goes out right away, after the delta that precedes it.
+			for (auto &item : l.pending)
+				item.due = std::min(item.due, now);
+			l.pending.push_back(queued_event{ev, now});
+		}
+	}
+	g_coalesce_cv.notify_one();
+}
+
+// -------------------------
+// Bus thread (coalescing windows)
+// -------------------------
+struct ready_delivery {
+	listener_ref l;
+	core_event ev;
+};
+
+static void bus_thread_main()
+{
+	std::vector<ready_delivery> ready;
+
+	std::unique_lock<std::mutex> lk(g_coalesce_mx);
+	while (true) {
+		const auto now = bus_clock::now();
+		auto next = bus_clock::time_point::max();
+
+		for (const auto &l : g_coalescing) {
+			while (!l->pending.empty() && (l->pending.front().due <= now || g_bus_stop)) {
+				queued_event item = std::move(l->pending.front());
+				l->pending.pop_front();
+
+				// A window that netted out to nothing is dropped.
+				if (item.merged > 1 && item.ev.shown_ids.empty() && item.ev.hidden_ids.empty())
+					continue;
+				ready.push_back(ready_delivery{l, std::move(item.ev)});
+			}
+			if (!l->pending.empty())
+				next = std::min(next, l->pending.front().due);
+		}
+
+		if (!ready.empty()) {
+			// Taken before the queue lock is dropped: a concurrent remove_event_listener() either
+			// unqueued the listener before this pass or waits for these deliveries to finish.
+			std::unique_lock<std::mutex> dlk(g_deliver_mx);
+			lk.unlock();
+			for (const auto &r : ready)
+				deliver(r.l, r.ev);
+			dlk.unlock();
+
+			ready.clear();
+			lk.lock();
+			continue;
+		}
+
+		if (g_bus_stop)
+			return;
+
+		if (next == bus_clock::time_point::max())
+			g_coalesce_cv.wait(lk);
+		else
+			g_coalesce_cv.wait_until(lk, next);
+	}
+}
+
+// -------------------------
+// Public API
+// -------------------------
+void emit_event(const core_event &ev)
+{
+	std::shared_ptr<const listener_list> snapshot;
+	{
+		std::lock_guard<std::mutex> lk(g_evt_mx);
+		snapshot = g_listeners;
+	}
+
+	if (!ev.visible_ids) {
+		core_event withIds = ev;
+		withIds.visible_ids = empty_id_list();
+		emit_event(withIds);
+		return;
+	}
+
+	for (const auto &l : *snapshot) {
+		if (l->window.count() > 0)
+			coalesce(*l, ev);
+		else
+			deliver(l, ev);
+	}
+}
+
+uint64_t add_event_listener(core_event_cb cb, void *user, const listener_options &opts)
+{
+	if (!cb)
+		return 0;
+
+	auto l = std::make_shared<listener_state>();
+	l->cb = cb;
+	l->user = user;
+	l->context = opts.context;
+	l->window = std::chrono::milliseconds(std::max(0, opts.coalesce_ms));
+
+	if (l->context == delivery_context::Worker)
+		l->worker = std::thread(worker_main, l);
+
+	if (l->window.count() > 0) {
+		std::lock_guard<std::mutex> lk(g_coalesce_mx);
+		g_coalescing.push_back(l);
+		if (!g_bus_thread.joinable()) {
+			g_bus_stop = false;
+			g_bus_thread = std::thread(bus_thread_main);
+		}
+	}
+
+	std::lock_guard<std::mutex> lk(g_evt_mx);
+	l->token = g_next_token++;
+
+	auto next = std::make_shared<listener_list>(*g_listeners);
+	next->push_back(l);
+	g_listeners = std::move(next);
+	return l->token;
+}
+
+void remove_event_listener(uint64_t token)
+{
+	if (token == 0)
+		return;
+
+	listener_ref removed;
+	{
+		std::lock_guard<std::mutex> lk(g_evt_mx);
+		auto next = std::make_shared<listener_list>();
+		next->reserve(g_listeners->size());
+		for (const auto &l : *g_listeners) {
+			if (l->token == token)
+				removed = l;
+			else
+				next->push_back(l);
+		}
+		g_listeners = std::move(next);
+	}
+
+	if (!removed)
+		return;
+
+	removed->removed.store(true, std::memory_order_release);
+
+	if (removed->window.count() > 0) {
+		{
+			std::lock_guard<std::mutex> lk(g_coalesce_mx);
+			g_coalescing.erase(std::remove(g_coalescing.begin(), g_coalescing.end(), removed),
+					   g_coalescing.end());
+		}
+		// Wait out a bus pass that may still be delivering to it (unless we are that pass).
+		if (std::this_thread::get_id() != g_bus_thread.get_id()) {
+			std::lock_guard<std::mutex> dlk(g_deliver_mx);
+		}
+	}
+
+	// After this returns the callback is never invoked again: a worker finishes its current event
+	// and exits; a queued Qt drain sees the flag (QtMain listeners are removed on the main thread).
+	if (removed->worker.joinable()) {
+		removed->wake.release();
+		if (std::this_thread::get_id() == removed->worker.get_id())
+			removed->worker.detach();
+		else
+			removed->worker.join();
+	}
+}
+
+void shutdown_event_bus()
+{
+	{
+		std::lock_guard<std::mutex> lk(g_coalesce_mx);
+		g_bus_stop = true;
+	}
+	g_coalesce_cv.notify_one();
+
+	if (g_bus_thread.joinable())
+		g_bus_thread.join();
+
+	std::lock_guard<std::mutex> lk(g_coalesce_mx);
+	g_coalescing.clear();
+}
+
+} // namespace smart_lt
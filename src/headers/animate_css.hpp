@@ -0,0 +1,32 @@
+// animate_css.hpp
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace smart_lt::animate_css {
+
+// Built-in copy of the animate.css 4.1.1 rules (https://animate.style, MIT licensed), so pages only
+// carry the animations their items use instead of linking the whole library.
+
+// One animation: class "animate__<name>", keyframes named <name>.
+struct animation {
+	std::string_view name;
+	std::string_view frames; // keyframes body, without the outer braces
+	std::string_view extra;  // declarations of the class rule besides animation-name
+};
+
+// `cls` is a full class name ("animate__fadeInUp"). nullptr for anything else.
+const animation *find_animation(std::string_view cls);
+
+// Rule for a modifier class ("animate__faster", "animate__delay-2s", ...); empty if `cls` is none.
+std::string_view find_modifier(std::string_view cls);
+
+// :root variables, .animate__animated and the reduced-motion override; needed once any animation is used.
+std::string_view base_rules();
+
+// Appends the animate__* class names mentioned in `text` that are not in `out` yet.
+void collect_classes(std::string_view text, std::vector<std::string> &out);
+
+} // namespace smart_lt::animate_css
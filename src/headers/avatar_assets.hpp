@@ -0,0 +1,34 @@
+// avatar_assets.hpp
+#pragma once
+
+#include <string>
+
+namespace smart_lt::avatar {
+
+// Profile pictures are stored as imported (the original, kept for later re-scales) but rendered from
+// a pre-scaled variant, so the browser source never decodes a full-size photo for a small avatar.
+//
+// A variant is decoded once on a background pool, scaled to cover avatar_width x avatar_height at
+// kPixelRatio (never upscaled, EXIF orientation applied) and re-encoded as WebP, or PNG when the Qt
+// image plugins lack WebP. It is written next to the original as <original>.<W>x<H>@<kPixelRatio>x.<ext>
+// (W x H being the CSS size). A new size replaces the previous variant: the old file is handed to
+// discard_output_file(), which deletes it once no page kept for rollback loads it. Animated images and
+// images already small enough are rendered as they are.
+inline constexpr int kPixelRatio = 2;
+
+// The file (relative to `dir`) the overlay should load for `original` shown at w x h CSS px: the
+// variant once it exists, otherwise the original. A missing variant is queued, and rebuild_and_swap()
+// is requested when it has been written. Empty for an empty `original`. Thread-safe.
+std::string rendered_file(const std::string &dir, const std::string &original, int w, int h);
+
+// Discards the picture `original` and its variants (see discard_output_file()): they are deleted once
+// no page kept for rollback loads them. Call it when a picture is removed or replaced. Never blocks.
+void discard_picture(const std::string &dir, const std::string &original);
+
+// True while `file` is the ready variant some rendered_file() call returns (the manifest keeps it).
+bool variant_in_use(const std::string &dir, const std::string &file);
+
+// Drops queued jobs and waits for running ones (plugin unload, after shutdown_rebuild_worker()).
+void shutdown();
+
+} // namespace smart_lt::avatar
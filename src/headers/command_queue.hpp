@@ -0,0 +1,70 @@
+// command_queue.hpp
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace smart_lt::cmd {
+
+// Single-writer command queue for core state.
+//
+// The Qt main thread owns g_items / g_groups / g_visible. Commands submitted from any other thread
+// (obs-websocket requests, workers) are queued FIFO and run there one at a time, so mutations are
+// serialized in submission order. Commands issued on the owner thread itself run inline.
+bool on_owner_thread();
+
+// Queues `fn` for the owner thread. Returns false once the queue is shut down.
+bool post(std::function<void()> fn);
+
+// Stops accepting commands; anything still queued is dropped (waiting callers see a broken promise).
+void shutdown();
+
+void log_timeout(const char *what);
+
+// Queues `f` and returns a future for its result. On the owner thread it still goes through the
+// queue (use call() to run inline there).
+template<typename F> auto submit(F f) -> std::future<std::invoke_result_t<F>>
+{
+	using R = std::invoke_result_t<F>;
+	auto task = std::make_shared<std::packaged_task<R()>>(std::move(f));
+	std::future<R> fut = task->get_future();
+	post([task]() { (*task)(); });
+	return fut;
+}
+
+// Synchronous form used by the core.hpp wrappers: inline on the owner thread, otherwise queued and
+// waited for up to `timeout`. A command that has not started by then is cancelled (it never runs) and
+// `fallback` is returned, so a failure result always means nothing changed. One that already started
+// is waited for and its own result returned. On shutdown `fallback` is returned.
+inline constexpr std::chrono::milliseconds kDefaultTimeout{5000};
+
+template<typename F, typename R = std::invoke_result_t<F>>
+R call(F f, R fallback, const char *what, std::chrono::milliseconds timeout = kDefaultTimeout)
+{
+	if (on_owner_thread())
+		return f();
+
+	// Claimed once: by the owner thread to run the command, or by the caller giving up on it.
+	auto claimed = std::make_shared<std::atomic<bool>>(false);
+	std::future<R> fut = submit([f = std::move(f), claimed, fallback]() mutable -> R {
+		if (claimed->exchange(true))
+			return fallback;
+		return f();
+	});
+	if (fut.wait_for(timeout) != std::future_status::ready && !claimed->exchange(true)) {
+		log_timeout(what);
+		return fallback;
+	}
+	try {
+		return fut.get();
+	} catch (const std::future_error &) {
+		return fallback;
+	}
+}
+
+} // namespace smart_lt::cmd
@@ -4,6 +4,9 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_map>
 
 #include <obs.h>
 #include <obs-module.h>
@@ -78,6 +81,8 @@ struct lower_third_cfg {
 
 	int repeat_every_sec   = 0; // 0 = disabled
 	int repeat_visible_sec = 0; // how long to keep visible when auto-shown
+
+	bool operator==(const lower_third_cfg &) const = default;
 };
 
 
@@ -114,6 +119,8 @@ struct group_cfg {
 
 	// Member lower-third IDs (in display order)
 	std::vector<std::string> members;
+
+	bool operator==(const group_cfg &) const = default;
 };
 
 // -------------------------
@@ -123,6 +130,7 @@ enum class event_type : uint32_t {
 	VisibilityChanged = 1,
 	ListChanged       = 2,
 	Reloaded          = 3,
+	ArtifactsRebuilt  = 4, // the overlay files were rebuilt (and the browser source swapped if needed)
 };
 
 enum class list_change_reason : uint32_t {
@@ -134,24 +142,48 @@ enum class list_change_reason : uint32_t {
 	Update  = 5,
 };
 
+// Immutable, shared between every event (and listener) that refers to the same visible set.
+using id_list_ref = std::shared_ptr<const std::vector<std::string>>;
+
 struct core_event {
 	event_type type = event_type::VisibilityChanged;
 
-	// VisibilityChanged
+	// VisibilityChanged: one event per command. id/visible describe the targeted item for single-item
+	// commands and are empty/false for batches; shown_ids/hidden_ids list every change the command
+	// made (including exclusive-group hides).
 	std::string id;
 	bool visible = false;
-	std::vector<std::string> visible_ids;
-
-	// ListChanged / Reloaded
+	id_list_ref visible_ids; // never null when delivered
+	std::vector<std::string> shown_ids;
+	std::vector<std::string> hidden_ids;
+	uint64_t seq = 0;  // command sequence number (0 = not a tracked command, e.g. item deleted)
+	int64_t ts_ms = 0; // command time, ms since epoch
+	uint64_t state_version = 0; // snapshot() version that already reflects this event
+
+	// ListChanged / Reloaded / ArtifactsRebuilt (count only)
 	list_change_reason reason = list_change_reason::Unknown;
 	std::string id2;
-	bool ok = true;
+	bool ok = true; // ArtifactsRebuilt: false when the build failed
 	int64_t count = 0;
 };
 
 using core_event_cb = void (*)(const core_event &ev, void *user);
 
-uint64_t add_event_listener(core_event_cb cb, void *user);
+// Where a listener's callback runs.
+enum class delivery_context : uint32_t {
+	Inline = 0, // on the emitting thread, before emit returns
+	QtMain = 1, // queued to the Qt main thread (remove the listener on that thread)
+	Worker = 2, // on a dedicated thread owned by the listener
+};
+
+struct listener_options {
+	delivery_context context = delivery_context::Inline;
+	// > 0: merge VisibilityChanged bursts within this window into one delta event (net
+	// shown_ids/hidden_ids, latest visible_ids/seq; id is empty once merged) before delivery.
+	int coalesce_ms = 0;
+};
+
+uint64_t add_event_listener(core_event_cb cb, void *user, const listener_options &opts = listener_options());
 void remove_event_listener(uint64_t token);
 
 // -------------------------
@@ -170,16 +202,73 @@ bool save_global_config();
 // -------------------------
 // State access
 // -------------------------
-std::vector<lower_third_cfg> &all();
+// Core state has a single writer, the Qt main thread, and is only changed through the commands below
+// (set_*_persist, CRUD, rebuild, presets), which may be called from any thread: off the main thread
+// they are queued through command_queue.hpp and waited for. The accessors, *_nosave and the load/save
+// functions are main-thread only.
 const std::vector<lower_third_cfg> &all_const();
-lower_third_cfg *get_by_id(const std::string &id);
+const lower_third_cfg *get_by_id_const(const std::string &id);
+
+// -------------------------
+// Read snapshots (any thread)
+// -------------------------
+// Immutable, versioned view of items, groups and the visible set. The owner thread publishes a new one
+// after each change (parts that did not change are shared with the previous snapshot); readers copy
+// the reference under a short mutex that covers only that pointer copy, never the state itself, and
+// see a consistent state for as long as they hold it.
+struct state_snapshot {
+	uint64_t version = 0;
+	std::shared_ptr<const std::vector<lower_third_cfg>> items;
+	std::shared_ptr<const std::unordered_map<std::string, size_t>> item_slot; // id -> index in items
+	std::shared_ptr<const std::vector<group_cfg>> groups;
+	id_list_ref visible;
+
+	const lower_third_cfg *find(const std::string &id) const;
+	bool is_visible(const std::string &id) const;
+};
+
+using state_ref = std::shared_ptr<const state_snapshot>;
+
+// Latest published snapshot (never null). On the owner thread pending changes are published first.
+state_ref snapshot();
+
+// -------------------------
+// Revisions / change log
+// -------------------------
+// The snapshot version doubles as the state revision: it only ever increases. Each publish records
+// what it changed in a bounded ring, so clients that remember a revision can ask for the difference.
+enum class state_change_kind : uint32_t {
+	ItemUpserted  = 1, // created or any field changed (including order)
+	ItemRemoved   = 2,
+	Visibility    = 3, // shown or hidden
+	GroupUpserted = 4,
+	GroupRemoved  = 5,
+};
+
+struct state_change {
+	uint64_t revision = 0;
+	state_change_kind kind = state_change_kind::ItemUpserted;
+	std::string id;
+};
+
+struct state_delta {
+	// true when `revision` is older than the retained log (or unknown): the client must re-list.
+	bool resync = false;
+	state_ref state;                   // the snapshot the changes lead to
+	std::vector<state_change> changes; // oldest first; empty when already current
+};
+
+state_delta changes_since(uint64_t revision);
+
+// Random, fixed for the process. Revisions restart with every session, so a revision a client kept is
+// only comparable while the epoch it came with still matches; on a mismatch the client re-lists.
+uint64_t state_epoch();
 
 // -------------------------
 // Group state access (persisted in lt-state.json; dock-only)
 // -------------------------
-std::vector<group_cfg> &groups();
 const std::vector<group_cfg> &groups_const();
-group_cfg *get_group_by_id(const std::string &id);
+const group_cfg *get_group_by_id_const(const std::string &id);
 std::vector<std::string> groups_containing(const std::string &lower_third_id);
 
 // CRUD helpers for dock actions (persist + notify)
@@ -188,6 +277,10 @@ bool update_group(const group_cfg &c);
 bool remove_group(const std::string &group_id);
 bool set_group_members(const std::string &group_id, const std::vector<std::string> &members);
 
+// Clears `hotkey` from every lower third and group toggle except `keep_id` (persist + notify), so a
+// key sequence stays bound to one thing. Sequences are compared in their portable text form.
+bool release_hotkey(const std::string &hotkey, const std::string &keep_id);
+
 
 // -------------------------
 // Visible set
@@ -195,6 +288,45 @@ bool set_group_members(const std::string &group_id, const std::vector<std::strin
 std::vector<std::string> visible_ids();
 bool is_visible(const std::string &id);
 
+// -------------------------
+// Visibility latency
+// -------------------------
+// Visibility commands carry a sequence number; the overlay acknowledges when a transition starts
+// (mounted / hide begun) and when it ends (animation finished). Latency is measured from the
+// command to each acknowledgement and kept as per-item histograms.
+enum class visibility_ack_phase : uint32_t {
+	Start = 1,
+	End = 2,
+};
+
+// seq 0 matches the latest command for the item; acks for superseded commands are ignored.
+void record_visibility_ack(const std::string &id, uint64_t seq, visibility_ack_phase phase);
+
+struct latency_histogram {
+	// Bucket i counts samples in [2^i, 2^(i+1)) ms; bucket 0 also holds anything below 1 ms and the
+	// last bucket anything above.
+	static constexpr size_t bucket_count = 16;
+
+	uint64_t buckets[bucket_count] = {};
+	uint64_t count = 0;
+	double sum_ms = 0.0;
+	double max_ms = 0.0;
+
+	void add(double ms);
+	void merge(const latency_histogram &o);
+	// Upper bound (ms) of the bucket holding quantile q (0..1); 0 when empty.
+	double quantile_ms(double q) const;
+};
+
+struct visibility_latency {
+	std::string id;
+	latency_histogram to_mount;         // command -> transition started
+	latency_histogram to_animation_end; // command -> transition finished
+};
+
+std::vector<visibility_latency> visibility_latency_stats();
+void reset_visibility_latency_stats();
+
 // NOTE: low-level (no persistence, no notifications)
 void set_visible_nosave(const std::string &id, bool visible);
 void toggle_visible_nosave(const std::string &id);
@@ -203,9 +335,40 @@ void toggle_visible_nosave(const std::string &id);
 bool set_visible_persist(const std::string &id, bool visible);
 bool toggle_visible_persist(const std::string &id);
 
+// Applies a set of show/hide changes as one command: changes are resolved in order (exclusive
+// groups included) against a working copy, lt-visible.json is written once and a single
+// VisibilityChanged event is emitted. All-or-nothing: unknown ids reject the whole batch.
+struct visibility_change {
+	std::string id;
+	bool visible = false;
+};
+bool set_visible_batch(const std::vector<visibility_change> &changes, std::string *error = nullptr);
+
+// Replaces the whole visible set in one command (ids that no longer exist are skipped). The set is
+// applied as given, so it is rejected (nothing changes) when two ids share an exclusive group.
+bool set_visible_set(const std::vector<std::string> &ids);
+
+// -------------------------
+// Visibility presets (persisted in lt-state.json)
+// -------------------------
+struct visibility_preset {
+	std::string name;
+	std::vector<std::string> ids;
+};
+
+std::vector<visibility_preset> visibility_presets();
+// Stores `ids` (or the current visible set when null) under `name`, replacing any preset of that name.
+// False when the ids could not all be visible together (two members of one exclusive group).
+bool save_visibility_preset(const std::string &name, const std::vector<std::string> *ids = nullptr);
+bool delete_visibility_preset(const std::string &name);
+// Makes exactly the preset's lower thirds visible, as one batch.
+bool recall_visibility_preset(const std::string &name);
+
 // -------------------------
 // Persistence
 // -------------------------
+// The files are only read at init, on an output dir change and by reload_from_disk_and_rebuild();
+// commands change the in-memory state (keeping its id indexes up to date) and write it back.
 bool load_state_json();
 bool save_state_json();
 bool load_visible_json();
@@ -215,7 +378,39 @@ bool save_visible_json();
 // Artifacts files
 // -------------------------
 bool ensure_output_artifacts_exist();
+
+// Requests an overlay rebuild from the current state. Only says whether the request was queued (false
+// without an output dir or after shutdown_rebuild_worker()), not whether the build succeeds. Requests
+// are coalesced and built on a background worker, which only hands the browser source swap to the main
+// thread; ArtifactsRebuilt is emitted once the result is live, or with ok = false when the build
+// failed. Results of a build that a newer request overtook are discarded.
 bool rebuild_and_swap();
+// Queues a swap back to the previous bundle generation (see lt-bundles.json); the current one is
+// discarded. It lasts until the next rebuild. False without an output dir.
+bool rollback_bundle();
+// Deletes `file` (a plain name in `dir`, the output dir) once no page kept in lt-bundles.json and no
+// item loads it, so a rollback never meets a missing picture or sound. Only queues it: any thread,
+// never waits for a build. The rebuild worker collects it after its next build (or at shutdown).
+void discard_output_file(const std::string &dir, const std::string &file);
+// Stops the worker (plugin unload, after cmd::shutdown()). Pending builds are dropped; the state is
+// saved, and init_from_disk() rebuilds it on the next load.
+void shutdown_rebuild_worker();
+
+// Loopback push channel advertised to the overlay through lt-push.json: the event stream and the
+// transition acknowledgement endpoint. Empty urls withdraw it (the page then keeps polling
+// lt-visible.json).
+void set_push_endpoint(const std::string &eventsUrl, const std::string &ackUrl);
+
+// Per-item compiled fragment cache used by rebuild_and_swap().
+// hits/misses are cumulative; last_* describe the most recent rebuild.
+struct artifact_cache_stats {
+	uint64_t hits = 0;
+	uint64_t misses = 0;
+	uint64_t last_hits = 0;
+	uint64_t last_misses = 0;
+	uint64_t entries = 0;
+};
+artifact_cache_stats artifact_cache_statistics();
 
 // Notify UI listeners (dock, websocket bridge, etc.) that the lower-third list
 // has been updated in-place (e.g. settings changed for an existing item).
@@ -239,14 +434,21 @@ int target_browser_width();
 int target_browser_height();
 bool set_target_browser_dimensions(int width, int height);
 
+// Output mode (persisted in module config); changing it rebuilds with a full reload.
+// - minify: strip comments and whitespace from the generated stylesheet, script and page
+// - single file: embed the stylesheet and script in the page (one file read per swap)
+bool minify_output();
+bool set_minify_output(bool on);
+bool single_file_output();
+bool set_single_file_output(bool on);
+
 // -------------------------
 // Paths
 // -------------------------
 std::string path_state_json();   // lt-state.json
 std::string path_visible_json(); // lt-visible.json
-std::string path_styles_css();   // lt.css
-std::string path_scripts_js();   // lt.js
-std::string path_animate_css();  // animate.min.css
+std::string path_patch_json();   // lt-patch.json (hot patches for the loaded page)
+std::string path_push_json();    // lt-push.json (push channel endpoint)
 
 // -------------------------
 // Utility
@@ -254,6 +456,10 @@ std::string path_animate_css();  // animate.min.css
 std::string now_timestamp_string();
 std::string new_id();
 
+// Copies a local image into the output dir under a generated name and returns that name (empty on
+// failure). Batch fields only accept names of files already there.
+std::string import_profile_picture(const std::string &srcPath);
+
 // -------------------------
 // CRUD helpers for dock actions (persist + notify)
 // -------------------------
@@ -264,4 +470,49 @@ bool remove_lower_third(const std::string &id);
 // Reorder helpers (persist + notify). delta: -1 (up), +1 (down)
 bool move_lower_third(const std::string &id, int delta);
 
+// Replaces the stored lower third that has c.id with `c` (its order is kept; use move_lower_third) and
+// persists it. No rebuild and no event: editors rebuild and notify once they are done.
+bool update_lower_third(const lower_third_cfg &c);
+
+// -------------------------
+// Batch create / update
+// -------------------------
+// A partial lower third: only the fields that are set are applied (the rest keep their defaults on
+// create, their current value on update).
+struct lower_third_fields {
+	std::string id; // update: the item to change (required); create: ignored
+
+	std::optional<std::string> label;
+	std::optional<std::string> title;
+	std::optional<std::string> subtitle;
+	std::optional<std::string> profile_picture;
+	std::optional<std::string> anim_in;
+	std::optional<std::string> anim_out;
+	std::optional<std::string> font_family;
+	std::optional<std::string> lt_position;
+	std::optional<std::string> primary_color;
+	std::optional<std::string> secondary_color;
+	std::optional<std::string> title_color;
+	std::optional<std::string> subtitle_color;
+	std::optional<std::string> hotkey;
+
+	std::optional<int> title_size;
+	std::optional<int> subtitle_size;
+	std::optional<int> avatar_width;
+	std::optional<int> avatar_height;
+	std::optional<int> opacity;
+	std::optional<int> radius;
+	std::optional<int> repeat_every_sec;
+	std::optional<int> repeat_visible_sec;
+};
+
+// One transaction each: every entry is validated first, then all are applied with a single
+// lt-state.json write, a single rebuild and a single ListChanged event (id empty). Nothing is applied
+// when validation or the write fails. Created items are appended hidden; returns their ids in order.
+// Numbers are held to the same ranges as items loaded from lt-state.json (out of range = rejected),
+// group members keep repeat off, and a hotkey is taken away from whatever item or group had it.
+std::vector<std::string> create_lower_thirds(const std::vector<lower_third_fields> &items,
+					     std::string *error = nullptr);
+bool update_lower_thirds(const std::vector<lower_third_fields> &items, std::string *error = nullptr);
+
 } // namespace smart_lt
\ No newline at end of file
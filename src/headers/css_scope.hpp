@@ -0,0 +1,31 @@
+// css_scope.hpp
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace smart_lt::css {
+
+// A @keyframes / @-webkit-keyframes block lifted out of a stylesheet.
+struct keyframes_block {
+	std::string at_rule; // "@keyframes" or "@-webkit-keyframes"
+	std::string name;    // may be empty for anonymous blocks
+	std::string block;   // full text from '@' to the closing '}'
+	size_t name_pos = 0; // offset of `name` in `block`
+};
+
+// Single-pass CSS scoper.
+//
+// Prefixes every selector of every style rule with "#<id> " unless that selector already
+// references "#<id>". Conditional group rules (@media, @supports, @container, @layer,
+// @document, @starting-style) are descended into; other block at-rules (@font-face, @page, ...)
+// and nested rules inside a declaration block are copied verbatim. Strings and comments are
+// skipped, so braces and commas inside them never confuse the parser.
+//
+// Keyframes blocks are removed from the output (replaced by a newline) and appended to
+// `keyframes` in source order, so callers get their boundaries from the same scan.
+void scope_stylesheet(std::string_view src, std::string_view id, std::string &out,
+		      std::vector<keyframes_block> &keyframes);
+
+} // namespace smart_lt::css
@@ -65,6 +65,7 @@ signals:
 private slots:
 	void onBrowseOutputFolder();
 	void onAddLowerThird();
+	void onImportRoster();
 	void onManageGroups();
 
 private:
@@ -76,6 +77,7 @@ private:
 	QString updateLocal_;
 
 	QPushButton *manageGroupsBtn_ = nullptr;
+	QPushButton *importBtn_ = nullptr;
 
 	static QString formatCountdownMs(qint64 ms);
 	void updateRowCountdowns();
@@ -92,13 +94,13 @@ private:
 	void handleOpenSettings(const QString &id);
 	void handleRemove(const QString &id);
 
-	void ensureRepeatTimerStarted();
-	void repeatTick();
+	void ensureCountdownTimerStarted();
 
 	// NEW: combo-box workflow
 	void populateBrowserSources(bool keepSelection = true);
 	void onBrowserSourceChanged(int index);
 	void onBrowserSizeChanged();
+	void onOutputModeChanged();
 
 	// NEW: core event bus sync (bidirectional with websocket)
 	void onCoreEvent(const smart_lt::core_event &ev);
@@ -125,6 +127,10 @@ private:
 	QSpinBox *browserHeightSpin = nullptr;
 	QPushButton *applyBrowserSizeBtn = nullptr;
 
+	// Output mode row
+	QCheckBox *minifyCheck_ = nullptr;
+	QCheckBox *singleFileCheck_ = nullptr;
+
 
 	// Footer tools
 	QPushButton *infoBtn = nullptr;
@@ -139,9 +145,7 @@ private:
 	QVector<LowerThirdRowUi> rows;
 	QVector<QShortcut *> shortcuts_;
 
-	QTimer *repeatTimer_ = nullptr;
-	QHash<QString, qint64> nextOnMs_;
-	QHash<QString, qint64> offAtMs_;
+	QTimer *countdownTimer_ = nullptr;
 
 	// Helps avoid recursive signals while repopulating
 	bool populatingSources_ = false;
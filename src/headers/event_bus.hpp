@@ -0,0 +1,24 @@
+// event_bus.hpp
+#pragma once
+
+#include "core.hpp"
+
+namespace smart_lt {
+
+// Core-internal side of the event bus (listeners register through core.hpp).
+//
+// Inline listeners are called on the emitting thread. QtMain and Worker listeners each own a
+// lock-free queue that the emitter only appends to, so a slow consumer never stalls the thread that
+// made the change. Coalescing listeners are merged on the bus thread first: VisibilityChanged
+// events within the window become a single delta (net shown/hidden ids, latest visible snapshot and
+// seq); any other event flushes the pending delta first, so per-listener ordering is preserved.
+void emit_event(const core_event &ev);
+
+// Folds VisibilityChanged `ev` into the pending delta `into` (net shown/hidden ids, latest visible
+// set, seq and revision). Shown-then-hidden within the same delta cancels out.
+void merge_visibility_delta(core_event &into, const core_event &ev);
+
+// Delivers whatever is still queued and stops the bus thread. Call once at module unload.
+void shutdown_event_bus();
+
+} // namespace smart_lt
@@ -0,0 +1,26 @@
+// minify.hpp
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace smart_lt::minify {
+
+// Conservative minifiers for the generated overlay files. They only drop comments and whitespace
+// that cannot change meaning; anything they do not understand is copied verbatim.
+
+// Drops comments, collapses whitespace and removes it around { } ; , > and after ':'. The last ';'
+// of a block goes too. Strings are kept as written.
+std::string css(std::string_view src);
+
+// Drops comments and indentation and collapses whitespace runs. Line breaks are kept except where
+// ASI cannot depend on them (after { ; , and before }), and a space is kept wherever removing it
+// could join two tokens. Strings, template literals and regex literals are kept as written.
+std::string js(std::string_view src);
+
+// Drops comments and collapses whitespace runs to one space (in text and inside tags, never inside
+// quoted attribute values). <pre>/<textarea> are kept as written; inline <style> and <script>
+// bodies go through css() / js().
+std::string html(std::string_view src);
+
+} // namespace smart_lt::minify
@@ -0,0 +1,23 @@
+// roster_import.hpp
+#pragma once
+
+#include "core.hpp"
+
+#include <QString>
+
+#include <vector>
+
+namespace smart_lt::roster {
+
+// Reads a speaker roster into field sets for create_lower_thirds().
+//
+// - .json: an array of objects (or { "items": [...] }) keyed like the websocket batch requests
+// - anything else: CSV with a header row (',' or ';' separated, RFC 4180 quoting)
+//
+// Keys/columns are matched case-insensitively, ignoring spaces, '_' and '-'; common aliases are accepted
+// ("name" -> title, "role"/"company" -> subtitle, "photo"/"avatar" -> profile picture). Unknown columns
+// are ignored; rows without any known value are skipped. Profile pictures come back as absolute paths
+// (relative ones resolved against the roster's folder), for import_profile_picture().
+bool load_file(const QString &path, std::vector<lower_third_fields> &out, QString *error = nullptr);
+
+} // namespace smart_lt::roster
@@ -0,0 +1,41 @@
+// scheduler.hpp
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace smart_lt::sched {
+
+// Deadline scheduler for everything that shows/hides lower thirds on a timer:
+//  - per-item repeat ("show every N s") and auto-hide ("keep visible N s"),
+//  - group runs (show each member for visible_ms, pause interval_ms, optionally loop/shuffle).
+//
+// Deadlines live in a min-heap over a monotonic millisecond clock and a single-shot QTimer is armed
+// for the earliest one, so nothing runs between deadlines. State follows the core event bus: a
+// visibility change arms/clears the auto-hide deadline, list edits re-read repeat settings.
+//
+// Everything here must be called on the Qt main thread.
+bool init();
+void shutdown();
+
+void start_group_run(const std::string &group_id);
+void stop_group_run(const std::string &group_id);
+bool group_running(const std::string &group_id);
+
+// Remaining time for the dock's countdown labels (-1 = no such deadline).
+struct countdown {
+	int64_t hide_in_ms = -1;  // until the item is hidden (auto-hide or its group run)
+	int64_t next_in_ms = -1;  // until the next repeat show
+	bool group_owned = false; // a running group currently drives this item
+};
+countdown countdown_for(const std::string &lower_third_id);
+
+// Clock injection, for driving the scheduler from a virtual clock. The default is steady_clock.
+// With a custom clock, call run_due() after advancing it; it fires every deadline that is due and
+// returns how many fired.
+using clock_fn = int64_t (*)();
+void set_clock(clock_fn fn);
+int64_t now_ms();
+size_t run_due();
+
+} // namespace smart_lt::sched
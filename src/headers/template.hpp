@@ -0,0 +1,74 @@
+// template.hpp
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace smart_lt::tpl {
+
+// Placeholders understood by lower-third templates ({{NAME}}).
+enum class slot : uint8_t {
+	Id,
+	PrimaryColor,
+	SecondaryColor,
+	TitleColor,
+	SubtitleColor,
+	Title,
+	Subtitle,
+	Opacity,
+	Radius,
+	FontFamily,
+	TitleSize,
+	SubtitleSize,
+	AvatarWidth,
+	AvatarHeight,
+	AnimIn,
+	AnimOut,
+	ProfilePictureUrl,
+	SoundInUrl,
+	SoundOutUrl,
+	BgColor,
+	TextColor,
+	Count
+};
+
+inline constexpr size_t slot_count = (size_t)slot::Count;
+
+// One value per slot, indexed by (size_t)slot.
+using values = std::array<std::string, slot_count>;
+
+// Resolves a placeholder name without braces (e.g. "TITLE"). Returns false for unknown names.
+bool lookup_slot(std::string_view name, slot &out);
+
+// A template compiled once into a stream of literal spans and placeholder slots.
+// Rendering is a single linear pass into a buffer sized up front.
+// Unknown {{NAME}} sequences are kept verbatim as literals.
+class compiled_template {
+public:
+	compiled_template() = default;
+
+	static compiled_template compile(std::string source);
+
+	const std::string &source() const { return src_; }
+	bool has_placeholders() const { return slots_ > 0; }
+
+	std::string render(const values &v) const;
+	void render_into(const values &v, std::string &out) const;
+
+private:
+	struct token {
+		uint32_t offset = 0; // literal: offset into src_
+		uint32_t length = 0; // literal: byte count
+		slot s = slot::Count; // slot::Count marks a literal span
+	};
+
+	std::string src_;
+	std::vector<token> tokens_;
+	size_t literal_bytes_ = 0;
+	size_t slots_ = 0;
+};
+
+} // namespace smart_lt::tpl
@@ -0,0 +1,15 @@
+// visibility_server.hpp
+#pragma once
+
+namespace smart_lt::push {
+
+// Loopback Server-Sent Events endpoint for the overlay page.
+//
+// Streams visibility deltas (and hot-patch hints) to the browser source as they happen, so the
+// page no longer has to poll lt-visible.json, and receives the page's transition acknowledgements
+// for the latency histograms. The endpoints are advertised through lt-push.json; pages that cannot
+// connect keep polling. Must be called on the Qt main thread.
+bool init();
+void shutdown();
+
+} // namespace smart_lt::push
@@ -0,0 +1,47 @@
+// ws_subscriptions.hpp
+#pragma once
+
+#include "core.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace smart_lt::ws {
+
+// The obs-websocket event stream.
+//
+// The vendor API can only broadcast, so there is one stream and its options are server-wide: every
+// client gets the same filtered, rate-limited events. Per-client streams would each be broadcast to
+// every client too, multiplying the traffic they are meant to cut.
+struct event_options {
+	// Event types
+	bool visibility = true;
+	bool list = true;
+	bool reload = true;
+
+	// Only events touching these items, or members of these groups (both empty = everything).
+	std::vector<std::string> ids;
+	std::vector<std::string> group_ids;
+
+	// Max visibility events per second (0 = unlimited). Events inside the interval are merged into one
+	// net delta sent on the trailing edge. List/reload events are never delayed; they flush the delta.
+	int max_rate = 0;
+
+	// Visibility events carry only shownIds/hiddenIds (no visibleIds).
+	bool compact = false;
+};
+
+// Called on the stream thread, in event order.
+using event_emit_fn = void (*)(const core_event &ev, bool compact);
+
+void event_stream_init(event_emit_fn emit);
+void event_stream_shutdown();
+
+// Runs `ev` through the stream options (call from the core listener).
+void event_stream_dispatch(const core_event &ev);
+
+void set_event_options(const event_options &opts);
+event_options current_event_options();
+
+} // namespace smart_lt::ws
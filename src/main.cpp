@@ -1,7 +1,12 @@
 #define LOG_TAG "[" PLUGIN_NAME "][main]"
+#include "avatar_assets.hpp"
+#include "command_queue.hpp"
 #include "core.hpp"
 #include "dock.hpp"
+#include "event_bus.hpp"
 #include "headers/api.hpp"
+#include "scheduler.hpp"
+#include "visibility_server.hpp"
 #include "websocket_bridge.hpp"
 
 #include <obs-frontend-api.h>
@@ -44,6 +49,7 @@ bool obs_module_load(void)
 	LOGI("Plugin loaded (version %s)", PLUGIN_VERSION);
 
 	smart_lt::init_from_disk();
+	smart_lt::sched::init();
 	LowerThird_create_dock();
 	return true;
 }
@@ -52,6 +58,7 @@ void obs_module_post_load(void)
 {
 	obs_frontend_add_event_callback(on_frontend_event, nullptr);
 	smart_lt::ws::init();
+	smart_lt::push::init();
 
 	// Update check: compare local PLUGIN_VERSION vs API "plugin_version".
 	// IMPORTANT: Connect BEFORE init(), because init() may synchronously emit
@@ -89,8 +96,14 @@ void obs_module_unload(void)
 {
 	LOGI("Unloading plugin %s", PLUGIN_NAME);
 
+	smart_lt::push::shutdown();
 	smart_lt::ws::shutdown();
+	smart_lt::cmd::shutdown();
+	smart_lt::shutdown_rebuild_worker();
+	smart_lt::avatar::shutdown();
 	LowerThird_destroy_dock();
+	smart_lt::sched::shutdown();
+	smart_lt::shutdown_event_bus();
 
 	LOGI("Plugin %s unloaded", PLUGIN_NAME);
 }
@@ -0,0 +1,375 @@
+// minify.cpp
+#include "minify.hpp"
+
+#include <cctype>
+#include <vector>
+
+namespace smart_lt::minify {
+
+namespace {
+
+constexpr size_t npos = std::string_view::npos;
+
+bool is_space(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+// Identifier / number characters; bytes >= 0x80 are parts of UTF-8 identifiers.
+bool is_word(char c)
+{
+	const unsigned char u = (unsigned char)c;
+	return std::isalnum(u) || c == '_' || c == '$' || u >= 0x80;
+}
+
+// Copies the quoted string starting at s[p] (escapes included) and advances p past it. An unescaped
+// newline ends an unterminated string.
+void copy_string(std::string_view s, size_t &p, std::string &out)
+{
+	const char q = s[p];
+	const size_t b = p++;
+	while (p < s.size() && s[p] != q && s[p] != '\n') {
+		if (s[p] == '\\' && p + 1 < s.size())
+			p++;
+		p++;
+	}
+	if (p < s.size() && s[p] == q)
+		p++;
+	out.append(s.substr(b, p - b));
+}
+
+bool starts_with_ci(std::string_view s, size_t p, std::string_view what)
+{
+	if (s.size() - p < what.size())
+		return false;
+	for (size_t i = 0; i < what.size(); ++i) {
+		if (std::tolower((unsigned char)s[p + i]) != what[i])
+			return false;
+	}
+	return true;
+}
+
+// -------------------------
+// JS helpers
+// -------------------------
+// Keywords after which '/' starts a regex literal rather than a division.
+bool is_regex_keyword(std::string_view w)
+{
+	static const std::string_view kKeywords[] = {"return", "typeof", "case",       "do",  "else",  "in",
+						     "of",     "void",   "delete",     "new", "throw", "yield",
+						     "await",  "instanceof"};
+	for (auto k : kKeywords) {
+		if (w == k)
+			return true;
+	}
+	return false;
+}
+
+// Decided on the output, which never ends in whitespace when this is asked.
+bool regex_allowed(const std::string &out)
+{
+	if (out.empty())
+		return true;
+
+	const char c = out.back();
+	if (is_word(c)) {
+		size_t b = out.size();
+		while (b > 0 && is_word(out[b - 1]))
+			--b;
+		return is_regex_keyword(std::string_view(out).substr(b));
+	}
+	if (c == ')' || c == ']' || c == '"' || c == '\'' || c == '`')
+		return false;
+	if ((c == '+' || c == '-') && out.size() > 1 && out[out.size() - 2] == c)
+		return false; // a++ / b
+	return true;
+}
+
+// A space between prev and next is needed to keep them separate tokens.
+bool js_needs_space(char prev, char next)
+{
+	if (is_word(prev) && (is_word(next) || next == '.'))
+		return true; // "a b", and "1 .x" (1.x would be a number)
+	if ((prev == '+' || prev == '-') && (next == '+' || next == '-'))
+		return true;
+	if (prev == '/' || next == '/')
+		return true; // never form a comment, and keep divisions apart from regex literals
+	return (prev == '<' && next == '!') || (prev == '-' && next == '>'); // <!-- and --> are comments in scripts
+}
+
+// A line break after these never matters for ASI.
+bool js_break_after_is_noise(char prev)
+{
+	return prev == '{' || prev == ';' || prev == ',' || prev == '\n';
+}
+
+// Copies the regex literal starting at s[p]; flags follow as ordinary word characters.
+void copy_regex(std::string_view s, size_t &p, std::string &out)
+{
+	const size_t b = p++;
+	bool inClass = false;
+	while (p < s.size() && s[p] != '\n') {
+		const char c = s[p];
+		if (c == '\\' && p + 1 < s.size()) {
+			p += 2;
+			continue;
+		}
+		p++;
+		if (c == '[')
+			inClass = true;
+		else if (c == ']')
+			inClass = false;
+		else if (c == '/' && !inClass)
+			break;
+	}
+	out.append(s.substr(b, p - b));
+}
+
+} // namespace
+
+// -------------------------
+// CSS
+// -------------------------
+std::string css(std::string_view s)
+{
+	auto tight = [](char c) { return c == '{' || c == '}' || c == ';' || c == ',' || c == '>'; };
+
+	std::string out;
+	out.reserve(s.size());
+	bool space = false;
+
+	for (size_t p = 0; p < s.size();) {
+		const char c = s[p];
+
+		if (c == '/' && p + 1 < s.size() && s[p + 1] == '*') {
+			const size_t e = s.find("*/", p + 2);
+			p = (e == npos) ? s.size() : e + 2;
+			continue;
+		}
+		if (is_space(c)) {
+			space = true;
+			p++;
+			continue;
+		}
+
+		if (space && !out.empty() && !tight(out.back()) && out.back() != ':' && !tight(c))
+			out += ' ';
+		space = false;
+
+		if (c == '"' || c == '\'') {
+			copy_string(s, p, out);
+			continue;
+		}
+		if (c == '}' && !out.empty() && out.back() == ';')
+			out.pop_back();
+		out += c;
+		p++;
+	}
+	return out;
+}
+
+// -------------------------
+// JS
+// -------------------------
+std::string js(std::string_view s)
+{
+	std::string out;
+	out.reserve(s.size());
+
+	std::vector<int> tplDepth; // one entry per open ${ ... }: nesting of plain braces inside it
+	bool inTemplate = false;
+	bool pendSpace = false;
+	bool pendBreak = false;
+
+	auto flush_ws = [&](char next) {
+		if (!out.empty() && (pendSpace || pendBreak)) {
+			const char prev = out.back();
+			if (pendBreak && !js_break_after_is_noise(prev) && next != '}')
+				out += '\n';
+			else if (js_needs_space(prev, next))
+				out += ' ';
+		}
+		pendSpace = pendBreak = false;
+	};
+
+	for (size_t p = 0; p < s.size();) {
+		const char c = s[p];
+
+		if (inTemplate) {
+			if (c == '\\' && p + 1 < s.size()) {
+				out.append(s.substr(p, 2));
+				p += 2;
+			} else if (c == '`') {
+				out += c;
+				p++;
+				inTemplate = false;
+			} else if (c == '$' && p + 1 < s.size() && s[p + 1] == '{') {
+				out += "${";
+				p += 2;
+				tplDepth.push_back(0);
+				inTemplate = false;
+			} else {
+				out += c;
+				p++;
+			}
+			continue;
+		}
+
+		if (is_space(c)) {
+			if (c == '\n')
+				pendBreak = true;
+			else
+				pendSpace = true;
+			p++;
+			continue;
+		}
+
+		if (c == '/' && p + 1 < s.size() && s[p + 1] == '/') {
+			const size_t e = s.find('\n', p + 2);
+			p = (e == npos) ? s.size() : e;
+			continue;
+		}
+		if (c == '/' && p + 1 < s.size() && s[p + 1] == '*') {
+			const size_t e = s.find("*/", p + 2);
+			const size_t end = (e == npos) ? s.size() : e + 2;
+			if (s.substr(p, end - p).find('\n') != npos)
+				pendBreak = true; // a multi-line comment counts as a line break for ASI
+			else
+				pendSpace = true;
+			p = end;
+			continue;
+		}
+
+		if (c == '/' && regex_allowed(out)) {
+			flush_ws(c);
+			copy_regex(s, p, out);
+			continue;
+		}
+
+		flush_ws(c);
+
+		if (c == '"' || c == '\'') {
+			copy_string(s, p, out);
+			continue;
+		}
+		if (c == '`') {
+			out += c;
+			p++;
+			inTemplate = true;
+			continue;
+		}
+
+		if (!tplDepth.empty()) {
+			if (c == '{') {
+				tplDepth.back()++;
+			} else if (c == '}') {
+				if (tplDepth.back() == 0) {
+					tplDepth.pop_back();
+					inTemplate = true; // back in the literal that opened this ${
+				} else {
+					tplDepth.back()--;
+				}
+			}
+		}
+		out += c;
+		p++;
+	}
+	return out;
+}
+
+// -------------------------
+// HTML
+// -------------------------
+std::string html(std::string_view s)
+{
+	std::string out;
+	out.reserve(s.size());
+	bool space = false;
+
+	for (size_t p = 0; p < s.size();) {
+		const char c = s[p];
+
+		if (s.compare(p, 4, "<!--") == 0) {
+			const size_t e = s.find("-->", p + 4);
+			p = (e == npos) ? s.size() : e + 3;
+			continue;
+		}
+
+		if (is_space(c)) {
+			space = true;
+			p++;
+			continue;
+		}
+		if (space && !out.empty())
+			out += ' ';
+		space = false;
+
+		const bool isTag = c == '<' && p + 1 < s.size() &&
+				   (std::isalpha((unsigned char)s[p + 1]) || s[p + 1] == '/' || s[p + 1] == '!');
+		if (!isTag) {
+			out += c;
+			p++;
+			continue;
+		}
+
+		// Tag: collapse whitespace between attributes, keep quoted values as written.
+		const size_t tagStart = out.size();
+		out += '<';
+		p++;
+		bool tagSpace = false;
+		while (p < s.size() && s[p] != '>') {
+			const char ch = s[p];
+			if (is_space(ch)) {
+				tagSpace = true;
+				p++;
+				continue;
+			}
+			if (tagSpace && ch != '=' && ch != '/' && out.back() != '=')
+				out += ' ';
+			tagSpace = false;
+
+			if (ch == '"' || ch == '\'') {
+				const size_t e = s.find(ch, p + 1);
+				const size_t end = (e == npos) ? s.size() : e + 1;
+				out.append(s.substr(p, end - p));
+				p = end;
+				continue;
+			}
+			out += ch;
+			p++;
+		}
+		if (p < s.size()) {
+			out += '>';
+			p++;
+		}
+
+		// Raw text elements: bodies are copied (or minified as what they are) up to the closing tag.
+		const std::string_view tag = std::string_view(out).substr(tagStart);
+		const std::string_view raw[] = {"script", "style", "pre", "textarea"};
+		for (auto name : raw) {
+			if (!starts_with_ci(tag, 1, name) || is_word(tag.size() > name.size() + 1 ? tag[name.size() + 1] : '>'))
+				continue;
+
+			size_t end = p;
+			while ((end = s.find("</", end)) != npos && !starts_with_ci(s, end + 2, name))
+				end += 2;
+			if (end == npos)
+				end = s.size();
+
+			const std::string_view body = s.substr(p, end - p);
+			const bool scriptIsJs = tag.find("type=") == npos || tag.find("javascript") != npos ||
+						tag.find("module") != npos;
+			if (name == "style")
+				out += css(body);
+			else if (name == "script" && scriptIsJs)
+				out += js(body);
+			else
+				out.append(body);
+			p = end;
+			break;
+		}
+	}
+	return out;
+}
+
+} // namespace smart_lt::minify
@@ -0,0 +1,254 @@
+// roster_import.cpp
+#define LOG_TAG "[" PLUGIN_NAME "][roster]"
+#include "roster_import.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+namespace smart_lt::roster {
+
+using lt_fields = lower_third_fields;
+
+struct column {
+	const char *key; // normalized: lowercase, no spaces / '_' / '-'
+	std::optional<std::string> lt_fields::*str;
+	std::optional<int> lt_fields::*num;
+};
+
+static const column kColumns[] = {
+	{"label", &lt_fields::label, nullptr},
+	{"title", &lt_fields::title, nullptr},
+	{"name", &lt_fields::title, nullptr},
+	{"subtitle", &lt_fields::subtitle, nullptr},
+	{"role", &lt_fields::subtitle, nullptr},
+	{"company", &lt_fields::subtitle, nullptr},
+	{"profilepicture", &lt_fields::profile_picture, nullptr},
+	{"photo", &lt_fields::profile_picture, nullptr},
+	{"avatar", &lt_fields::profile_picture, nullptr},
+	{"animin", &lt_fields::anim_in, nullptr},
+	{"animout", &lt_fields::anim_out, nullptr},
+	{"fontfamily", &lt_fields::font_family, nullptr},
+	{"position", &lt_fields::lt_position, nullptr},
+	{"primarycolor", &lt_fields::primary_color, nullptr},
+	{"secondarycolor", &lt_fields::secondary_color, nullptr},
+	{"titlecolor", &lt_fields::title_color, nullptr},
+	{"subtitlecolor", &lt_fields::subtitle_color, nullptr},
+	{"hotkey", &lt_fields::hotkey, nullptr},
+	{"titlesize", nullptr, &lt_fields::title_size},
+	{"subtitlesize", nullptr, &lt_fields::subtitle_size},
+	{"avatarwidth", nullptr, &lt_fields::avatar_width},
+	{"avatarheight", nullptr, &lt_fields::avatar_height},
+	{"opacity", nullptr, &lt_fields::opacity},
+	{"radius", nullptr, &lt_fields::radius},
+	{"repeateverysec", nullptr, &lt_fields::repeat_every_sec},
+	{"repeatvisiblesec", nullptr, &lt_fields::repeat_visible_sec},
+};
+
+static const column *find_column(const std::string &name)
+{
+	std::string key;
+	for (unsigned char ch : name) {
+		if (ch != ' ' && ch != '_' && ch != '-')
+			key.push_back((char)std::tolower(ch));
+	}
+	for (const auto &c : kColumns) {
+		if (key == c.key)
+			return &c;
+	}
+	return nullptr;
+}
+
+static std::string trimmed(const std::string &s)
+{
+	size_t b = 0, e = s.size();
+	while (b < e && std::isspace((unsigned char)s[b]))
+		++b;
+	while (e > b && std::isspace((unsigned char)s[e - 1]))
+		--e;
+	return s.substr(b, e - b);
+}
+
+// Returns false when the value is empty or not a number for an int column.
+static bool set_value(lt_fields &f, const column &c, const std::string &value)
+{
+	const std::string v = trimmed(value);
+	if (v.empty())
+		return false;
+	if (c.str) {
+		f.*c.str = v;
+		return true;
+	}
+	char *end = nullptr;
+	const long n = std::strtol(v.c_str(), &end, 10);
+	if (!end || *end)
+		return false;
+	f.*c.num = (int)n;
+	return true;
+}
+
+// -------------------------
+// CSV
+// -------------------------
+// RFC 4180: quoted cells may contain the separator, newlines and "" for a quote. Works on UTF-8 bytes
+// (separators and quotes are ASCII).
+static std::vector<std::vector<std::string>> parse_csv(const std::string &text, char sep)
+{
+	std::vector<std::vector<std::string>> rows;
+	std::vector<std::string> row;
+	std::string cell;
+	bool quoted = false;
+
+	for (size_t i = 0; i < text.size(); ++i) {
+		const char ch = text[i];
+		if (quoted) {
+			if (ch == '"') {
+				if (i + 1 < text.size() && text[i + 1] == '"') {
+					cell.push_back('"');
+					++i;
+				} else {
+					quoted = false;
+				}
+			} else {
+				cell.push_back(ch);
+			}
+			continue;
+		}
+
+		if (ch == '"' && cell.empty()) {
+			quoted = true;
+		} else if (ch == sep) {
+			row.push_back(std::move(cell));
+			cell.clear();
+		} else if (ch == '\n' || ch == '\r') {
+			if (ch == '\r' && i + 1 < text.size() && text[i + 1] == '\n')
+				++i;
+			row.push_back(std::move(cell));
+			cell.clear();
+			rows.push_back(std::move(row));
+			row.clear();
+		} else {
+			cell.push_back(ch);
+		}
+	}
+	if (!cell.empty() || !row.empty()) {
+		row.push_back(std::move(cell));
+		rows.push_back(std::move(row));
+	}
+	return rows;
+}
+
+static bool load_csv(std::string text, std::vector<lt_fields> &out, QString *error)
+{
+	if (text.compare(0, 3, "\xEF\xBB\xBF") == 0) // spreadsheet exports often start with a BOM
+		text.erase(0, 3);
+
+	const std::string firstLine = text.substr(0, text.find('\n'));
+	const char sep = std::count(firstLine.begin(), firstLine.end(), ';') >
+					 std::count(firstLine.begin(), firstLine.end(), ',')
+				 ? ';'
+				 : ',';
+
+	const auto rows = parse_csv(text, sep);
+	if (rows.empty()) {
+		if (error)
+			*error = QStringLiteral("The file is empty.");
+		return false;
+	}
+
+	std::vector<const column *> cols;
+	bool any = false;
+	for (const auto &h : rows.front()) {
+		cols.push_back(find_column(trimmed(h)));
+		any = any || cols.back();
+	}
+	if (!any) {
+		if (error)
+			*error = QStringLiteral("No known column in the header row (expected e.g. title, subtitle).");
+		return false;
+	}
+
+	for (size_t r = 1; r < rows.size(); ++r) {
+		lt_fields f;
+		bool used = false;
+		const auto &cells = rows[r];
+		for (size_t i = 0; i < cells.size() && i < cols.size(); ++i) {
+			if (cols[i])
+				used = set_value(f, *cols[i], cells[i]) || used;
+		}
+		if (used)
+			out.push_back(std::move(f));
+	}
+	return true;
+}
+
+// -------------------------
+// JSON
+// -------------------------
+static bool load_json(const QByteArray &data, std::vector<lt_fields> &out, QString *error)
+{
+	QJsonParseError pe;
+	const QJsonDocument doc = QJsonDocument::fromJson(data, &pe);
+	if (pe.error != QJsonParseError::NoError) {
+		if (error)
+			*error = pe.errorString();
+		return false;
+	}
+
+	const QJsonArray arr = doc.isArray() ? doc.array() : doc.object().value("items").toArray();
+	for (const auto &v : arr) {
+		const QJsonObject o = v.toObject();
+		lt_fields f;
+		bool used = false;
+		for (const auto &key : o.keys()) {
+			const column *c = find_column(key.toStdString());
+			if (!c)
+				continue;
+			const QJsonValue jv = o.value(key);
+			const std::string value = jv.isDouble() ? std::to_string(jv.toInt()) : jv.toString().toStdString();
+			used = set_value(f, *c, value) || used;
+		}
+		if (used)
+			out.push_back(std::move(f));
+	}
+	return true;
+}
+
+bool load_file(const QString &path, std::vector<lower_third_fields> &out, QString *error)
+{
+	QFile f(path);
+	if (!f.open(QIODevice::ReadOnly)) {
+		if (error)
+			*error = f.errorString();
+		return false;
+	}
+	const QByteArray data = f.readAll();
+	f.close();
+
+	const bool ok = QFileInfo(path).suffix().toLower() == QStringLiteral("json")
+				? load_json(data, out, error)
+				: load_csv(data.toStdString(), out, error);
+
+	// Picture paths are relative to the roster file; the importer copies them into the output dir.
+	if (ok) {
+		const QDir base(QFileInfo(path).absolutePath());
+		for (auto &f : out) {
+			if (f.profile_picture)
+				f.profile_picture = base.filePath(QString::fromStdString(*f.profile_picture)).toStdString();
+		}
+	}
+
+	if (ok)
+		LOGI("Roster '%s': %d entr%s", path.toUtf8().constData(), (int)out.size(),
+		     out.size() == 1 ? "y" : "ies");
+	return ok;
+}
+
+} // namespace smart_lt::roster
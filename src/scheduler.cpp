@@ -0,0 +1,553 @@
+// scheduler.cpp
+#define LOG_TAG "[" PLUGIN_NAME "][sched]"
+#include "scheduler.hpp"
+
+#include "core.hpp"
+
+#include <QRandomGenerator>
+#include <QTimer>
+
+#include <algorithm>
+#include <chrono>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace smart_lt::sched {
+
+enum class deadline_kind : uint8_t {
+	RepeatShow, // item: next automatic show
+	AutoHide,   // item: hide after its visible time
+	GroupStep,  // group run: next show/hide step
+};
+
+struct heap_entry {
+	int64_t due = 0;
+	uint64_t order = 0; // FIFO among equal deadlines
+	deadline_kind kind = deadline_kind::RepeatShow;
+	std::string key;
+};
+
+struct later_first {
+	bool operator()(const heap_entry &a, const heap_entry &b) const
+	{
+		if (a.due != b.due)
+			return a.due > b.due;
+		return a.order > b.order;
+	}
+};
+
+// Rescheduling or cancelling does not touch the heap: the owning record below is the source of
+// truth and a popped entry whose due time no longer matches it is simply dropped.
+struct item_timers {
+	int64_t next_on = -1;
+	int64_t off_at = -1;
+	int every_sec = 0; // repeat_every_sec that next_on was scheduled with
+};
+
+struct group_run {
+	bool phase_show = true;
+	int index = 0; // position in seq
+	std::string current_id;
+	int64_t step_at = -1;
+	int64_t hide_at = -1;
+	std::vector<int> seq;
+};
+
+static std::priority_queue<heap_entry, std::vector<heap_entry>, later_first> g_heap;
+static uint64_t g_heap_order = 0;
+static std::unordered_map<std::string, item_timers> g_item_timers;
+static std::unordered_map<std::string, group_run> g_runs;
+static std::unordered_set<std::string> g_seen_visible; // visible set as of the last event handled
+
+static QTimer *g_timer = nullptr;
+static uint64_t g_core_listener_token = 0;
+
+static constexpr int kDefaultRepeatVisibleSec = 3;
+
+static int64_t steady_now_ms()
+{
+	using namespace std::chrono;
+	return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static clock_fn g_clock = steady_now_ms;
+
+int64_t now_ms()
+{
+	return g_clock();
+}
+
+void set_clock(clock_fn fn)
+{
+	g_clock = fn ? fn : steady_now_ms;
+}
+
+// -------------------------
+// Heap
+// -------------------------
+static size_t live_deadline_count()
+{
+	size_t n = 0;
+	for (const auto &kv : g_item_timers)
+		n += (kv.second.next_on >= 0) + (kv.second.off_at >= 0);
+	for (const auto &kv : g_runs)
+		n += (kv.second.step_at >= 0);
+	return n;
+}
+
+static bool is_live(const heap_entry &e)
+{
+	switch (e.kind) {
+	case deadline_kind::RepeatShow: {
+		auto it = g_item_timers.find(e.key);
+		return it != g_item_timers.end() && it->second.next_on == e.due;
+	}
+	case deadline_kind::AutoHide: {
+		auto it = g_item_timers.find(e.key);
+		return it != g_item_timers.end() && it->second.off_at == e.due;
+	}
+	case deadline_kind::GroupStep: {
+		auto it = g_runs.find(e.key);
+		return it != g_runs.end() && it->second.step_at == e.due;
+	}
+	}
+	return false;
+}
+
+static void compact_heap()
+{
+	std::vector<heap_entry> keep;
+	keep.reserve(g_heap.size());
+	while (!g_heap.empty()) {
+		if (is_live(g_heap.top()))
+			keep.push_back(g_heap.top());
+		g_heap.pop();
+	}
+	for (auto &e : keep)
+		g_heap.push(std::move(e));
+}
+
+static void arm_timer()
+{
+	while (!g_heap.empty() && !is_live(g_heap.top()))
+		g_heap.pop();
+
+	// Stale entries only accumulate through rescheduling; keep them bounded.
+	if (g_heap.size() > 64 && g_heap.size() > 4 * live_deadline_count())
+		compact_heap();
+
+	if (!g_timer)
+		return;
+
+	if (g_heap.empty()) {
+		g_timer->stop();
+		return;
+	}
+
+	const int64_t wait = std::max<int64_t>(0, g_heap.top().due - now_ms());
+	g_timer->start((int)std::min<int64_t>(wait, INT32_MAX));
+}
+
+static void push_deadline(deadline_kind kind, const std::string &key, int64_t due)
+{
+	heap_entry e;
+	e.due = due;
+	e.order = ++g_heap_order;
+	e.kind = kind;
+	e.key = key;
+	g_heap.push(std::move(e));
+}
+
+// -------------------------
+// Item repeat / auto-hide
+// -------------------------
+static bool in_running_group(const std::string &id)
+{
+	for (const auto &gid : smart_lt::groups_containing(id)) {
+		if (g_runs.find(gid) != g_runs.end())
+			return true;
+	}
+	return false;
+}
+
+static void set_next_on(const std::string &id, int64_t due)
+{
+	g_item_timers[id].next_on = due;
+	push_deadline(deadline_kind::RepeatShow, id, due);
+}
+
+static void set_off_at(const std::string &id, int64_t due)
+{
+	g_item_timers[id].off_at = due;
+	push_deadline(deadline_kind::AutoHide, id, due);
+}
+
+static void clear_item(const std::string &id)
+{
+	g_item_timers.erase(id);
+}
+
+// Mode matrix:
+//  - every==0 && visible==0   => full manual (no scheduling)
+//  - every==0 && visible>0    => manual show + auto-hide after visibleSec
+//  - every>0                 => full automated (auto-show + auto-hide). If visible==0, use default.
+//                               Only its own shows are auto-hidden; a manual show stays up.
+static void sync_item(const smart_lt::lower_third_cfg &c, int64_t now)
+{
+	if (in_running_group(c.id)) {
+		// Group run timing (visible_ms / interval_ms) is authoritative for members.
+		clear_item(c.id);
+		return;
+	}
+
+	const int every = c.repeat_every_sec;
+	const int visibleSec = c.repeat_visible_sec;
+	const bool visible = smart_lt::is_visible(c.id);
+
+	if (every <= 0 && visibleSec <= 0) {
+		clear_item(c.id);
+		return;
+	}
+
+	item_timers &t = g_item_timers[c.id];
+	if (every <= 0)
+		t.next_on = -1;
+	else if (t.next_on < 0 || t.every_sec != every)
+		set_next_on(c.id, now + (int64_t)every * 1000); // a new period restarts the cadence
+	t.every_sec = every;
+
+	if (!visible)
+		t.off_at = -1;
+	else if (every <= 0 && t.off_at < 0)
+		set_off_at(c.id, now + (int64_t)visibleSec * 1000);
+}
+
+static void sync_all_items()
+{
+	const int64_t now = now_ms();
+	const auto &items = smart_lt::all_const();
+
+	std::unordered_set<std::string> alive;
+	alive.reserve(items.size() * 2 + 1);
+	for (const auto &c : items)
+		alive.insert(c.id);
+	for (auto it = g_item_timers.begin(); it != g_item_timers.end();) {
+		if (alive.find(it->first) == alive.end())
+			it = g_item_timers.erase(it);
+		else
+			++it;
+	}
+
+	for (const auto &c : items)
+		sync_item(c, now);
+}
+
+static void fire_repeat_show(const std::string &id, int64_t due, int64_t now)
+{
+	g_item_timers[id].next_on = -1;
+
+	const auto *c = smart_lt::get_by_id_const(id);
+	if (!c || c->repeat_every_sec <= 0 || in_running_group(id)) {
+		if (c)
+			sync_item(*c, now);
+		return;
+	}
+
+	// Keep the cadence anchored to the original schedule, skipping missed slots.
+	const int64_t step = (int64_t)c->repeat_every_sec * 1000;
+	int64_t next = due;
+	while (next <= now)
+		next += step;
+	set_next_on(id, next);
+
+	if (!smart_lt::is_visible(id)) {
+		const int visibleSec = c->repeat_visible_sec > 0 ? c->repeat_visible_sec : kDefaultRepeatVisibleSec;
+		set_off_at(id, now + (int64_t)visibleSec * 1000);
+		smart_lt::set_visible_persist(id, true);
+	}
+}
+
+static void fire_auto_hide(const std::string &id)
+{
+	g_item_timers[id].off_at = -1;
+	if (smart_lt::is_visible(id) && !in_running_group(id))
+		smart_lt::set_visible_persist(id, false);
+}
+
+// -------------------------
+// Group runs
+// -------------------------
+static void shuffle(std::vector<int> &seq)
+{
+	auto *rng = QRandomGenerator::global();
+	for (int i = (int)seq.size() - 1; i > 0; --i) {
+		const int j = (int)rng->bounded((quint32)(i + 1));
+		std::swap(seq[(size_t)i], seq[(size_t)j]);
+	}
+}
+
+static void finish_group_run(const std::string &groupId)
+{
+	auto it = g_runs.find(groupId);
+	if (it == g_runs.end())
+		return;
+
+	const std::string currentId = it->second.current_id;
+	g_runs.erase(it);
+
+	// Best-effort hide currently shown item
+	if (!currentId.empty())
+		smart_lt::set_visible_persist(currentId, false);
+
+	// Members fall back to their own repeat settings.
+	if (const auto *car = smart_lt::get_group_by_id_const(groupId)) {
+		const int64_t now = now_ms();
+		for (const auto &mid : car->members) {
+			if (const auto *c = smart_lt::get_by_id_const(mid))
+				sync_item(*c, now);
+		}
+	}
+}
+
+static void fire_group_step(const std::string &groupId, int64_t now)
+{
+	auto it = g_runs.find(groupId);
+	if (it == g_runs.end())
+		return;
+	group_run &rt = it->second;
+	rt.step_at = -1;
+
+	const auto *car = smart_lt::get_group_by_id_const(groupId);
+	if (!car || car->members.empty()) {
+		finish_group_run(groupId);
+		return;
+	}
+
+	const int64_t visibleMs = std::max(0, car->visible_ms);
+	const int64_t intervalMs = std::max(0, car->interval_ms);
+	const int count = (int)car->members.size();
+
+	// Build / refresh sequence
+	if ((int)rt.seq.size() != count) {
+		rt.seq.clear();
+		rt.seq.reserve((size_t)count);
+		for (int i = 0; i < count; ++i)
+			rt.seq.push_back(i);
+		if (car->order_mode == 1)
+			shuffle(rt.seq);
+		rt.index = 0;
+	}
+
+	// Hide the previous/current item in either phase.
+	if (!rt.current_id.empty()) {
+		const std::string prev = rt.current_id;
+		rt.current_id.clear();
+		rt.hide_at = -1;
+		smart_lt::set_visible_persist(prev, false);
+	}
+
+	if (rt.phase_show) {
+		if (rt.index >= count) {
+			// End condition (non-loop): stop before showing beyond last
+			if (!car->loop) {
+				finish_group_run(groupId);
+				return;
+			}
+			// Loop condition: wrap and reshuffle per cycle if randomized
+			rt.index = 0;
+			if (car->order_mode == 1)
+				shuffle(rt.seq);
+		}
+
+		const int memberIdx = rt.seq[(size_t)rt.index];
+		rt.current_id = car->members[(size_t)memberIdx];
+		rt.hide_at = now + visibleMs;
+		rt.step_at = rt.hide_at;
+		rt.phase_show = false;
+		push_deadline(deadline_kind::GroupStep, groupId, rt.step_at);
+
+		smart_lt::set_visible_persist(rt.current_id, true);
+	} else {
+		rt.index++;
+
+		// If we just finished the last item and loop is disabled, stop now.
+		if (!car->loop && rt.index >= count) {
+			finish_group_run(groupId);
+			return;
+		}
+
+		rt.phase_show = true;
+		rt.step_at = now + intervalMs;
+		push_deadline(deadline_kind::GroupStep, groupId, rt.step_at);
+	}
+}
+
+void start_group_run(const std::string &group_id)
+{
+	const auto *car = smart_lt::get_group_by_id_const(group_id);
+	if (!car || car->members.empty())
+		return;
+
+	const std::string gid = car->id;
+	g_runs[gid] = group_run();
+	for (const auto &mid : car->members)
+		clear_item(mid);
+
+	fire_group_step(gid, now_ms());
+	arm_timer();
+}
+
+void stop_group_run(const std::string &group_id)
+{
+	finish_group_run(group_id);
+	arm_timer();
+}
+
+bool group_running(const std::string &group_id)
+{
+	return g_runs.find(group_id) != g_runs.end();
+}
+
+// -------------------------
+// Dispatch
+// -------------------------
+size_t run_due()
+{
+	size_t fired = 0;
+	const int64_t now = now_ms();
+
+	while (!g_heap.empty() && g_heap.top().due <= now) {
+		const heap_entry e = g_heap.top();
+		g_heap.pop();
+		if (!is_live(e))
+			continue;
+
+		switch (e.kind) {
+		case deadline_kind::RepeatShow:
+			fire_repeat_show(e.key, e.due, now);
+			break;
+		case deadline_kind::AutoHide:
+			fire_auto_hide(e.key);
+			break;
+		case deadline_kind::GroupStep:
+			fire_group_step(e.key, now);
+			break;
+		}
+		fired++;
+	}
+
+	arm_timer();
+	return fired;
+}
+
+countdown countdown_for(const std::string &lower_third_id)
+{
+	countdown out;
+	const int64_t now = now_ms();
+
+	for (const auto &kv : g_runs) {
+		if (kv.second.current_id == lower_third_id && kv.second.hide_at >= 0) {
+			out.group_owned = true;
+			out.hide_in_ms = std::max<int64_t>(0, kv.second.hide_at - now);
+			return out;
+		}
+	}
+
+	auto it = g_item_timers.find(lower_third_id);
+	if (it == g_item_timers.end())
+		return out;
+	if (it->second.off_at >= 0 && smart_lt::is_visible(lower_third_id))
+		out.hide_in_ms = std::max<int64_t>(0, it->second.off_at - now);
+	if (it->second.next_on >= 0)
+		out.next_in_ms = std::max<int64_t>(0, it->second.next_on - now);
+	return out;
+}
+
+// -------------------------
+// CORE events
+// -------------------------
+static void on_visibility_changed(const std::vector<std::string> &visibleIds)
+{
+	std::unordered_set<std::string> now(visibleIds.begin(), visibleIds.end());
+	const int64_t t = now_ms();
+
+	for (const auto &id : g_seen_visible) {
+		if (now.find(id) == now.end()) {
+			auto it = g_item_timers.find(id);
+			if (it != g_item_timers.end())
+				it->second.off_at = -1;
+		}
+	}
+	for (const auto &id : now) {
+		if (g_seen_visible.find(id) != g_seen_visible.end())
+			continue;
+		// A fresh show arms auto-hide where the mode matrix says so, unless one is already pending.
+		if (const auto *c = smart_lt::get_by_id_const(id))
+			sync_item(*c, t);
+	}
+
+	g_seen_visible = std::move(now);
+	arm_timer();
+}
+
+static void on_list_changed(bool reloaded)
+{
+	if (reloaded) {
+		g_item_timers.clear();
+		const auto ids = smart_lt::visible_ids();
+		g_seen_visible = std::unordered_set<std::string>(ids.begin(), ids.end());
+	}
+	sync_all_items();
+	arm_timer();
+}
+
+// Delivered on the Qt main thread (delivery_context::QtMain), which owns the deadlines.
+static void on_core_event(const smart_lt::core_event &ev, void *user)
+{
+	UNUSED_PARAMETER(user);
+	if (!g_timer)
+		return;
+
+	if (ev.type == smart_lt::event_type::VisibilityChanged)
+		on_visibility_changed(*ev.visible_ids);
+	else if (ev.type != smart_lt::event_type::ArtifactsRebuilt)
+		on_list_changed(ev.type == smart_lt::event_type::Reloaded);
+}
+
+bool init()
+{
+	if (g_timer)
+		return true;
+
+	g_timer = new QTimer();
+	g_timer->setSingleShot(true);
+	g_timer->setTimerType(Qt::PreciseTimer);
+	QObject::connect(g_timer, &QTimer::timeout, g_timer, []() { run_due(); });
+
+	smart_lt::listener_options opts;
+	opts.context = smart_lt::delivery_context::QtMain;
+	g_core_listener_token = smart_lt::add_event_listener(on_core_event, nullptr, opts);
+
+	on_list_changed(true);
+	return true;
+}
+
+void shutdown()
+{
+	if (g_core_listener_token) {
+		smart_lt::remove_event_listener(g_core_listener_token);
+		g_core_listener_token = 0;
+	}
+
+	delete g_timer;
+	g_timer = nullptr;
+
+	g_heap = decltype(g_heap)();
+	g_item_timers.clear();
+	g_runs.clear();
+	g_seen_visible.clear();
+}
+
+} // namespace smart_lt::sched
@@ -4,6 +4,7 @@
 #include "headers/api.hpp"
 
 #include "core.hpp"
+#include "avatar_assets.hpp"
 
 #include <obs.h>
 
@@ -932,7 +933,7 @@ void LowerThirdSettingsDialog::loadFromState()
 	if (currentId.isEmpty())
 		return;
 
-	auto *cfg = smart_lt::get_by_id(currentId.toStdString());
+	const auto *cfg = smart_lt::get_by_id_const(currentId.toStdString());
 	if (!cfg)
 		return;
 
@@ -1060,41 +1061,42 @@ void LowerThirdSettingsDialog::saveToState()
 	if (currentId.isEmpty())
 		return;
 
-	auto *cfg = smart_lt::get_by_id(currentId.toStdString());
-	if (!cfg)
+	const auto *stored = smart_lt::get_by_id_const(currentId.toStdString());
+	if (!stored)
 		return;
+	smart_lt::lower_third_cfg cfg = *stored; // committed with update_lower_third()
 
-	cfg->title = titleEdit->text().toStdString();
+	cfg.title = titleEdit->text().toStdString();
 	if (labelEdit)
-		cfg->label = labelEdit->text().toStdString();
-	cfg->subtitle = subtitleEdit->text().toStdString();
+		cfg.label = labelEdit->text().toStdString();
+	cfg.subtitle = subtitleEdit->text().toStdString();
 
-	cfg->anim_in = animInCombo->currentData().toString().toStdString();
-	cfg->anim_out = animOutCombo->currentData().toString().toStdString();
+	cfg.anim_in = animInCombo->currentData().toString().toStdString();
+	cfg.anim_out = animOutCombo->currentData().toString().toStdString();
 
-	cfg->font_family = fontCombo->currentFont().family().toStdString();
-	cfg->lt_position = posCombo->currentData().toString().toStdString();
+	cfg.font_family = fontCombo->currentFont().family().toStdString();
+	cfg.lt_position = posCombo->currentData().toString().toStdString();
 
 	if (currentPrimaryColor)
-		cfg->primary_color = currentPrimaryColor->name(QColor::HexRgb).toStdString();
+		cfg.primary_color = currentPrimaryColor->name(QColor::HexRgb).toStdString();
 	if (currentSecondaryColor)
-		cfg->secondary_color = currentSecondaryColor->name(QColor::HexRgb).toStdString();
+		cfg.secondary_color = currentSecondaryColor->name(QColor::HexRgb).toStdString();
 	if (currentTitleColor)
-		cfg->title_color = currentTitleColor->name(QColor::HexRgb).toStdString();
+		cfg.title_color = currentTitleColor->name(QColor::HexRgb).toStdString();
 	if (currentSubtitleColor)
-		cfg->subtitle_color = currentSubtitleColor->name(QColor::HexRgb).toStdString();
+		cfg.subtitle_color = currentSubtitleColor->name(QColor::HexRgb).toStdString();
 
 	if (opacitySlider) {
 		int op = opacitySlider->value();
 		op = std::max(0, std::min(100, op));
 		op = (op / 5) * 5;
-		cfg->opacity = op;
+		cfg.opacity = op;
 	}
 
 	if (radiusSlider) {
 		int rad = radiusSlider->value();
 		rad = std::max(0, std::min(100, rad));
-		cfg->radius = rad;
+		cfg.radius = rad;
 	}
 
 	{
@@ -1104,61 +1106,39 @@ void LowerThirdSettingsDialog::saveToState()
 
 		const QString seq = normalize(hotkeyEdit->keySequence().toString(QKeySequence::PortableText));
 		// Enforce uniqueness across all lower thirds and groups.
-		if (!seq.isEmpty()) {
-			for (auto &it : smart_lt::all()) {
-				if (it.id == cfg->id)
-					continue;
-				const QString other = normalize(QString::fromStdString(it.hotkey));
-				if (!other.isEmpty() && other == seq) {
-					it.hotkey.clear();
-					smart_lt::notify_list_updated(it.id);
-				}
-			}
-			bool clearedAnyGroup = false;
-			for (auto &g : smart_lt::groups()) {
-				const QString other = normalize(QString::fromStdString(g.toggle_hotkey));
-				if (!other.isEmpty() && other == seq) {
-					g.toggle_hotkey.clear();
-					clearedAnyGroup = true;
-				}
-			}
-			// If we cleared any group hotkeys, notify so dock refreshes and shortcuts are rebuilt.
-			if (clearedAnyGroup)
-				smart_lt::notify_list_updated();
-		}
-		cfg->hotkey = seq.toStdString();
+		if (!seq.isEmpty())
+			smart_lt::release_hotkey(seq.toStdString(), cfg.id);
+		cfg.hotkey = seq.toStdString();
 	}
-	cfg->repeat_every_sec = repeatEverySpin->value();
-	cfg->repeat_visible_sec = repeatVisibleSpin->value();
+	cfg.repeat_every_sec = repeatEverySpin->value();
+	cfg.repeat_visible_sec = repeatVisibleSpin->value();
 
 	if (titleSizeSpin)
-		cfg->title_size = titleSizeSpin->value();
+		cfg.title_size = titleSizeSpin->value();
 	if (subtitleSizeSpin)
-		cfg->subtitle_size = subtitleSizeSpin->value();
+		cfg.subtitle_size = subtitleSizeSpin->value();
 	if (avatarWidthSpin)
-		cfg->avatar_width = avatarWidthSpin->value();
+		cfg.avatar_width = avatarWidthSpin->value();
 	if (avatarHeightSpin)
-		cfg->avatar_height = avatarHeightSpin->value();
+		cfg.avatar_height = avatarHeightSpin->value();
 
-	cfg->html_template = htmlEdit->toPlainText().toStdString();
-	cfg->css_template = cssEdit->toPlainText().toStdString();
-	cfg->js_template = jsEdit->toPlainText().toStdString();
+	cfg.html_template = htmlEdit->toPlainText().toStdString();
+	cfg.css_template = cssEdit->toPlainText().toStdString();
+	cfg.js_template = jsEdit->toPlainText().toStdString();
 
 	if (!pendingProfilePicturePath.isEmpty() && smart_lt::has_output_dir()) {
 		const QString outDir = QString::fromStdString(smart_lt::output_dir());
 		QDir dir(outDir);
 
-		if (!cfg->profile_picture.empty()) {
-			const QString oldPath = dir.filePath(QString::fromStdString(cfg->profile_picture));
-			if (QFile::exists(oldPath))
-				QFile::remove(oldPath);
-		}
+		// Deleted once no page kept for rollback loads it.
+		if (!cfg.profile_picture.empty())
+			smart_lt::avatar::discard_picture(outDir.toStdString(), cfg.profile_picture);
 
 		const QFileInfo fi(pendingProfilePicturePath);
 		const QString ext = fi.suffix().toLower();
 		const qint64 ts = QDateTime::currentMSecsSinceEpoch();
 
-		QString newFileName = QString("%1_%2").arg(QString::fromStdString(cfg->id)).arg(ts);
+		QString newFileName = QString("%1_%2").arg(QString::fromStdString(cfg.id)).arg(ts);
 		if (!ext.isEmpty())
 			newFileName += "." + ext;
 
@@ -1166,8 +1146,11 @@ void LowerThirdSettingsDialog::saveToState()
 		QFile::remove(destPath);
 
 		if (QFile::copy(pendingProfilePicturePath, destPath)) {
-			cfg->profile_picture = newFileName.toStdString();
+			cfg.profile_picture = newFileName.toStdString();
 			profilePictureEdit->setText(newFileName);
+			// Start scaling it on the avatar pool right away; the overlay uses the original until then.
+			smart_lt::avatar::rendered_file(outDir.toStdString(), cfg.profile_picture, cfg.avatar_width,
+							cfg.avatar_height);
 		} else {
 			LOGW("Failed to copy profile picture '%s' -> '%s'",
 			     pendingProfilePicturePath.toUtf8().constData(), destPath.toUtf8().constData());
@@ -1180,8 +1163,8 @@ void LowerThirdSettingsDialog::saveToState()
 		const QString outDir = QString::fromStdString(smart_lt::output_dir());
 		QDir dir(outDir);
 
-		if (!cfg->anim_in_sound.empty()) {
-			const QString oldPath = dir.filePath(QString::fromStdString(cfg->anim_in_sound));
+		if (!cfg.anim_in_sound.empty()) {
+			const QString oldPath = dir.filePath(QString::fromStdString(cfg.anim_in_sound));
 			if (QFile::exists(oldPath))
 				QFile::remove(oldPath);
 		}
@@ -1190,7 +1173,7 @@ void LowerThirdSettingsDialog::saveToState()
 		const QString ext = fi.suffix().toLower();
 		const qint64 ts = QDateTime::currentMSecsSinceEpoch();
 
-		QString newFileName = QString("%1_in_%2").arg(QString::fromStdString(cfg->id)).arg(ts);
+		QString newFileName = QString("%1_in_%2").arg(QString::fromStdString(cfg.id)).arg(ts);
 		if (!ext.isEmpty())
 			newFileName += "." + ext;
 
@@ -1198,7 +1181,7 @@ void LowerThirdSettingsDialog::saveToState()
 		QFile::remove(destPath);
 
 		if (QFile::copy(pendingAnimInSoundPath, destPath)) {
-			cfg->anim_in_sound = newFileName.toStdString();
+			cfg.anim_in_sound = newFileName.toStdString();
 			animInSoundEdit->setText(newFileName);
 		} else {
 			LOGW("Failed to copy anim-in sound '%s' -> '%s'", pendingAnimInSoundPath.toUtf8().constData(),
@@ -1212,8 +1195,8 @@ void LowerThirdSettingsDialog::saveToState()
 		const QString outDir = QString::fromStdString(smart_lt::output_dir());
 		QDir dir(outDir);
 
-		if (!cfg->anim_out_sound.empty()) {
-			const QString oldPath = dir.filePath(QString::fromStdString(cfg->anim_out_sound));
+		if (!cfg.anim_out_sound.empty()) {
+			const QString oldPath = dir.filePath(QString::fromStdString(cfg.anim_out_sound));
 			if (QFile::exists(oldPath))
 				QFile::remove(oldPath);
 		}
@@ -1222,7 +1205,7 @@ void LowerThirdSettingsDialog::saveToState()
 		const QString ext = fi.suffix().toLower();
 		const qint64 ts = QDateTime::currentMSecsSinceEpoch();
 
-		QString newFileName = QString("%1_out_%2").arg(QString::fromStdString(cfg->id)).arg(ts);
+		QString newFileName = QString("%1_out_%2").arg(QString::fromStdString(cfg.id)).arg(ts);
 		if (!ext.isEmpty())
 			newFileName += "." + ext;
 
@@ -1230,7 +1213,7 @@ void LowerThirdSettingsDialog::saveToState()
 		QFile::remove(destPath);
 
 		if (QFile::copy(pendingAnimOutSoundPath, destPath)) {
-			cfg->anim_out_sound = newFileName.toStdString();
+			cfg.anim_out_sound = newFileName.toStdString();
 			animOutSoundEdit->setText(newFileName);
 		} else {
 			LOGW("Failed to copy anim-out sound '%s' -> '%s'", pendingAnimOutSoundPath.toUtf8().constData(),
@@ -1240,7 +1223,7 @@ void LowerThirdSettingsDialog::saveToState()
 		pendingAnimOutSoundPath.clear();
 	}
 
-	smart_lt::save_state_json();
+	smart_lt::update_lower_third(cfg);
 }
 
 void LowerThirdSettingsDialog::onSaveAndApply()
@@ -1249,9 +1232,8 @@ void LowerThirdSettingsDialog::onSaveAndApply()
 
 	// Rebuild/swap updates the Browser Source, but the dock UI still needs a
 	// model refresh. Emit a core list-change event so any listeners re-sync.
-	if (smart_lt::rebuild_and_swap()) {
-		smart_lt::notify_list_updated(currentId.toStdString());
-	}
+	smart_lt::rebuild_and_swap();
+	smart_lt::notify_list_updated(currentId.toStdString());
 	close();
 }
 void LowerThirdSettingsDialog::onBrowseProfilePicture()
@@ -1270,11 +1252,12 @@ void LowerThirdSettingsDialog::onDeleteProfilePicture()
 	if (currentId.isEmpty())
 		return;
 
-	auto *cfg = smart_lt::get_by_id(currentId.toStdString());
-	if (!cfg)
+	const auto *stored = smart_lt::get_by_id_const(currentId.toStdString());
+	if (!stored)
 		return;
+	smart_lt::lower_third_cfg cfg = *stored;
 
-	if (cfg->profile_picture.empty() && pendingProfilePicturePath.isEmpty()) {
+	if (cfg.profile_picture.empty() && pendingProfilePicturePath.isEmpty()) {
 		profilePictureEdit->clear();
 		return;
 	}
@@ -1286,18 +1269,15 @@ void LowerThirdSettingsDialog::onDeleteProfilePicture()
 	if (btn != QMessageBox::Yes)
 		return;
 
-	if (!cfg->profile_picture.empty() && smart_lt::has_output_dir()) {
-		QDir dir(QString::fromStdString(smart_lt::output_dir()));
-		const QString oldPath = dir.filePath(QString::fromStdString(cfg->profile_picture));
-		if (QFile::exists(oldPath))
-			QFile::remove(oldPath);
-	}
+	// Deleted once no page kept for rollback loads it.
+	if (!cfg.profile_picture.empty() && smart_lt::has_output_dir())
+		smart_lt::avatar::discard_picture(smart_lt::output_dir(), cfg.profile_picture);
 
-	cfg->profile_picture.clear();
+	cfg.profile_picture.clear();
 	pendingProfilePicturePath.clear();
 	profilePictureEdit->clear();
 
-	smart_lt::save_state_json();
+	smart_lt::update_lower_third(cfg);
 }
 
 void LowerThirdSettingsDialog::onBrowseAnimInSound()
@@ -1316,23 +1296,24 @@ void LowerThirdSettingsDialog::onDeleteAnimInSound()
 	if (currentId.isEmpty())
 		return;
 
-	auto *cfg = smart_lt::get_by_id(currentId.toStdString());
-	if (!cfg)
+	const auto *stored = smart_lt::get_by_id_const(currentId.toStdString());
+	if (!stored)
 		return;
+	smart_lt::lower_third_cfg cfg = *stored;
 
-	if (!cfg->anim_in_sound.empty() && smart_lt::has_output_dir()) {
+	if (!cfg.anim_in_sound.empty() && smart_lt::has_output_dir()) {
 		const QString outDir = QString::fromStdString(smart_lt::output_dir());
 		QDir dir(outDir);
-		const QString oldPath = dir.filePath(QString::fromStdString(cfg->anim_in_sound));
+		const QString oldPath = dir.filePath(QString::fromStdString(cfg.anim_in_sound));
 		if (QFile::exists(oldPath))
 			QFile::remove(oldPath);
 	}
 
-	cfg->anim_in_sound.clear();
+	cfg.anim_in_sound.clear();
 	pendingAnimInSoundPath.clear();
 	animInSoundEdit->clear();
 
-	smart_lt::save_state_json();
+	smart_lt::update_lower_third(cfg);
 }
 
 void LowerThirdSettingsDialog::onBrowseAnimOutSound()
@@ -1352,23 +1333,24 @@ void LowerThirdSettingsDialog::onDeleteAnimOutSound()
 	if (currentId.isEmpty())
 		return;
 
-	auto *cfg = smart_lt::get_by_id(currentId.toStdString());
-	if (!cfg)
+	const auto *stored = smart_lt::get_by_id_const(currentId.toStdString());
+	if (!stored)
 		return;
+	smart_lt::lower_third_cfg cfg = *stored;
 
-	if (!cfg->anim_out_sound.empty() && smart_lt::has_output_dir()) {
+	if (!cfg.anim_out_sound.empty() && smart_lt::has_output_dir()) {
 		const QString outDir = QString::fromStdString(smart_lt::output_dir());
 		QDir dir(outDir);
-		const QString oldPath = dir.filePath(QString::fromStdString(cfg->anim_out_sound));
+		const QString oldPath = dir.filePath(QString::fromStdString(cfg.anim_out_sound));
 		if (QFile::exists(oldPath))
 			QFile::remove(oldPath);
 	}
 
-	cfg->anim_out_sound.clear();
+	cfg.anim_out_sound.clear();
 	pendingAnimOutSoundPath.clear();
 	animOutSoundEdit->clear();
 
-	smart_lt::save_state_json();
+	smart_lt::update_lower_third(cfg);
 }
 
 
@@ -1859,7 +1841,7 @@ void LowerThirdSettingsDialog::onExportTemplateClicked()
 		return;
 	}
 
-	auto *cfg = smart_lt::get_by_id(currentId.toStdString());
+	const auto *cfg = smart_lt::get_by_id_const(currentId.toStdString());
 	if (!cfg)
 		return;
 
@@ -2114,24 +2096,25 @@ void LowerThirdSettingsDialog::onImportTemplateClicked()
 		return;
 	}
 
-	auto *cfg = smart_lt::get_by_id(currentId.toStdString());
-	if (!cfg)
+	const auto *stored = smart_lt::get_by_id_const(currentId.toStdString());
+	if (!stored)
 		return;
+	smart_lt::lower_third_cfg cfg = *stored;
 
 	const QJsonObject obj = doc.object();
 
-	cfg->title = obj.value("title").toString().toStdString();
-	cfg->subtitle = obj.value("subtitle").toString().toStdString();
-	cfg->title_size = obj.value("title_size").toInt(cfg->title_size);
-	cfg->subtitle_size = obj.value("subtitle_size").toInt(cfg->subtitle_size);
-	cfg->title_size = std::max(6, std::min(200, cfg->title_size));
-	cfg->subtitle_size = std::max(6, std::min(200, cfg->subtitle_size));
-	cfg->avatar_width = obj.value("avatar_width").toInt(cfg->avatar_width);
-	cfg->avatar_height = obj.value("avatar_height").toInt(cfg->avatar_height);
-	cfg->avatar_width = std::max(16, std::min(512, cfg->avatar_width));
-	cfg->avatar_height = std::max(16, std::min(512, cfg->avatar_height));
-	cfg->anim_in = obj.value("anim_in").toString().toStdString();
-	cfg->anim_out = obj.value("anim_out").toString().toStdString();
+	cfg.title = obj.value("title").toString().toStdString();
+	cfg.subtitle = obj.value("subtitle").toString().toStdString();
+	cfg.title_size = obj.value("title_size").toInt(cfg.title_size);
+	cfg.subtitle_size = obj.value("subtitle_size").toInt(cfg.subtitle_size);
+	cfg.title_size = std::max(6, std::min(200, cfg.title_size));
+	cfg.subtitle_size = std::max(6, std::min(200, cfg.subtitle_size));
+	cfg.avatar_width = obj.value("avatar_width").toInt(cfg.avatar_width);
+	cfg.avatar_height = obj.value("avatar_height").toInt(cfg.avatar_height);
+	cfg.avatar_width = std::max(16, std::min(512, cfg.avatar_width));
+	cfg.avatar_height = std::max(16, std::min(512, cfg.avatar_height));
+	cfg.anim_in = obj.value("anim_in").toString().toStdString();
+	cfg.anim_out = obj.value("anim_out").toString().toStdString();
 	{
 		const QString sin = obj.value("sound_in").toString();
 		const QString sout = obj.value("sound_out").toString();
@@ -2143,48 +2126,48 @@ void LowerThirdSettingsDialog::onImportTemplateClicked()
 		Q_UNUSED(legacyOut);
 	}
 
-	cfg->font_family = obj.value("font_family").toString().toStdString();
-	cfg->lt_position = obj.value("lt_position").toString().toStdString();
+	cfg.font_family = obj.value("font_family").toString().toStdString();
+	cfg.lt_position = obj.value("lt_position").toString().toStdString();
 
-	cfg->primary_color = obj.value("primary_color").toString().toStdString();
-	cfg->secondary_color = obj.value("secondary_color").toString().toStdString();
-	cfg->title_color = obj.value("title_color").toString().toStdString();
-	cfg->subtitle_color = obj.value("subtitle_color").toString().toStdString();
+	cfg.primary_color = obj.value("primary_color").toString().toStdString();
+	cfg.secondary_color = obj.value("secondary_color").toString().toStdString();
+	cfg.title_color = obj.value("title_color").toString().toStdString();
+	cfg.subtitle_color = obj.value("subtitle_color").toString().toStdString();
 
-	if (cfg->primary_color.empty()) cfg->primary_color = obj.value("bg_color").toString().toStdString();
-	if (cfg->title_color.empty()) cfg->title_color = obj.value("text_color").toString().toStdString();
-	if (cfg->secondary_color.empty()) cfg->secondary_color = cfg->primary_color;
-	if (cfg->subtitle_color.empty()) cfg->subtitle_color = cfg->title_color;
-	cfg->opacity = obj.value("opacity").toInt(cfg->opacity);
-	cfg->radius = obj.value("radius").toInt(cfg->radius);
+	if (cfg.primary_color.empty()) cfg.primary_color = obj.value("bg_color").toString().toStdString();
+	if (cfg.title_color.empty()) cfg.title_color = obj.value("text_color").toString().toStdString();
+	if (cfg.secondary_color.empty()) cfg.secondary_color = cfg.primary_color;
+	if (cfg.subtitle_color.empty()) cfg.subtitle_color = cfg.title_color;
+	cfg.opacity = obj.value("opacity").toInt(cfg.opacity);
+	cfg.radius = obj.value("radius").toInt(cfg.radius);
 
-	cfg->opacity = std::max(0, std::min(100, cfg->opacity));
-	cfg->opacity = (cfg->opacity / 5) * 5;
-	cfg->radius = std::max(0, std::min(100, cfg->radius));
+	cfg.opacity = std::max(0, std::min(100, cfg.opacity));
+	cfg.opacity = (cfg.opacity / 5) * 5;
+	cfg.radius = std::max(0, std::min(100, cfg.radius));
 
-	cfg->hotkey = obj.value("hotkey").toString().toStdString();
-	cfg->repeat_every_sec = obj.value("repeat_every_sec").toInt(0);
-	cfg->repeat_visible_sec = obj.value("repeat_visible_sec").toInt(0);
+	cfg.hotkey = obj.value("hotkey").toString().toStdString();
+	cfg.repeat_every_sec = obj.value("repeat_every_sec").toInt(0);
+	cfg.repeat_visible_sec = obj.value("repeat_visible_sec").toInt(0);
 
 	{
 		QFile f(htmlPath);
 		if (f.open(QIODevice::ReadOnly))
-			cfg->html_template = QString::fromUtf8(f.readAll()).toStdString();
+			cfg.html_template = QString::fromUtf8(f.readAll()).toStdString();
 	}
 	{
 		QFile f(cssPath);
 		if (f.open(QIODevice::ReadOnly))
-			cfg->css_template = QString::fromUtf8(f.readAll()).toStdString();
+			cfg.css_template = QString::fromUtf8(f.readAll()).toStdString();
 	}
 	{
 		if (!jsPath.isEmpty()) {
 			QFile f(jsPath);
 			if (f.open(QIODevice::ReadOnly))
-				cfg->js_template = QString::fromUtf8(f.readAll()).toStdString();
+				cfg.js_template = QString::fromUtf8(f.readAll()).toStdString();
 			else
-				cfg->js_template.clear();
+				cfg.js_template.clear();
 		} else {
-			cfg->js_template.clear();
+			cfg.js_template.clear();
 		}
 	}
 
@@ -2193,22 +2176,19 @@ void LowerThirdSettingsDialog::onImportTemplateClicked()
 		if (!outDir.isEmpty()) {
 			QDir dir(outDir);
 
-			if (!cfg->profile_picture.empty()) {
-				const QString oldPath = dir.filePath(QString::fromStdString(cfg->profile_picture));
-				if (QFile::exists(oldPath))
-					QFile::remove(oldPath);
-			}
+			if (!cfg.profile_picture.empty())
+				smart_lt::avatar::discard_picture(outDir.toStdString(), cfg.profile_picture);
 
 			const QString ext = QFileInfo(profilePicPath).suffix().toLower();
 			const QString newName =
-				ext.isEmpty() ? QString("%1_profile").arg(QString::fromStdString(cfg->id))
-					      : QString("%1_profile.%2").arg(QString::fromStdString(cfg->id)).arg(ext);
+				ext.isEmpty() ? QString("%1_profile").arg(QString::fromStdString(cfg.id))
+					      : QString("%1_profile.%2").arg(QString::fromStdString(cfg.id)).arg(ext);
 
 			const QString dest = dir.filePath(newName);
 			QFile::remove(dest);
 
 			if (QFile::copy(profilePicPath, dest)) {
-				cfg->profile_picture = newName.toStdString();
+				cfg.profile_picture = newName.toStdString();
 			}
 
 			if (smart_lt::has_output_dir()) {
@@ -2220,7 +2200,7 @@ void LowerThirdSettingsDialog::onImportTemplateClicked()
 						if (srcPath.isEmpty())
 							return;
 
-						std::string &field = isIn ? cfg->anim_in_sound : cfg->anim_out_sound;
+						std::string &field = isIn ? cfg.anim_in_sound : cfg.anim_out_sound;
 						if (!field.empty()) {
 							const QString oldPath =
 								dir.filePath(QString::fromStdString(field));
@@ -2233,10 +2213,10 @@ void LowerThirdSettingsDialog::onImportTemplateClicked()
 						const QString base = isIn ? "soundIn" : "soundOut";
 						const QString newName =
 							ext.isEmpty() ? QString("%1_%2")
-										.arg(QString::fromStdString(cfg->id))
+										.arg(QString::fromStdString(cfg.id))
 										.arg(base)
 								      : QString("%1_%2.%3")
-										.arg(QString::fromStdString(cfg->id))
+										.arg(QString::fromStdString(cfg.id))
 										.arg(base)
 										.arg(ext);
 
@@ -2254,7 +2234,7 @@ void LowerThirdSettingsDialog::onImportTemplateClicked()
 		}
 	}
 
-	smart_lt::save_state_json();
+	smart_lt::update_lower_third(cfg);
 
 	loadFromState();
 
@@ -0,0 +1,116 @@
+// template.cpp
+#include "template.hpp"
+
+namespace smart_lt::tpl {
+
+struct slot_name {
+	std::string_view name;
+	slot s;
+};
+
+static constexpr slot_name kSlotNames[] = {
+	{"ID", slot::Id},
+	{"PRIMARY_COLOR", slot::PrimaryColor},
+	{"SECONDARY_COLOR", slot::SecondaryColor},
+	{"TITLE_COLOR", slot::TitleColor},
+	{"SUBTITLE_COLOR", slot::SubtitleColor},
+	{"TITLE", slot::Title},
+	{"SUBTITLE", slot::Subtitle},
+	{"OPACITY", slot::Opacity},
+	{"RADIUS", slot::Radius},
+	{"FONT_FAMILY", slot::FontFamily},
+	{"TITLE_SIZE", slot::TitleSize},
+	{"SUBTITLE_SIZE", slot::SubtitleSize},
+	{"AVATAR_WIDTH", slot::AvatarWidth},
+	{"AVATAR_HEIGHT", slot::AvatarHeight},
+	{"ANIM_IN", slot::AnimIn},
+	{"ANIM_OUT", slot::AnimOut},
+	{"PROFILE_PICTURE_URL", slot::ProfilePictureUrl},
+	{"SOUND_IN_URL", slot::SoundInUrl},
+	{"SOUND_OUT_URL", slot::SoundOutUrl},
+	{"BG_COLOR", slot::BgColor},
+	{"TEXT_COLOR", slot::TextColor},
+};
+
+bool lookup_slot(std::string_view name, slot &out)
+{
+	for (const auto &n : kSlotNames) {
+		if (n.name == name) {
+			out = n.s;
+			return true;
+		}
+	}
+	return false;
+}
+
+compiled_template compiled_template::compile(std::string source)
+{
+	compiled_template t;
+	t.src_ = std::move(source);
+
+	const std::string &s = t.src_;
+	size_t litStart = 0;
+	size_t pos = 0;
+
+	auto flush_literal = [&](size_t end) {
+		if (end > litStart) {
+			token tk;
+			tk.offset = (uint32_t)litStart;
+			tk.length = (uint32_t)(end - litStart);
+			t.tokens_.push_back(tk);
+			t.literal_bytes_ += end - litStart;
+		}
+	};
+
+	while ((pos = s.find("{{", pos)) != std::string::npos) {
+		const size_t close = s.find("}}", pos + 2);
+		if (close == std::string::npos)
+			break;
+
+		slot sl;
+		if (!lookup_slot(std::string_view(s).substr(pos + 2, close - pos - 2), sl)) {
+			// Not ours (or "{{{{"): keep scanning from the next brace.
+			pos += 1;
+			continue;
+		}
+
+		flush_literal(pos);
+
+		token tk;
+		tk.s = sl;
+		t.tokens_.push_back(tk);
+		t.slots_++;
+
+		pos = close + 2;
+		litStart = pos;
+	}
+
+	flush_literal(s.size());
+	return t;
+}
+
+void compiled_template::render_into(const values &v, std::string &out) const
+{
+	size_t need = literal_bytes_;
+	for (const auto &tk : tokens_) {
+		if (tk.s != slot::Count)
+			need += v[(size_t)tk.s].size();
+	}
+	out.reserve(out.size() + need);
+
+	for (const auto &tk : tokens_) {
+		if (tk.s == slot::Count)
+			out.append(src_, tk.offset, tk.length);
+		else
+			out += v[(size_t)tk.s];
+	}
+}
+
+std::string compiled_template::render(const values &v) const
+{
+	std::string out;
+	render_into(v, out);
+	return out;
+}
+
+} // namespace smart_lt::tpl
@@ -0,0 +1,324 @@
+#define LOG_TAG "[" PLUGIN_NAME "][push]"
+#include "visibility_server.hpp"
+
+#include "core.hpp"
+
+#include <QByteArray>
+#include <QHostAddress>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace smart_lt::push {
+
+static QTcpServer *g_server = nullptr;
+static std::vector<QTcpSocket *> g_streams;                   // handshake done, receiving events
+static std::unordered_map<QTcpSocket *, QByteArray> g_pending; // request bytes read so far
+static std::vector<std::string> g_visible;                    // last visible set streamed
+static std::string g_token;
+static uint64_t g_core_listener_token = 0;
+
+static constexpr int kKeepAliveMs = 15000;
+static constexpr int kMaxRequestBytes = 8192;
+
+// -------------------------
+// Local helpers
+// -------------------------
+static std::string random_token()
+{
+	static const char *hex = "0123456789abcdef";
+	std::random_device rd;
+	std::string out;
+	for (int i = 0; i < 32; ++i)
+		out.push_back(hex[rd() & 0xF]);
+	return out;
+}
+
+static QJsonArray to_json_array(const std::vector<std::string> &ids)
+{
+	QJsonArray arr;
+	for (const auto &id : ids)
+		arr.append(QString::fromStdString(id));
+	return arr;
+}
+
+static QByteArray sse_frame(const char *event, const QJsonObject &data)
+{
+	QByteArray out("event: ");
+	out.append(event);
+	out.append("\ndata: ");
+	out.append(QJsonDocument(data).toJson(QJsonDocument::Compact));
+	out.append("\n\n");
+	return out;
+}
+
+static QByteArray snapshot_frame()
+{
+	QJsonObject o;
+	o["visible"] = to_json_array(g_visible);
+	return sse_frame("snapshot", o);
+}
+
+static void broadcast(const QByteArray &frame)
+{
+	for (auto *s : g_streams)
+		s->write(frame);
+}
+
+static void forget_socket(QTcpSocket *s)
+{
+	g_pending.erase(s);
+	g_streams.erase(std::remove(g_streams.begin(), g_streams.end(), s), g_streams.end());
+	s->deleteLater();
+}
+
+static void reject(QTcpSocket *s, const char *status)
+{
+	QByteArray resp("HTTP/1.1 ");
+	resp.append(status);
+	resp.append("\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+	s->write(resp);
+	s->disconnectFromHost();
+}
+
+static bool request_line_is(const QByteArray &line, const char *method, const char *path)
+{
+	const QByteArray expected =
+		QByteArray(method) + " " + path + "?token=" + QByteArray::fromStdString(g_token) + " ";
+	return line.startsWith(expected.constData());
+}
+
+static int content_length(const QByteArray &headers)
+{
+	const QByteArray lower = headers.toLower();
+	const int at = lower.indexOf("\r\ncontent-length:");
+	if (at < 0)
+		return 0;
+	const int start = at + 17;
+	const int eol = lower.indexOf("\r\n", start);
+	return lower.mid(start, eol < 0 ? -1 : eol - start).trimmed().toInt();
+}
+
+// Body: one {"id", "seq", "phase": "start"|"end"} object or an array of them.
+static void handle_ack(const QByteArray &body)
+{
+	const QJsonDocument doc = QJsonDocument::fromJson(body);
+
+	auto one = [](const QJsonObject &o) {
+		const std::string id = o.value("id").toString().toStdString();
+		const QString phase = o.value("phase").toString();
+		if (id.empty() || (phase != "start" && phase != "end"))
+			return;
+		const uint64_t seq = (uint64_t)o.value("seq").toDouble(0);
+		smart_lt::record_visibility_ack(id, seq,
+						phase == "start" ? smart_lt::visibility_ack_phase::Start
+								 : smart_lt::visibility_ack_phase::End);
+	};
+
+	if (doc.isObject()) {
+		one(doc.object());
+	} else if (doc.isArray()) {
+		for (const auto &v : doc.array())
+			one(v.toObject());
+	}
+}
+
+// Served: "GET /events?token=<token>" (event stream) and "POST /ack?token=<token>" (transition
+// acknowledgements). Everything else is refused.
+static void handle_request(QTcpSocket *s, const QByteArray &headers, const QByteArray &body)
+{
+	const int eol = headers.indexOf("\r\n");
+	const QByteArray line = headers.left(eol < 0 ? headers.size() : eol);
+
+	if (request_line_is(line, "POST", "/ack")) {
+		handle_ack(body);
+		s->write("HTTP/1.1 204 No Content\r\n"
+			 "Access-Control-Allow-Origin: *\r\n"
+			 "Content-Length: 0\r\n"
+			 "Connection: close\r\n"
+			 "\r\n");
+		s->disconnectFromHost();
+		return;
+	}
+
+	if (!request_line_is(line, "GET", "/events")) {
+		reject(s, "404 Not Found");
+		return;
+	}
+
+	// The page is a file:// document, so its origin is "null".
+	s->write("HTTP/1.1 200 OK\r\n"
+		 "Content-Type: text/event-stream\r\n"
+		 "Cache-Control: no-cache\r\n"
+		 "Connection: keep-alive\r\n"
+		 "Access-Control-Allow-Origin: *\r\n"
+		 "\r\n"
+		 "retry: 1000\n\n");
+	s->write(snapshot_frame());
+	g_streams.push_back(s);
+}
+
+static void on_ready_read(QTcpSocket *s)
+{
+	if (std::find(g_streams.begin(), g_streams.end(), s) != g_streams.end()) {
+		s->readAll(); // nothing is expected from a stream client
+		return;
+	}
+
+	QByteArray &buf = g_pending[s];
+	buf.append(s->readAll());
+
+	const int headerEnd = buf.indexOf("\r\n\r\n");
+	if (headerEnd < 0) {
+		if (buf.size() > kMaxRequestBytes) {
+			g_pending.erase(s);
+			reject(s, "431 Request Header Fields Too Large");
+		}
+		return;
+	}
+
+	const QByteArray headers = buf.left(headerEnd + 2);
+	const int bodyLen = content_length(headers);
+	if (bodyLen < 0 || bodyLen > kMaxRequestBytes) {
+		g_pending.erase(s);
+		reject(s, "413 Payload Too Large");
+		return;
+	}
+	if (buf.size() < headerEnd + 4 + bodyLen)
+		return; // body still in flight
+
+	const QByteArray body = buf.mid(headerEnd + 4, bodyLen);
+	g_pending.erase(s);
+	handle_request(s, headers, body);
+}
+
+static void accept_pending_connections()
+{
+	while (QTcpSocket *s = g_server->nextPendingConnection()) {
+		QObject::connect(s, &QTcpSocket::readyRead, s, [s]() { on_ready_read(s); });
+		QObject::connect(s, &QTcpSocket::disconnected, s, [s]() { forget_socket(s); });
+	}
+}
+
+// -------------------------
+// CORE -> page
+// -------------------------
+// seq/tsMs: the command behind the change (0 when it was not a tracked command).
+static void push_visibility(const std::vector<std::string> &now, uint64_t seq, int64_t tsMs)
+{
+	const std::unordered_set<std::string> before(g_visible.begin(), g_visible.end());
+	const std::unordered_set<std::string> after(now.begin(), now.end());
+
+	QJsonArray show, hide;
+	for (const auto &id : now) {
+		if (before.find(id) == before.end())
+			show.append(QString::fromStdString(id));
+	}
+	for (const auto &id : g_visible) {
+		if (after.find(id) == after.end())
+			hide.append(QString::fromStdString(id));
+	}
+	g_visible = now;
+
+	if (show.isEmpty() && hide.isEmpty())
+		return;
+
+	QJsonObject o;
+	o["show"] = show;
+	o["hide"] = hide;
+	o["seq"] = (qint64)seq;
+	o["ts"] = (qint64)tsMs;
+	broadcast(sse_frame("visibility", o));
+}
+
+// Delivered on the Qt main thread (delivery_context::QtMain), where the sockets live.
+static void on_core_event(const smart_lt::core_event &ev, void *user)
+{
+	UNUSED_PARAMETER(user);
+	if (!g_server)
+		return;
+
+	if (ev.type == smart_lt::event_type::VisibilityChanged) {
+		push_visibility(*ev.visible_ids, ev.seq, ev.ts_ms);
+		return;
+	}
+
+	// List edits are delivered as lt-patch.json once the rebuild worker has written it; tell the page
+	// to fetch it then. Deleting an on-air item also shrinks the visible set.
+	if (ev.type == smart_lt::event_type::ArtifactsRebuilt) {
+		if (ev.ok)
+			broadcast(sse_frame("patch", QJsonObject()));
+		return;
+	}
+	push_visibility(smart_lt::visible_ids(), 0, 0);
+}
+
+bool init()
+{
+	if (g_server)
+		return true;
+
+	g_server = new QTcpServer();
+	if (!g_server->listen(QHostAddress::LocalHost, 0)) {
+		LOGW("Push channel disabled: listen failed (%s)", g_server->errorString().toUtf8().constData());
+		delete g_server;
+		g_server = nullptr;
+		return false;
+	}
+
+	g_token = random_token();
+	g_visible = smart_lt::visible_ids();
+
+	QObject::connect(g_server, &QTcpServer::newConnection, g_server, []() { accept_pending_connections(); });
+
+	auto *keepAlive = new QTimer(g_server);
+	keepAlive->setInterval(kKeepAliveMs);
+	QObject::connect(keepAlive, &QTimer::timeout, g_server, []() { broadcast(QByteArray(": ping\n\n")); });
+	keepAlive->start();
+
+	smart_lt::listener_options opts;
+	opts.context = smart_lt::delivery_context::QtMain;
+	g_core_listener_token = smart_lt::add_event_listener(on_core_event, nullptr, opts);
+
+	const unsigned port = (unsigned)g_server->serverPort();
+	const std::string base = "http://127.0.0.1:" + std::to_string(port);
+	smart_lt::set_push_endpoint(base + "/events?token=" + g_token, base + "/ack?token=" + g_token);
+
+	LOGI("Push channel listening on 127.0.0.1:%u", port);
+	return true;
+}
+
+void shutdown()
+{
+	if (g_core_listener_token) {
+		smart_lt::remove_event_listener(g_core_listener_token);
+		g_core_listener_token = 0;
+	}
+
+	if (!g_server)
+		return;
+
+	smart_lt::set_push_endpoint(std::string(), std::string());
+
+	// Sockets are children of the server; detach their handlers so teardown does not re-enter.
+	for (auto *s : g_server->findChildren<QTcpSocket *>())
+		s->disconnect();
+	g_streams.clear();
+	g_pending.clear();
+
+	g_server->close();
+	delete g_server;
+	g_server = nullptr;
+}
+
+} // namespace smart_lt::push
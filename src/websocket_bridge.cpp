@@ -2,6 +2,7 @@
 #include "websocket_bridge.hpp"
 
 #include "core.hpp"
+#include "ws_subscriptions.hpp"
 
 // vendored header
 #include "thirdparty/obs-websocket-api.h"
@@ -10,7 +11,11 @@
 #include <obs.h>
 
 #include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace smart_lt::ws {
@@ -18,6 +23,7 @@ namespace smart_lt::ws {
 static obs_websocket_vendor g_vendor = nullptr;
 static const char *kVendorName = "smart-lower-thirds";
 static uint64_t g_core_listener_token = 0;
+static constexpr int kEventCoalesceMs = 25;
 
 // -------------------------
 // Local helpers
@@ -60,116 +66,562 @@ static const char *reason_to_str(smart_lt::list_change_reason r)
 	}
 }
 
+// The session epoch as 16 hex digits: a string, since JSON numbers lose 64-bit precision.
+static const std::string &epoch_text()
+{
+	static const std::string text = []() {
+		char buf[17];
+		snprintf(buf, sizeof(buf), "%016llx", (unsigned long long)smart_lt::state_epoch());
+		return std::string(buf);
+	}();
+	return text;
+}
+
+// Every response or event carrying a "revision" carries the "epoch" it belongs to.
+static void set_revision(obs_data_t *data, uint64_t revision)
+{
+	obs_data_set_int(data, "revision", (long long)revision);
+	obs_data_set_string(data, "epoch", epoch_text().c_str());
+}
+
+// True when the request's "revision" was issued by this session (its "epoch" matches); anything else
+// must be answered as if the client knew nothing.
+static bool request_revision(obs_data_t *request, uint64_t &revision)
+{
+	if (!request || !obs_data_has_user_value(request, "revision"))
+		return false;
+	const char *theirs = obs_data_get_string(request, "epoch");
+	if (!theirs || epoch_text() != theirs)
+		return false;
+	revision = (uint64_t)obs_data_get_int(request, "revision");
+	return true;
+}
+
+// [{ "id": "<lt_id>" }, ...] -- the shape every id list in this API uses.
+static obs_data_array_t *id_array(const std::vector<std::string> &ids)
+{
+	obs_data_array_t *arr = obs_data_array_create();
+	for (const auto &id : ids) {
+		obs_data_t *o = obs_data_create();
+		obs_data_set_string(o, "id", id.c_str());
+		obs_data_array_push_back(arr, o);
+		obs_data_release(o);
+	}
+	return arr;
+}
+
+static void set_id_array(obs_data_t *data, const char *name, const std::vector<std::string> &ids)
+{
+	obs_data_array_t *arr = id_array(ids);
+	obs_data_set_array(data, name, arr);
+	obs_data_array_release(arr);
+}
+
+// Reads an id_array()-shaped list; invalid or empty ids are dropped.
+static std::vector<std::string> get_id_array(obs_data_t *data, const char *name)
+{
+	std::vector<std::string> out;
+	obs_data_array_t *arr = obs_data_get_array(data, name);
+	if (!arr)
+		return out;
+
+	const size_t n = obs_data_array_count(arr);
+	out.reserve(n);
+	for (size_t i = 0; i < n; ++i) {
+		obs_data_t *o = obs_data_array_item(arr, i);
+		const char *idC = obs_data_get_string(o, "id");
+		const std::string sid = sanitize_id_local(idC ? idC : "");
+		if (!sid.empty())
+			out.push_back(sid);
+		obs_data_release(o);
+	}
+	obs_data_array_release(arr);
+	return out;
+}
+
 // -------------------------
 // CORE -> WS vendor events (single source of truth)
 // -------------------------
-static void on_core_event(const smart_lt::core_event &ev, void *user)
+// Runs on the event stream thread (see ws_subscriptions.hpp); every client receives every event.
+static void emit_vendor_event(const smart_lt::core_event &ev, bool compact)
 {
-	UNUSED_PARAMETER(user);
 	if (!g_vendor)
 		return;
 
-	if (ev.type == smart_lt::event_type::VisibilityChanged) {
-		obs_data_t *data = obs_data_create();
-		obs_data_set_string(data, "id", ev.id.c_str());
-		obs_data_set_bool(data, "visible", ev.visible);
+	obs_data_t *data = obs_data_create();
+	set_revision(data, ev.state_version);
 
-		obs_data_array_t *arr = obs_data_array_create();
-		for (const auto &vid : ev.visible_ids) {
-			obs_data_t *o = obs_data_create();
-			obs_data_set_string(o, "id", vid.c_str());
-			obs_data_array_push_back(arr, o);
-			obs_data_release(o);
+	const char *name = nullptr;
+	switch (ev.type) {
+	case smart_lt::event_type::VisibilityChanged:
+		// One event per command; batches carry no "id" and list their changes in shownIds/hiddenIds.
+		name = "LowerThirdsVisibilityChanged";
+		if (!ev.id.empty()) {
+			obs_data_set_string(data, "id", ev.id.c_str());
+			obs_data_set_bool(data, "visible", ev.visible);
 		}
-		obs_data_set_array(data, "visibleIds", arr);
-		obs_data_array_release(arr);
+		obs_data_set_int(data, "seq", (long long)ev.seq);
+		obs_data_set_int(data, "timestampMs", (long long)ev.ts_ms);
 
-		obs_websocket_vendor_emit_event(g_vendor, "LowerThirdsVisibilityChanged", data);
-		obs_data_release(data);
-		return;
-	}
+		if (!compact)
+			set_id_array(data, "visibleIds", *ev.visible_ids);
+		set_id_array(data, "shownIds", ev.shown_ids);
+		set_id_array(data, "hiddenIds", ev.hidden_ids);
+		break;
 
-	if (ev.type == smart_lt::event_type::ListChanged) {
-		obs_data_t *data = obs_data_create();
+	case smart_lt::event_type::ListChanged:
+		name = "LowerThirdsListChanged";
 		obs_data_set_string(data, "reason", reason_to_str(ev.reason));
 		if (!ev.id.empty())
 			obs_data_set_string(data, "id", ev.id.c_str());
 		if (!ev.id2.empty())
 			obs_data_set_string(data, "id2", ev.id2.c_str());
 		obs_data_set_int(data, "count", (long long)ev.count);
+		break;
 
-		obs_websocket_vendor_emit_event(g_vendor, "LowerThirdsListChanged", data);
-		obs_data_release(data);
-		return;
-	}
-
-	if (ev.type == smart_lt::event_type::Reloaded) {
-		obs_data_t *data = obs_data_create();
+	case smart_lt::event_type::Reloaded:
+		name = "LowerThirdsReloaded";
 		obs_data_set_bool(data, "ok", ev.ok);
 		obs_data_set_int(data, "count", (long long)ev.count);
+		break;
 
-		obs_websocket_vendor_emit_event(g_vendor, "LowerThirdsReloaded", data);
-		obs_data_release(data);
-		return;
+	default:
+		break;
 	}
+
+	if (name)
+		obs_websocket_vendor_emit_event(g_vendor, name, data);
+	obs_data_release(data);
+}
+
+static void on_core_event(const smart_lt::core_event &ev, void *user)
+{
+	UNUSED_PARAMETER(user);
+	if (g_vendor)
+		event_stream_dispatch(ev);
 }
 
 // -------------------------
-// Vendor request callbacks
+// Item serialization + ListLowerThirds cache
 // -------------------------
+// A string field, an int field, or (neither) "isVisible".
+struct item_field {
+	const char *name;
+	std::string smart_lt::lower_third_cfg::*str;
+	int smart_lt::lower_third_cfg::*num;
+};
+
+using lt_cfg = smart_lt::lower_third_cfg;
+
+// "id" is always present; these can be projected with the request's "fields".
+static const item_field kItemFields[] = {
+	{"title", &lt_cfg::title, nullptr},
+	{"subtitle", &lt_cfg::subtitle, nullptr},
+	{"isVisible", nullptr, nullptr},
+	{"repeatEverySec", nullptr, &lt_cfg::repeat_every_sec},
+	{"repeatVisibleSec", nullptr, &lt_cfg::repeat_visible_sec},
+	{"hotkey", &lt_cfg::hotkey, nullptr},
+	{"primaryColor", &lt_cfg::primary_color, nullptr},
+	{"secondaryColor", &lt_cfg::secondary_color, nullptr},
+	{"titleColor", &lt_cfg::title_color, nullptr},
+	{"subtitleColor", &lt_cfg::subtitle_color, nullptr},
+	{"order", nullptr, &lt_cfg::order},
+
+	// Legacy fields for older docks
+	{"bgColor", &lt_cfg::primary_color, nullptr},
+	{"textColor", &lt_cfg::title_color, nullptr},
+	{"opacity", nullptr, &lt_cfg::opacity},
+	{"radius", nullptr, &lt_cfg::radius},
+};
+
+static constexpr size_t kItemFieldCount = sizeof(kItemFields) / sizeof(kItemFields[0]);
+static constexpr uint32_t kAllItemFields = (1u << kItemFieldCount) - 1;
+static constexpr uint32_t kIsVisibleField = 1u << 2;
+
+static obs_data_t *item_to_data(const smart_lt::lower_third_cfg &c, bool visible, uint32_t fields = kAllItemFields)
+{
+	obs_data_t *it = obs_data_create();
+	obs_data_set_string(it, "id", c.id.c_str());
+	for (size_t i = 0; i < kItemFieldCount; ++i) {
+		if (!(fields & (1u << i)))
+			continue;
+		const item_field &f = kItemFields[i];
+		if (f.str)
+			obs_data_set_string(it, f.name, (c.*f.str).c_str());
+		else if (f.num)
+			obs_data_set_int(it, f.name, c.*f.num);
+		else
+			obs_data_set_bool(it, f.name, visible);
+	}
+	return it;
+}
+
+// "fields": "id,title,isVisible" -> bit mask; empty or missing means every field.
+static bool parse_item_fields(obs_data_t *request, uint32_t &fields, std::string &unknown)
+{
+	fields = kAllItemFields;
+	const char *spec = request ? obs_data_get_string(request, "fields") : nullptr;
+	if (!spec || !*spec)
+		return true;
+
+	fields = 0;
+	std::string name;
+	for (const char *p = spec;; ++p) {
+		if (*p && *p != ',') {
+			if (*p != ' ')
+				name.push_back(*p);
+			continue;
+		}
+		if (!name.empty() && name != "id") {
+			size_t i = 0;
+			while (i < kItemFieldCount && name != kItemFields[i].name)
+				++i;
+			if (i == kItemFieldCount) {
+				unknown = name;
+				return false;
+			}
+			fields |= 1u << i;
+		}
+		name.clear();
+		if (!*p)
+			return true;
+	}
+}
+
+// Serialized items per projection, kept until the state changes. A newer revision only re-serializes the
+// items the change log names; the rest of the objects are reused as they are. Objects and arrays are
+// never modified once built, so responses on different request threads can share them.
+struct list_cache_entry {
+	uint32_t fields = 0;
+	uint64_t revision = 0; // 0 = not built yet
+	std::unordered_map<std::string, obs_data_t *> objs;
+	obs_data_array_t *items = nullptr; // every item, in list order
+	uint64_t last_used = 0;
+};
+
+static constexpr size_t kListCacheProjections = 8;
+static std::mutex g_list_cache_mx;
+static std::vector<list_cache_entry> g_list_cache;
+static uint64_t g_list_cache_tick = 0;
+
+static void release_list_cache_entry(list_cache_entry &e)
+{
+	for (auto &kv : e.objs)
+		obs_data_release(kv.second);
+	e.objs.clear();
+	if (e.items)
+		obs_data_array_release(e.items);
+	e.items = nullptr;
+	e.revision = 0;
+}
+
+// Caller holds g_list_cache_mx.
+static list_cache_entry &list_cache_for(uint32_t fields)
+{
+	list_cache_entry *lru = nullptr;
+	for (auto &e : g_list_cache) {
+		if (e.fields == fields) {
+			e.last_used = ++g_list_cache_tick;
+			return e;
+		}
+		if (!lru || e.last_used < lru->last_used)
+			lru = &e;
+	}
+
+	if (g_list_cache.size() < kListCacheProjections) {
+		g_list_cache.emplace_back();
+		lru = &g_list_cache.back();
+	} else {
+		release_list_cache_entry(*lru);
+	}
+	lru->fields = fields;
+	lru->last_used = ++g_list_cache_tick;
+	return *lru;
+}
+
+// Brings `e` up to the latest revision; returns the snapshot it now reflects. Caller holds g_list_cache_mx.
+static smart_lt::state_ref refresh_list_cache(list_cache_entry &e)
+{
+	using K = smart_lt::state_change_kind;
+
+	smart_lt::state_ref snap;
+	bool full = e.revision == 0;
+	std::vector<std::string> stale;
+
+	if (full) {
+		snap = smart_lt::snapshot();
+	} else {
+		const smart_lt::state_delta d = smart_lt::changes_since(e.revision);
+		snap = d.state;
+		if (snap->version == e.revision)
+			return snap;
+		full = d.resync;
+		for (const auto &c : d.changes) {
+			if (c.kind == K::GroupUpserted || c.kind == K::GroupRemoved)
+				continue;
+			if (c.kind == K::Visibility && !(e.fields & kIsVisibleField))
+				continue;
+			stale.push_back(c.id);
+		}
+	}
+
+	if (full) {
+		release_list_cache_entry(e);
+	} else {
+		for (const auto &id : stale) {
+			auto it = e.objs.find(id);
+			if (it == e.objs.end())
+				continue;
+			obs_data_release(it->second);
+			e.objs.erase(it);
+		}
+	}
+
+	obs_data_array_t *arr = obs_data_array_create();
+	for (const auto &c : *snap->items) {
+		obs_data_t *&o = e.objs[c.id];
+		if (!o)
+			o = item_to_data(c, snap->is_visible(c.id), e.fields);
+		obs_data_array_push_back(arr, o);
+	}
+	if (e.items)
+		obs_data_array_release(e.items);
+	e.items = arr;
+	e.revision = snap->version;
+	return snap;
+}
+
+static void clear_list_cache()
+{
+	std::lock_guard<std::mutex> lk(g_list_cache_mx);
+	for (auto &e : g_list_cache)
+		release_list_cache_entry(e);
+	g_list_cache.clear();
+}
+
+// Request (all optional):
+// - "revision" + "epoch": when both match the current ones only { ok, notModified, revision, epoch } is
+//   returned
+// - "fields": comma-separated projection, e.g. "id,title,isVisible" ("id" is always included)
+// - "offset" / "limit": page of the list (limit 0 = to the end); "total" is the full item count
 static void req_ListLowerThirds(obs_data_t *request, obs_data_t *response, void *priv)
 {
-	UNUSED_PARAMETER(request);
 	UNUSED_PARAMETER(priv);
 
-	obs_data_array_t *items = obs_data_array_create();
+	uint64_t known = 0;
+	if (request_revision(request, known)) {
+		const smart_lt::state_ref snap = smart_lt::snapshot();
+		if (known == snap->version) {
+			set_ok(response, true);
+			obs_data_set_bool(response, "notModified", true);
+			set_revision(response, snap->version);
+			return;
+		}
+	}
 
-	for (const auto &c : smart_lt::all_const()) {
-		obs_data_t *it = obs_data_create();
-		obs_data_set_string(it, "id", c.id.c_str());
-		obs_data_set_string(it, "title", c.title.c_str());
-		obs_data_set_string(it, "subtitle", c.subtitle.c_str());
-		obs_data_set_bool(it, "isVisible", smart_lt::is_visible(c.id));
-		obs_data_set_int(it, "repeatEverySec", c.repeat_every_sec);
-		obs_data_set_int(it, "repeatVisibleSec", c.repeat_visible_sec);
-		obs_data_set_string(it, "hotkey", c.hotkey.c_str());
-
-		obs_data_set_string(it, "primaryColor", c.primary_color.c_str());
-		obs_data_set_string(it, "secondaryColor", c.secondary_color.c_str());
-		obs_data_set_string(it, "titleColor", c.title_color.c_str());
-		obs_data_set_string(it, "subtitleColor", c.subtitle_color.c_str());
-
-		// Legacy fields for older docks
-		obs_data_set_string(it, "bgColor", c.primary_color.c_str());
-		obs_data_set_string(it, "textColor", c.title_color.c_str());
-		obs_data_set_int(it, "opacity", c.opacity);
-		obs_data_set_int(it, "radius", c.radius);
+	uint32_t fields = 0;
+	std::string unknown;
+	if (!parse_item_fields(request, fields, unknown)) {
+		set_error(response, ("Unknown field: " + unknown).c_str());
+		return;
+	}
 
-		obs_data_array_push_back(items, it);
-		obs_data_release(it);
+	const long long offsetIn = request ? obs_data_get_int(request, "offset") : 0;
+	const long long limitIn = request ? obs_data_get_int(request, "limit") : 0;
+	if (offsetIn < 0 || limitIn < 0) {
+		set_error(response, "Invalid offset/limit");
+		return;
+	}
+
+	std::lock_guard<std::mutex> lk(g_list_cache_mx);
+	list_cache_entry &e = list_cache_for(fields);
+	const smart_lt::state_ref snap = refresh_list_cache(e);
+
+	const size_t total = obs_data_array_count(e.items);
+	const size_t offset = std::min((size_t)offsetIn, total);
+	const size_t end = limitIn == 0 ? total : std::min(total, offset + (size_t)limitIn);
+
+	set_ok(response, true);
+	set_revision(response, snap->version);
+	obs_data_set_int(response, "total", (long long)total);
+	obs_data_set_int(response, "offset", (long long)offset);
+
+	if (offset == 0 && end == total) {
+		obs_data_set_array(response, "items", e.items);
+		return;
+	}
+
+	obs_data_array_t *page = obs_data_array_create();
+	for (size_t i = offset; i < end; ++i) {
+		obs_data_t *o = obs_data_array_item(e.items, i);
+		obs_data_array_push_back(page, o);
+		obs_data_release(o);
+	}
+	obs_data_set_array(response, "items", page);
+	obs_data_array_release(page);
+}
+
+// Request: { "revision": <n>, "epoch": "<e>" } as returned by ListLowerThirds / GetChangesSince / any event.
+// Response: "revision" and "epoch" (current), then either "resync": true (another session issued that
+// revision, or the change log no longer reaches back that far: call ListLowerThirds) or the net
+// difference: "items" (created/updated, full objects), "removedIds", "visibleIds" (only when visibility
+// changed) and "groupsChanged".
+static void req_GetChangesSince(obs_data_t *request, obs_data_t *response, void *priv)
+{
+	UNUSED_PARAMETER(priv);
+
+	if (!obs_data_has_user_value(request, "revision")) {
+		set_error(response, "Missing revision");
+		return;
 	}
 
+	uint64_t known = 0;
+	const bool sameSession = request_revision(request, known);
+	const smart_lt::state_delta d = smart_lt::changes_since(known);
+	const smart_lt::state_snapshot &snap = *d.state;
+
 	set_ok(response, true);
+	set_revision(response, snap.version);
+	if (!sameSession || d.resync) {
+		obs_data_set_bool(response, "resync", true);
+		return;
+	}
+
+	// Net effect per id: the log may mention an item several times; the snapshot has its final state.
+	std::vector<std::string> touched;
+	bool visibilityChanged = false;
+	bool groupsChanged = false;
+	for (const auto &c : d.changes) {
+		using K = smart_lt::state_change_kind;
+		if (c.kind == K::Visibility)
+			visibilityChanged = true;
+		else if (c.kind == K::GroupUpserted || c.kind == K::GroupRemoved)
+			groupsChanged = true;
+		else if (std::find(touched.begin(), touched.end(), c.id) == touched.end())
+			touched.push_back(c.id);
+	}
+
+	obs_data_array_t *items = obs_data_array_create();
+	std::vector<std::string> removed;
+	for (const auto &id : touched) {
+		const smart_lt::lower_third_cfg *c = snap.find(id);
+		if (!c) {
+			removed.push_back(id);
+			continue;
+		}
+		obs_data_t *it = item_to_data(*c, snap.is_visible(id));
+		obs_data_array_push_back(items, it);
+		obs_data_release(it);
+	}
 	obs_data_set_array(response, "items", items);
 	obs_data_array_release(items);
+
+	set_id_array(response, "removedIds", removed);
+	if (visibilityChanged)
+		set_id_array(response, "visibleIds", *snap.visible);
+	obs_data_set_bool(response, "groupsChanged", groupsChanged);
 }
 
-static void req_GetVisible(obs_data_t *request, obs_data_t *response, void *priv)
+// -------------------------
+// Event options
+// -------------------------
+// Server-wide options of the event stream, read and written by GetEventOptions / SetEventOptions
+// (all optional on Set; missing ones reset to their default):
+// - "events": comma-separated subset of "visibility,list,reload" ("none" = nothing; missing = all)
+// - "ids" / "groupIds": id_array()-shaped filters (both empty = every item)
+// - "maxRate": max visibility events per second, trailing-edge merged (0 = unlimited)
+// - "compact": visibility events without the full visibleIds list
+static bool read_event_options(obs_data_t *request, event_options &o, std::string &error)
+{
+	const char *events = obs_data_get_string(request, "events");
+	if (events && *events) {
+		o.visibility = o.list = o.reload = false;
+		std::string name;
+		for (const char *p = events;; ++p) {
+			if (*p && *p != ',') {
+				if (*p != ' ')
+					name.push_back(*p);
+				continue;
+			}
+			if (name == "visibility")
+				o.visibility = true;
+			else if (name == "list")
+				o.list = true;
+			else if (name == "reload")
+				o.reload = true;
+			else if (!name.empty() && name != "none") {
+				error = "Unknown event type: " + name;
+				return false;
+			}
+			name.clear();
+			if (!*p)
+				break;
+		}
+	}
+
+	o.ids = get_id_array(request, "ids");
+	o.group_ids = get_id_array(request, "groupIds");
+	o.compact = obs_data_get_bool(request, "compact");
+
+	const long long rate = obs_data_get_int(request, "maxRate");
+	if (rate < 0 || rate > 1000) {
+		error = "maxRate must be 0..1000";
+		return false;
+	}
+	o.max_rate = (int)rate;
+	return true;
+}
+
+static void write_event_options(obs_data_t *response, const event_options &o)
+{
+	std::string events;
+	for (const auto &[on, name] : {std::pair<bool, const char *>{o.visibility, "visibility"},
+				       {o.list, "list"}, {o.reload, "reload"}}) {
+		if (!on)
+			continue;
+		if (!events.empty())
+			events += ",";
+		events += name;
+	}
+	obs_data_set_string(response, "events", events.empty() ? "none" : events.c_str());
+	set_id_array(response, "ids", o.ids);
+	set_id_array(response, "groupIds", o.group_ids);
+	obs_data_set_int(response, "maxRate", o.max_rate);
+	obs_data_set_bool(response, "compact", o.compact);
+}
+
+static void req_GetEventOptions(obs_data_t *request, obs_data_t *response, void *priv)
 {
 	UNUSED_PARAMETER(request);
 	UNUSED_PARAMETER(priv);
 
-	obs_data_array_t *arr = obs_data_array_create();
-	for (const auto &id : smart_lt::visible_ids()) {
-		obs_data_t *o = obs_data_create();
-		obs_data_set_string(o, "id", id.c_str());
-		obs_data_array_push_back(arr, o);
-		obs_data_release(o);
+	set_ok(response, true);
+	write_event_options(response, current_event_options());
+}
+
+static void req_SetEventOptions(obs_data_t *request, obs_data_t *response, void *priv)
+{
+	UNUSED_PARAMETER(priv);
+
+	event_options o;
+	std::string error;
+	if (!read_event_options(request, o, error)) {
+		set_error(response, error.c_str());
+		return;
 	}
 
+	set_event_options(o);
 	set_ok(response, true);
-	obs_data_set_array(response, "visibleIds", arr);
-	obs_data_array_release(arr);
+	write_event_options(response, o);
+}
+
+static void req_GetVisible(obs_data_t *request, obs_data_t *response, void *priv)
+{
+	UNUSED_PARAMETER(request);
+	UNUSED_PARAMETER(priv);
+
+	set_ok(response, true);
+	set_id_array(response, "visibleIds", *smart_lt::snapshot()->visible);
 }
 
 static void req_SetVisible(obs_data_t *request, obs_data_t *response, void *priv)
@@ -180,7 +632,7 @@ static void req_SetVisible(obs_data_t *request, obs_data_t *response, void *priv
 	const bool visible = obs_data_get_bool(request, "visible");
 
 	std::string sid = sanitize_id_local(idC ? idC : "");
-	if (sid.empty() || !smart_lt::get_by_id(sid)) {
+	if (sid.empty() || !smart_lt::snapshot()->find(sid)) {
 		set_error(response, "Invalid id");
 		return;
 	}
@@ -192,7 +644,7 @@ static void req_SetVisible(obs_data_t *request, obs_data_t *response, void *priv
 
 	set_ok(response, true);
 	obs_data_set_string(response, "id", sid.c_str());
-	obs_data_set_bool(response, "visible", smart_lt::is_visible(sid));
+	obs_data_set_bool(response, "visible", smart_lt::snapshot()->is_visible(sid));
 }
 
 static void req_ToggleVisible(obs_data_t *request, obs_data_t *response, void *priv)
@@ -202,7 +654,7 @@ static void req_ToggleVisible(obs_data_t *request, obs_data_t *response, void *p
 	const char *idC = obs_data_get_string(request, "id");
 	std::string sid = sanitize_id_local(idC ? idC : "");
 
-	if (sid.empty() || !smart_lt::get_by_id(sid)) {
+	if (sid.empty() || !smart_lt::snapshot()->find(sid)) {
 		set_error(response, "Invalid id");
 		return;
 	}
@@ -214,7 +666,117 @@ static void req_ToggleVisible(obs_data_t *request, obs_data_t *response, void *p
 
 	set_ok(response, true);
 	obs_data_set_string(response, "id", sid.c_str());
-	obs_data_set_bool(response, "visible", smart_lt::is_visible(sid));
+	obs_data_set_bool(response, "visible", smart_lt::snapshot()->is_visible(sid));
+}
+
+// Request: "changes": [{ "id", "visible" }, ...] applied in order, and/or "show"/"hide" id lists
+// (hides first). All ids must exist; the batch is written and announced once.
+static void req_SetVisibleBatch(obs_data_t *request, obs_data_t *response, void *priv)
+{
+	UNUSED_PARAMETER(priv);
+
+	std::vector<smart_lt::visibility_change> changes;
+	for (const auto &id : get_id_array(request, "hide"))
+		changes.push_back(smart_lt::visibility_change{id, false});
+	for (const auto &id : get_id_array(request, "show"))
+		changes.push_back(smart_lt::visibility_change{id, true});
+
+	if (obs_data_array_t *arr = obs_data_get_array(request, "changes")) {
+		const size_t n = obs_data_array_count(arr);
+		for (size_t i = 0; i < n; ++i) {
+			obs_data_t *o = obs_data_array_item(arr, i);
+			const char *idC = obs_data_get_string(o, "id");
+			smart_lt::visibility_change c;
+			c.id = sanitize_id_local(idC ? idC : "");
+			c.visible = obs_data_get_bool(o, "visible");
+			changes.push_back(std::move(c));
+			obs_data_release(o);
+		}
+		obs_data_array_release(arr);
+	}
+
+	std::string err;
+	if (!smart_lt::set_visible_batch(changes, &err)) {
+		set_error(response, err.empty() ? "Failed to set visibility" : err.c_str());
+		return;
+	}
+
+	set_ok(response, true);
+	set_id_array(response, "visibleIds", *smart_lt::snapshot()->visible);
+}
+
+static void req_ListVisibilityPresets(obs_data_t *request, obs_data_t *response, void *priv)
+{
+	UNUSED_PARAMETER(request);
+	UNUSED_PARAMETER(priv);
+
+	obs_data_array_t *presets = obs_data_array_create();
+	for (const auto &p : smart_lt::visibility_presets()) {
+		obs_data_t *o = obs_data_create();
+		obs_data_set_string(o, "name", p.name.c_str());
+		set_id_array(o, "visibleIds", p.ids);
+		obs_data_array_push_back(presets, o);
+		obs_data_release(o);
+	}
+
+	set_ok(response, true);
+	obs_data_set_array(response, "presets", presets);
+	obs_data_array_release(presets);
+}
+
+// Request: "name", optional "ids" (defaults to the current visible set).
+static void req_SaveVisibilityPreset(obs_data_t *request, obs_data_t *response, void *priv)
+{
+	UNUSED_PARAMETER(priv);
+
+	const char *nameC = obs_data_get_string(request, "name");
+	const std::string name = nameC ? nameC : "";
+	if (name.empty()) {
+		set_error(response, "Missing name");
+		return;
+	}
+
+	bool ok;
+	if (obs_data_has_user_value(request, "ids")) {
+		const auto ids = get_id_array(request, "ids");
+		ok = smart_lt::save_visibility_preset(name, &ids);
+	} else {
+		ok = smart_lt::save_visibility_preset(name);
+	}
+	if (!ok) {
+		set_error(response, "Failed to save preset (several ids of one exclusive group?)");
+		return;
+	}
+
+	set_ok(response, true);
+	obs_data_set_string(response, "name", name.c_str());
+}
+
+static void req_RecallVisibilityPreset(obs_data_t *request, obs_data_t *response, void *priv)
+{
+	UNUSED_PARAMETER(priv);
+
+	const char *nameC = obs_data_get_string(request, "name");
+	if (!smart_lt::recall_visibility_preset(nameC ? nameC : "")) {
+		set_error(response, "Unknown preset, or it conflicts with an exclusive group");
+		return;
+	}
+
+	set_ok(response, true);
+	set_id_array(response, "visibleIds", *smart_lt::snapshot()->visible);
+}
+
+static void req_DeleteVisibilityPreset(obs_data_t *request, obs_data_t *response, void *priv)
+{
+	UNUSED_PARAMETER(priv);
+
+	const char *nameC = obs_data_get_string(request, "name");
+	if (!smart_lt::delete_visibility_preset(nameC ? nameC : "")) {
+		set_error(response, "Unknown preset");
+		return;
+	}
+
+	set_ok(response, true);
 }
 
 static void req_CreateLowerThird(obs_data_t *request, obs_data_t *response, void *priv)
@@ -235,7 +797,123 @@ static void req_CreateLowerThird(obs_data_t *request, obs_data_t *response, void
 
 	set_ok(response, true);
 	obs_data_set_string(response, "id", id.c_str());
-	obs_data_set_int(response, "count", (long long)smart_lt::all_const().size());
+	obs_data_set_int(response, "count", (long long)smart_lt::snapshot()->items->size());
+}
+
+// -------------------------
+// Batch create / update
+// -------------------------
+using lt_fields = smart_lt::lower_third_fields;
+
+static const struct {
+	const char *name;
+	std::optional<std::string> lt_fields::*str;
+	std::optional<int> lt_fields::*num;
+} kWritableFields[] = {
+	{"label", &lt_fields::label, nullptr},
+	{"title", &lt_fields::title, nullptr},
+	{"subtitle", &lt_fields::subtitle, nullptr},
+	{"profilePicture", &lt_fields::profile_picture, nullptr}, // name of a file already in the output folder
+	{"animIn", &lt_fields::anim_in, nullptr},
+	{"animOut", &lt_fields::anim_out, nullptr},
+	{"fontFamily", &lt_fields::font_family, nullptr},
+	{"position", &lt_fields::lt_position, nullptr},
+	{"primaryColor", &lt_fields::primary_color, nullptr},
+	{"secondaryColor", &lt_fields::secondary_color, nullptr},
+	{"titleColor", &lt_fields::title_color, nullptr},
+	{"subtitleColor", &lt_fields::subtitle_color, nullptr},
+	{"hotkey", &lt_fields::hotkey, nullptr},
+	{"titleSize", nullptr, &lt_fields::title_size},
+	{"subtitleSize", nullptr, &lt_fields::subtitle_size},
+	{"avatarWidth", nullptr, &lt_fields::avatar_width},
+	{"avatarHeight", nullptr, &lt_fields::avatar_height},
+	{"opacity", nullptr, &lt_fields::opacity},
+	{"radius", nullptr, &lt_fields::radius},
+	{"repeatEverySec", nullptr, &lt_fields::repeat_every_sec},
+	{"repeatVisibleSec", nullptr, &lt_fields::repeat_visible_sec},
+};
+
+// "items": [{ <field>: value, ... }] -- only the keys present are applied.
+static bool read_field_sets(obs_data_t *request, bool withId, std::vector<lt_fields> &out, std::string &error)
+{
+	obs_data_array_t *arr = obs_data_get_array(request, "items");
+	if (!arr || obs_data_array_count(arr) == 0) {
+		if (arr)
+			obs_data_array_release(arr);
+		error = "Missing items";
+		return false;
+	}
+
+	const size_t n = obs_data_array_count(arr);
+	out.reserve(n);
+	for (size_t i = 0; i < n && error.empty(); ++i) {
+		obs_data_t *o = obs_data_array_item(arr, i);
+		lt_fields f;
+		if (withId) {
+			const char *idC = obs_data_get_string(o, "id");
+			f.id = sanitize_id_local(idC ? idC : "");
+			if (f.id.empty())
+				error = "Missing id in items[" + std::to_string(i) + "]";
+		}
+		for (const auto &w : kWritableFields) {
+			if (!obs_data_has_user_value(o, w.name))
+				continue;
+			if (w.str) {
+				const char *v = obs_data_get_string(o, w.name);
+				f.*w.str = std::string(v ? v : "");
+			} else {
+				f.*w.num = (int)obs_data_get_int(o, w.name);
+			}
+		}
+		out.push_back(std::move(f));
+		obs_data_release(o);
+	}
+	obs_data_array_release(arr);
+	return error.empty();
+}
+
+// Request: "items": [{ "title", "subtitle", ... }]. One rebuild for the whole batch; items start hidden.
+static void req_CreateLowerThirdsBatch(obs_data_t *request, obs_data_t *response, void *priv)
+{
+	UNUSED_PARAMETER(priv);
+
+	std::vector<lt_fields> items;
+	std::string error;
+	if (!read_field_sets(request, false, items, error)) {
+		set_error(response, error.c_str());
+		return;
+	}
+
+	const std::vector<std::string> ids = smart_lt::create_lower_thirds(items, &error);
+	if (ids.empty()) {
+		set_error(response, error.empty() ? "Failed to create lower thirds" : error.c_str());
+		return;
+	}
+
+	set_ok(response, true);
+	set_id_array(response, "ids", ids);
+	obs_data_set_int(response, "count", (long long)smart_lt::snapshot()->items->size());
+}
+
+// Request: "items": [{ "id", <fields to change>... }]. All ids must exist; one rebuild for the batch.
+static void req_UpdateLowerThirdsBatch(obs_data_t *request, obs_data_t *response, void *priv)
+{
+	UNUSED_PARAMETER(priv);
+
+	std::vector<lt_fields> items;
+	std::string error;
+	if (!read_field_sets(request, true, items, error)) {
+		set_error(response, error.c_str());
+		return;
+	}
+
+	if (!smart_lt::update_lower_thirds(items, &error)) {
+		set_error(response, error.empty() ? "Failed to update lower thirds" : error.c_str());
+		return;
+	}
+
+	set_ok(response, true);
+	obs_data_set_int(response, "updated", (long long)items.size());
 }
 
 static void req_CloneLowerThird(obs_data_t *request, obs_data_t *response, void *priv)
@@ -245,7 +923,7 @@ static void req_CloneLowerThird(obs_data_t *request, obs_data_t *response, void
 	const char *idC = obs_data_get_string(request, "id");
 	std::string sid = sanitize_id_local(idC ? idC : "");
 
-	if (sid.empty() || !smart_lt::get_by_id(sid)) {
+	if (sid.empty() || !smart_lt::snapshot()->find(sid)) {
 		set_error(response, "Invalid id");
 		return;
 	}
@@ -264,7 +942,7 @@ static void req_CloneLowerThird(obs_data_t *request, obs_data_t *response, void
 	set_ok(response, true);
 	obs_data_set_string(response, "id", sid.c_str());
 	obs_data_set_string(response, "newId", newId.c_str());
-	obs_data_set_int(response, "count", (long long)smart_lt::all_const().size());
+	obs_data_set_int(response, "count", (long long)smart_lt::snapshot()->items->size());
 }
 
 static void req_DeleteLowerThird(obs_data_t *request, obs_data_t *response, void *priv)
@@ -274,7 +952,7 @@ static void req_DeleteLowerThird(obs_data_t *request, obs_data_t *response, void
 	const char *idC = obs_data_get_string(request, "id");
 	std::string sid = sanitize_id_local(idC ? idC : "");
 
-	if (sid.empty() || !smart_lt::get_by_id(sid)) {
+	if (sid.empty() || !smart_lt::snapshot()->find(sid)) {
 		set_error(response, "Invalid id");
 		return;
 	}
@@ -288,7 +966,80 @@ static void req_DeleteLowerThird(obs_data_t *request, obs_data_t *response, void
 	set_ok(response, true);
 	obs_data_set_string(response, "id", sid.c_str());
 	obs_data_set_bool(response, "removed", true);
-	obs_data_set_int(response, "count", (long long)smart_lt::all_const().size());
+	obs_data_set_int(response, "count", (long long)smart_lt::snapshot()->items->size());
+}
+
+static obs_data_t *histogram_to_data(const smart_lt::latency_histogram &h)
+{
+	obs_data_t *o = obs_data_create();
+	obs_data_set_int(o, "count", (long long)h.count);
+	obs_data_set_double(o, "avgMs", h.count ? h.sum_ms / (double)h.count : 0.0);
+	obs_data_set_double(o, "maxMs", h.max_ms);
+	obs_data_set_double(o, "p50Ms", h.quantile_ms(0.50));
+	obs_data_set_double(o, "p95Ms", h.quantile_ms(0.95));
+	obs_data_set_double(o, "p99Ms", h.quantile_ms(0.99));
+
+	obs_data_array_t *buckets = obs_data_array_create();
+	for (size_t i = 0; i < smart_lt::latency_histogram::bucket_count; ++i) {
+		obs_data_t *b = obs_data_create();
+		obs_data_set_int(b, "ltMs", (long long)(2ULL << i));
+		obs_data_set_int(b, "count", (long long)h.buckets[i]);
+		obs_data_array_push_back(buckets, b);
+		obs_data_release(b);
+	}
+	obs_data_set_array(o, "buckets", buckets);
+	obs_data_array_release(buckets);
+	return o;
+}
+
+// Optional request fields: "id" (only that item), "reset" (clear all histograms after reading).
+static void req_GetVisibilityLatency(obs_data_t *request, obs_data_t *response, void *priv)
+{
+	UNUSED_PARAMETER(priv);
+
+	const char *idC = obs_data_get_string(request, "id");
+	const std::string sid = sanitize_id_local(idC ? idC : "");
+	const bool reset = obs_data_get_bool(request, "reset");
+
+	smart_lt::latency_histogram allMount, allEnd;
+	obs_data_array_t *items = obs_data_array_create();
+
+	for (const auto &lat : smart_lt::visibility_latency_stats()) {
+		if (!sid.empty() && lat.id != sid)
+			continue;
+
+		obs_data_t *it = obs_data_create();
+		obs_data_set_string(it, "id", lat.id.c_str());
+
+		obs_data_t *mount = histogram_to_data(lat.to_mount);
+		obs_data_set_obj(it, "commandToMount", mount);
+		obs_data_release(mount);
+
+		obs_data_t *end = histogram_to_data(lat.to_animation_end);
+		obs_data_set_obj(it, "commandToAnimationEnd", end);
+		obs_data_release(end);
+
+		obs_data_array_push_back(items, it);
+		obs_data_release(it);
+
+		allMount.merge(lat.to_mount);
+		allEnd.merge(lat.to_animation_end);
+	}
+
+	if (reset)
+		smart_lt::reset_visibility_latency_stats();
+
+	set_ok(response, true);
+	obs_data_set_array(response, "items", items);
+	obs_data_array_release(items);
+
+	obs_data_t *mount = histogram_to_data(allMount);
+	obs_data_set_obj(response, "commandToMount", mount);
+	obs_data_release(mount);
+
+	obs_data_t *end = histogram_to_data(allEnd);
+	obs_data_set_obj(response, "commandToAnimationEnd", end);
+	obs_data_release(end);
 }
 
 static void req_ReloadFromDisk(obs_data_t *request, obs_data_t *response, void *priv)
@@ -305,7 +1056,24 @@ static void req_ReloadFromDisk(obs_data_t *request, obs_data_t *response, void *
 
 	set_ok(response, ok);
 	obs_data_set_bool(response, "reloaded", ok);
-	obs_data_set_int(response, "count", (long long)smart_lt::all_const().size());
+	obs_data_set_int(response, "count", (long long)smart_lt::snapshot()->items->size());
+}
+
+// Swaps the overlay back to the previous bundle generation. Only queues the swap; it happens on the
+// rebuild worker's next turn.
+static void req_RollbackOverlay(obs_data_t *request, obs_data_t *response, void *priv)
+{
+	UNUSED_PARAMETER(request);
+	UNUSED_PARAMETER(priv);
+
+	if (!smart_lt::has_output_dir()) {
+		set_error(response, "No output dir configured");
+		return;
+	}
+
+	const bool ok = smart_lt::rollback_bundle();
+	set_ok(response, ok);
+	obs_data_set_bool(response, "queued", ok);
 }
 
 // -------------------------
@@ -333,17 +1101,44 @@ bool init()
 	bool ok = true;
 
 	ok = ok && obs_websocket_vendor_register_request(g_vendor, "ListLowerThirds", req_ListLowerThirds, nullptr);
+	ok = ok && obs_websocket_vendor_register_request(g_vendor, "GetChangesSince", req_GetChangesSince, nullptr);
 	ok = ok && obs_websocket_vendor_register_request(g_vendor, "GetVisible", req_GetVisible, nullptr);
 	ok = ok && obs_websocket_vendor_register_request(g_vendor, "SetVisible", req_SetVisible, nullptr);
 	ok = ok && obs_websocket_vendor_register_request(g_vendor, "ToggleVisible", req_ToggleVisible, nullptr);
+	ok = ok && obs_websocket_vendor_register_request(g_vendor, "SetVisibleBatch", req_SetVisibleBatch, nullptr);
+	ok = ok && obs_websocket_vendor_register_request(g_vendor, "ListVisibilityPresets", req_ListVisibilityPresets,
+							 nullptr);
+	ok = ok && obs_websocket_vendor_register_request(g_vendor, "SaveVisibilityPreset", req_SaveVisibilityPreset,
+							 nullptr);
+	ok = ok && obs_websocket_vendor_register_request(g_vendor, "RecallVisibilityPreset",
+							 req_RecallVisibilityPreset, nullptr);
+	ok = ok && obs_websocket_vendor_register_request(g_vendor, "DeleteVisibilityPreset",
+							 req_DeleteVisibilityPreset, nullptr);
+	ok = ok && obs_websocket_vendor_register_request(g_vendor, "GetVisibilityLatency", req_GetVisibilityLatency,
+							 nullptr);
 
 	ok = ok && obs_websocket_vendor_register_request(g_vendor, "CreateLowerThird", req_CreateLowerThird, nullptr);
+	ok = ok && obs_websocket_vendor_register_request(g_vendor, "CreateLowerThirdsBatch",
+							 req_CreateLowerThirdsBatch, nullptr);
+	ok = ok && obs_websocket_vendor_register_request(g_vendor, "UpdateLowerThirdsBatch",
+							 req_UpdateLowerThirdsBatch, nullptr);
 	ok = ok && obs_websocket_vendor_register_request(g_vendor, "CloneLowerThird", req_CloneLowerThird, nullptr);
 	ok = ok && obs_websocket_vendor_register_request(g_vendor, "DeleteLowerThird", req_DeleteLowerThird, nullptr);
 	ok = ok && obs_websocket_vendor_register_request(g_vendor, "ReloadFromDisk", req_ReloadFromDisk, nullptr);
+	ok = ok && obs_websocket_vendor_register_request(g_vendor, "RollbackOverlay", req_RollbackOverlay, nullptr);
+
+	ok = ok && obs_websocket_vendor_register_request(g_vendor, "GetEventOptions", req_GetEventOptions, nullptr);
+	ok = ok && obs_websocket_vendor_register_request(g_vendor, "SetEventOptions", req_SetEventOptions, nullptr);
 
 	// Subscribe to core events AFTER vendor is ready
-	g_core_listener_token = smart_lt::add_event_listener(on_core_event, nullptr);
+	// Vendor events go out from our own worker so a busy websocket never stalls the thread that made
+	// the change. Group runs and batches produce bursts; clients get one merged visibility delta per window.
+	event_stream_init(emit_vendor_event);
+
+	smart_lt::listener_options opts;
+	opts.context = smart_lt::delivery_context::Worker;
+	opts.coalesce_ms = kEventCoalesceMs;
+	g_core_listener_token = smart_lt::add_event_listener(on_core_event, nullptr, opts);
 
 	blog(LOG_INFO, LOG_TAG " vendor '%s' registered (api v%u) ok=%s", kVendorName, apiVer, ok ? "true" : "false");
 	return ok;
@@ -355,6 +1150,8 @@ void shutdown()
 		smart_lt::remove_event_listener(g_core_listener_token);
 		g_core_listener_token = 0;
 	}
+	event_stream_shutdown();
+	clear_list_cache();
 	g_vendor = nullptr;
 }
 
@@ -0,0 +1,239 @@
+// ws_subscriptions.cpp
+#define LOG_TAG "[" PLUGIN_NAME "][ws]"
+#include "ws_subscriptions.hpp"
+
+#include "event_bus.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+namespace smart_lt::ws {
+
+using stream_clock = std::chrono::steady_clock;
+
+struct outgoing_event {
+	core_event ev;
+	bool compact = false;
+};
+
+static std::mutex g_stream_mx;
+static std::condition_variable g_stream_cv;
+static event_options g_opts;
+static std::chrono::milliseconds g_interval{0};  // from max_rate
+static stream_clock::time_point g_next_allowed; // earliest time the next visibility event may go out
+static bool g_has_pending = false;
+static core_event g_pending; // merged visibility delta waiting for the trailing edge
+static std::deque<outgoing_event> g_outgoing;
+static event_emit_fn g_emit = nullptr;
+static std::thread g_stream_thread;
+static bool g_stream_stop = false;
+
+static std::chrono::milliseconds interval_for(int maxRate)
+{
+	return std::chrono::milliseconds(maxRate > 0 ? std::max(1, 1000 / maxRate) : 0);
+}
+
+// -------------------------
+// Filtering
+// -------------------------
+// Item ids the stream is limited to (its ids plus current members of its groups); empty = all.
+static std::unordered_set<std::string> scope_of(const event_options &o, const state_snapshot &snap)
+{
+	std::unordered_set<std::string> scope(o.ids.begin(), o.ids.end());
+	for (const auto &gid : o.group_ids) {
+		for (const auto &g : *snap.groups) {
+			if (g.id == gid)
+				scope.insert(g.members.begin(), g.members.end());
+		}
+	}
+	return scope;
+}
+
+static void keep_in_scope(std::vector<std::string> &ids, const std::unordered_set<std::string> &scope)
+{
+	ids.erase(std::remove_if(ids.begin(), ids.end(), [&](const std::string &id) { return !scope.count(id); }),
+		  ids.end());
+}
+
+// Fills `out` with what passes `o` of `ev`; false when nothing.
+static bool filter_event(const event_options &o, const core_event &ev, const state_snapshot &snap,
+			 core_event &out)
+{
+	const bool scoped = !o.ids.empty() || !o.group_ids.empty();
+
+	switch (ev.type) {
+	case event_type::VisibilityChanged: {
+		if (!o.visibility)
+			return false;
+		out = ev;
+		if (!scoped)
+			return true;
+
+		const auto scope = scope_of(o, snap);
+		keep_in_scope(out.shown_ids, scope);
+		keep_in_scope(out.hidden_ids, scope);
+		if (!out.id.empty() && !scope.count(out.id)) {
+			out.id.clear();
+			out.visible = false;
+		}
+		return !out.shown_ids.empty() || !out.hidden_ids.empty();
+	}
+
+	case event_type::ListChanged: {
+		if (!o.list)
+			return false;
+		out = ev;
+		if (!scoped || ev.reason == list_change_reason::Reload || (ev.id.empty() && ev.id2.empty()))
+			return true;
+
+		const auto scope = scope_of(o, snap);
+		auto hit = [&](const std::string &id) {
+			return !id.empty() && (scope.count(id) || std::find(o.group_ids.begin(), o.group_ids.end(), id) !=
+									  o.group_ids.end());
+		};
+		return hit(ev.id) || hit(ev.id2);
+	}
+
+	case event_type::Reloaded:
+		if (!o.reload)
+			return false;
+		out = ev;
+		return true;
+
+	default:
+		break;
+	}
+	return false;
+}
+
+// -------------------------
+// Emission thread
+// -------------------------
+// Caller holds g_stream_mx.
+static void flush_pending(stream_clock::time_point now)
+{
+	if (!g_has_pending)
+		return;
+	g_has_pending = false;
+	if (g_pending.shown_ids.empty() && g_pending.hidden_ids.empty())
+		return; // the merged changes cancelled out
+	g_outgoing.push_back(outgoing_event{std::move(g_pending), g_opts.compact});
+	g_pending = core_event();
+	g_next_allowed = now + g_interval;
+}
+
+static void stream_thread_main()
+{
+	std::deque<outgoing_event> batch;
+
+	std::unique_lock<std::mutex> lk(g_stream_mx);
+	while (true) {
+		const auto now = stream_clock::now();
+		if (g_has_pending && (g_next_allowed <= now || g_stream_stop))
+			flush_pending(now);
+
+		if (!g_outgoing.empty()) {
+			batch.swap(g_outgoing);
+			const event_emit_fn emit = g_emit;
+			lk.unlock();
+			for (const auto &o : batch)
+				if (emit)
+					emit(o.ev, o.compact);
+			batch.clear();
+			lk.lock();
+			continue;
+		}
+
+		if (g_stream_stop)
+			return;
+
+		if (g_has_pending)
+			g_stream_cv.wait_until(lk, g_next_allowed);
+		else
+			g_stream_cv.wait(lk);
+	}
+}
+
+// -------------------------
+// Public API
+// -------------------------
+void event_stream_init(event_emit_fn emit)
+{
+	std::lock_guard<std::mutex> lk(g_stream_mx);
+	g_emit = emit;
+	if (!g_stream_thread.joinable()) {
+		g_stream_stop = false;
+		g_stream_thread = std::thread(stream_thread_main);
+	}
+}
+
+void event_stream_shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lk(g_stream_mx);
+		g_stream_stop = true;
+	}
+	g_stream_cv.notify_one();
+	if (g_stream_thread.joinable())
+		g_stream_thread.join();
+
+	std::lock_guard<std::mutex> lk(g_stream_mx);
+	g_outgoing.clear();
+	g_has_pending = false;
+	g_pending = core_event();
+	g_emit = nullptr;
+}
+
+void event_stream_dispatch(const core_event &ev)
+{
+	const state_ref snap = snapshot();
+	const auto now = stream_clock::now();
+
+	{
+		std::lock_guard<std::mutex> lk(g_stream_mx);
+		core_event out;
+		if (!filter_event(g_opts, ev, *snap, out))
+			return;
+
+		if (ev.type != event_type::VisibilityChanged) {
+			flush_pending(now); // keep order: the delta it follows goes first
+			g_outgoing.push_back(outgoing_event{std::move(out), g_opts.compact});
+		} else if (g_has_pending) {
+			merge_visibility_delta(g_pending, out);
+			return; // goes out on the trailing edge
+		} else if (g_interval.count() > 0 && now < g_next_allowed) {
+			g_pending = std::move(out);
+			g_has_pending = true;
+		} else {
+			g_outgoing.push_back(outgoing_event{std::move(out), g_opts.compact});
+			g_next_allowed = now + g_interval;
+		}
+	}
+	g_stream_cv.notify_one();
+}
+
+void set_event_options(const event_options &opts)
+{
+	{
+		std::lock_guard<std::mutex> lk(g_stream_mx);
+		const auto now = stream_clock::now();
+		g_opts = opts;
+		g_interval = interval_for(opts.max_rate);
+		if (g_interval.count() == 0 || g_next_allowed > now + g_interval)
+			g_next_allowed = now;
+	}
+	g_stream_cv.notify_one();
+}
+
+event_options current_event_options()
+{
+	std::lock_guard<std::mutex> lk(g_stream_mx);
+	return g_opts;
+}
+
+} // namespace smart_lt::ws
@@ -0,0 +1,277 @@
+// scheduler_test.cpp
+// Drives smart_lt::sched from a virtual clock against a minimal in-memory core.
+#include "scheduler.hpp"
+
+#include "core.hpp"
+
+#include <QCoreApplication>
+
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+
+// -------------------------
+// Fake core
+// -------------------------
+// Only what scheduler.cpp uses. Events are queued like delivery_context::QtMain and handed over by
+// deliver(), so the scheduler sees them after the command that caused them returned.
+namespace smart_lt {
+
+static std::vector<lower_third_cfg> g_items;
+static std::vector<group_cfg> g_groups;
+static std::vector<std::string> g_visible;
+static core_event_cb g_listener = nullptr;
+static std::deque<core_event> g_events;
+
+const std::vector<lower_third_cfg> &all_const()
+{
+	return g_items;
+}
+
+const lower_third_cfg *get_by_id_const(const std::string &id)
+{
+	for (const auto &c : g_items)
+		if (c.id == id)
+			return &c;
+	return nullptr;
+}
+
+const group_cfg *get_group_by_id_const(const std::string &id)
+{
+	for (const auto &g : g_groups)
+		if (g.id == id)
+			return &g;
+	return nullptr;
+}
+
+std::vector<std::string> groups_containing(const std::string &lower_third_id)
+{
+	std::vector<std::string> out;
+	for (const auto &g : g_groups)
+		if (std::find(g.members.begin(), g.members.end(), lower_third_id) != g.members.end())
+			out.push_back(g.id);
+	return out;
+}
+
+std::vector<std::string> visible_ids()
+{
+	return g_visible;
+}
+
+bool is_visible(const std::string &id)
+{
+	return std::find(g_visible.begin(), g_visible.end(), id) != g_visible.end();
+}
+
+bool set_visible_persist(const std::string &id, bool visible)
+{
+	if (is_visible(id) == visible)
+		return true;
+	if (visible)
+		g_visible.push_back(id);
+	else
+		g_visible.erase(std::find(g_visible.begin(), g_visible.end(), id));
+
+	core_event ev;
+	ev.type = event_type::VisibilityChanged;
+	ev.id = id;
+	ev.visible = visible;
+	ev.visible_ids = std::make_shared<const std::vector<std::string>>(g_visible);
+	g_events.push_back(std::move(ev));
+	return true;
+}
+
+uint64_t add_event_listener(core_event_cb cb, void *user, const listener_options &opts)
+{
+	UNUSED_PARAMETER(user);
+	UNUSED_PARAMETER(opts);
+	g_listener = cb;
+	return 1;
+}
+
+void remove_event_listener(uint64_t token)
+{
+	UNUSED_PARAMETER(token);
+	g_listener = nullptr;
+}
+
+} // namespace smart_lt
+
+// -------------------------
+// Harness
+// -------------------------
+namespace sched = smart_lt::sched;
+
+static int64_t g_now = 0;
+static int g_failures = 0;
+
+static int64_t virtual_now()
+{
+	return g_now;
+}
+
+static void deliver()
+{
+	while (!smart_lt::g_events.empty()) {
+		const smart_lt::core_event ev = std::move(smart_lt::g_events.front());
+		smart_lt::g_events.pop_front();
+		if (smart_lt::g_listener)
+			smart_lt::g_listener(ev, nullptr);
+	}
+}
+
+// Moves the clock to `t` in 100 ms ticks (every time used below is a multiple), firing what is due.
+static void advance_to(int64_t t)
+{
+	deliver();
+	while (g_now < t) {
+		g_now = std::min(t, g_now + 100);
+		sched::run_due();
+		deliver();
+	}
+}
+
+static void edit_item(const smart_lt::lower_third_cfg &c)
+{
+	for (auto &it : smart_lt::g_items)
+		if (it.id == c.id)
+			it = c;
+	smart_lt::core_event ev;
+	ev.type = smart_lt::event_type::ListChanged;
+	ev.reason = smart_lt::list_change_reason::Update;
+	ev.id2 = c.id;
+	smart_lt::g_events.push_back(ev);
+	deliver();
+}
+
+static void reset(const std::vector<smart_lt::lower_third_cfg> &items)
+{
+	sched::shutdown();
+	smart_lt::g_items = items;
+	smart_lt::g_groups.clear();
+	smart_lt::g_visible.clear();
+	smart_lt::g_events.clear();
+	g_now = 0;
+	sched::set_clock(virtual_now);
+	sched::init();
+}
+
+static smart_lt::lower_third_cfg item(const char *id, int every, int visible)
+{
+	smart_lt::lower_third_cfg c;
+	c.id = id;
+	c.repeat_every_sec = every;
+	c.repeat_visible_sec = visible;
+	return c;
+}
+
+#define CHECK(cond)                                                                             \
+	do {                                                                                    \
+		if (!(cond)) {                                                                  \
+			std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+			g_failures++;                                                           \
+		}                                                                               \
+	} while (0)
+
+// -------------------------
+// Cases
+// -------------------------
+static void repeat_shows_and_hides_on_cadence()
+{
+	reset({item("a", 10, 3)});
+
+	advance_to(9900);
+	CHECK(!smart_lt::is_visible("a"));
+	advance_to(10000);
+	CHECK(smart_lt::is_visible("a"));
+	advance_to(12900);
+	CHECK(smart_lt::is_visible("a"));
+	advance_to(13000);
+	CHECK(!smart_lt::is_visible("a"));
+	CHECK(sched::countdown_for("a").next_in_ms == 7000);
+	advance_to(20000);
+	CHECK(smart_lt::is_visible("a"));
+}
+
+static void manual_show_in_repeat_mode_is_not_auto_hidden()
+{
+	reset({item("a", 10, 3)});
+
+	advance_to(1000);
+	smart_lt::set_visible_persist("a", true);
+	deliver();
+	CHECK(sched::countdown_for("a").hide_in_ms == -1);
+	advance_to(9000);
+	CHECK(smart_lt::is_visible("a"));
+}
+
+static void manual_show_with_visible_time_auto_hides()
+{
+	reset({item("a", 0, 4)});
+
+	advance_to(500);
+	smart_lt::set_visible_persist("a", true);
+	deliver();
+	CHECK(sched::countdown_for("a").hide_in_ms == 4000);
+	advance_to(4400);
+	CHECK(smart_lt::is_visible("a"));
+	advance_to(4500);
+	CHECK(!smart_lt::is_visible("a"));
+}
+
+static void new_period_reschedules_the_next_show()
+{
+	reset({item("a", 60, 3)});
+
+	advance_to(1000);
+	CHECK(sched::countdown_for("a").next_in_ms == 59000);
+	edit_item(item("a", 5, 3));
+	CHECK(sched::countdown_for("a").next_in_ms == 5000);
+	advance_to(6000);
+	CHECK(smart_lt::is_visible("a"));
+
+	// Unrelated edits keep the cadence.
+	advance_to(8000);
+	edit_item(item("a", 5, 2));
+	CHECK(sched::countdown_for("a").next_in_ms == 3000);
+}
+
+static void group_run_steps_through_members()
+{
+	reset({item("a", 0, 0), item("b", 0, 0)});
+	smart_lt::group_cfg g;
+	g.id = "g";
+	g.members = {"a", "b"};
+	g.loop = false;
+	g.visible_ms = 2000;
+	g.interval_ms = 1000;
+	smart_lt::g_groups.push_back(g);
+
+	sched::start_group_run("g");
+	deliver();
+	CHECK(smart_lt::is_visible("a"));
+	CHECK(sched::countdown_for("a").group_owned);
+	advance_to(2000);
+	CHECK(!smart_lt::is_visible("a"));
+	advance_to(3000);
+	CHECK(smart_lt::is_visible("b"));
+	advance_to(5000);
+	CHECK(!smart_lt::is_visible("b"));
+	CHECK(!sched::group_running("g"));
+}
+
+int main(int argc, char **argv)
+{
+	QCoreApplication app(argc, argv);
+
+	repeat_shows_and_hides_on_cadence();
+	manual_show_in_repeat_mode_is_not_auto_hidden();
+	manual_show_with_visible_time_auto_hides();
+	new_period_reschedules_the_next_show();
+	group_run_steps_through_members();
+
+	sched::shutdown();
+	if (g_failures)
+		std::fprintf(stderr, "%d check(s) failed\n", g_failures);
+	return g_failures ? 1 : 0;
+}